@@ -73,6 +73,7 @@ static int add_lp_row(struct tab_lp *lp, isl_int *row, int dim);
 static void get_alpha(struct tab_lp* lp, int row, GBR_type *alpha);
 static int del_lp_row(struct tab_lp *lp) WARN_UNUSED;
 static int cut_lp_to_hyperplane(struct tab_lp *lp, isl_int *row);
+static int precondition_basis(struct isl_tab *tab);
 
 #define GBR_LP			    	    struct tab_lp
 #define GBR_lp_init(P)		    	    init_lp(P)
@@ -86,6 +87,7 @@ static int cut_lp_to_hyperplane(struct tab_lp *lp, isl_int *row);
 #define GBR_lp_del_row(lp)		    del_lp_row(lp)
 #define GBR_lp_is_fixed(lp)		    (lp)->is_fixed
 #define GBR_lp_cut(lp, obj)	    	    cut_lp_to_hyperplane(lp, obj)
+#define GBR_precondition(tab)	    	    precondition_basis(tab)
 #include "basis_reduction_templ.c"
 
 /* Set up a tableau for the Cartesian product of bset with itself.
@@ -265,3 +267,252 @@ static int del_lp_row(struct tab_lp *lp)
 	lp->neq--;
 	return isl_tab_rollback(lp->tab, lp->stack[lp->neq]);
 }
+
+/* Round "x" to the nearest integer, storing the result in "q".
+ * Return -1 if "x" is too large (in absolute value) or not a number.
+ */
+static int round_d(double x, long *q)
+{
+	if (!(x > -1e15 && x < 1e15))
+		return -1;
+	if (x >= 0)
+		*q = (long) (x + 0.5);
+	else
+		*q = -(long) (-x + 0.5);
+	return 0;
+}
+
+/* Compute the Gram-Schmidt orthogonalization of the "n" rows of length "n"
+ * in "b", storing the orthogonalized rows in "star",
+ * their squared norms in "norm" and the projection coefficients in "mu".
+ * Return 0 if the rows are numerically linearly dependent and 1 otherwise.
+ */
+static int gram_schmidt(int n, double *b, double *star, double *mu,
+	double *norm)
+{
+	int i, j, l;
+
+	for (i = 0; i < n; ++i) {
+		double len = 0;
+
+		for (l = 0; l < n; ++l) {
+			star[i * n + l] = b[i * n + l];
+			len += b[i * n + l] * b[i * n + l];
+		}
+		for (j = 0; j < i; ++j) {
+			double d = 0;
+			for (l = 0; l < n; ++l)
+				d += b[i * n + l] * star[j * n + l];
+			mu[i * n + j] = d / norm[j];
+			for (l = 0; l < n; ++l)
+				star[i * n + l] -= mu[i * n + j] * star[j * n + l];
+		}
+		norm[i] = 0;
+		for (l = 0; l < n; ++l)
+			norm[i] += star[i * n + l] * star[i * n + l];
+		if (!(norm[i] > 1e-9 * len))
+			return 0;
+	}
+
+	return 1;
+}
+
+/* Apply (floating point) LLL reduction with delta = 3/4 to the "n" rows
+ * of length "n" in "b", performing the same unimodular operations
+ * on the corresponding rows of "B", starting at row "first".
+ * The constant column of "B" is left untouched.
+ * The reduction is abandoned (leaving a valid, but possibly
+ * not fully reduced basis) if the coefficients become too large
+ * or if the rows turn out to be numerically dependent.
+ */
+static __isl_give isl_mat *lll_d(__isl_take isl_mat *B, int first,
+	int n, double *b)
+{
+	isl_ctx *ctx;
+	double *star, *mu, *norm;
+	isl_int tmp;
+	int i, j, l;
+	int swaps = 0;
+
+	if (!B)
+		return NULL;
+
+	ctx = isl_mat_get_ctx(B);
+	star = isl_alloc_array(ctx, double, n * n);
+	mu = isl_alloc_array(ctx, double, n * n);
+	norm = isl_alloc_array(ctx, double, n);
+	if (!star || !mu || !norm)
+		goto error;
+
+	isl_int_init(tmp);
+	i = 1;
+	while (i < n && swaps < 10 * n * n) {
+		if (!gram_schmidt(n, b, star, mu, norm))
+			break;
+		for (j = i - 1; j >= 0; --j) {
+			long q;
+
+			if (round_d(mu[i * n + j], &q) < 0)
+				break;
+			if (q == 0)
+				continue;
+			for (l = 0; l < n; ++l)
+				b[i * n + l] -= q * b[j * n + l];
+			for (l = 0; l < j; ++l)
+				mu[i * n + l] -= q * mu[j * n + l];
+			mu[i * n + j] -= q;
+			isl_int_set_si(tmp, -q);
+			isl_seq_combine(B->row[1 + first + i] + 1,
+				ctx->one, B->row[1 + first + i] + 1,
+				tmp, B->row[1 + first + j] + 1, B->n_col - 1);
+		}
+		if (j >= 0)
+			break;
+		if (norm[i] < (0.75 - mu[i * n + i - 1] * mu[i * n + i - 1]) *
+				norm[i - 1]) {
+			for (l = 0; l < n; ++l) {
+				double t = b[i * n + l];
+				b[i * n + l] = b[(i - 1) * n + l];
+				b[(i - 1) * n + l] = t;
+			}
+			B = isl_mat_swap_rows(B, 1 + first + i, 1 + first + i - 1);
+			if (!B)
+				break;
+			swaps++;
+			if (i > 1)
+				--i;
+		} else
+			++i;
+	}
+	isl_int_clear(tmp);
+
+	free(star);
+	free(mu);
+	free(norm);
+	return B;
+error:
+	free(star);
+	free(mu);
+	free(norm);
+	return isl_mat_free(B);
+}
+
+/* Compute the optimum of the affine function "f" over "tab" and
+ * add the coordinates of the corresponding vertex, multiplied by "sign",
+ * to "d".
+ * Return 0 if the optimum could not be computed.
+ */
+static int add_vertex(struct isl_tab *tab, isl_int *f, int sign, double *d)
+{
+	int i;
+	double den;
+	isl_vec *sample;
+	enum isl_lp_result res;
+
+	res = isl_tab_min(tab, f, tab->mat->ctx->one, NULL, NULL, 0);
+	if (res == isl_lp_error)
+		return -1;
+	if (res != isl_lp_ok)
+		return 0;
+	sample = isl_tab_get_sample_value(tab);
+	if (!sample)
+		return -1;
+	den = isl_int_get_d(sample->el[0]);
+	for (i = 0; i < tab->n_var; ++i)
+		d[i] += sign * isl_int_get_d(sample->el[1 + i]) / den;
+	isl_vec_free(sample);
+
+	return 1;
+}
+
+/* Compute a floating point approximation of a reduced basis
+ * of the bounded directions of tab->basis that do not correspond
+ * to equalities and update tab->basis accordingly.
+ *
+ * The exact width of the set in a direction c is approximated
+ * by the Euclidean norm of the vector (c^T d_i)_i,
+ * with d_i the difference between the vertices that maximize and
+ * minimize the i-th basis direction.  That is, the width
+ * is approximated by a quadratic form that is computed from
+ * only two LPs per direction on "tab" itself rather than on
+ * the product tableau used by the exact basis reduction.
+ * The corresponding lattice is then reduced using LLL in double precision,
+ * while the resulting unimodular transformation is applied exactly
+ * to tab->basis.  The result is therefore always a valid basis
+ * that the exact basis reduction can start from and that is usually
+ * already close to being reduced.
+ * If any of the approximations fails, then the basis is left
+ * (partially) unreduced.
+ *
+ * Return -1 on error and 0 otherwise.
+ */
+static int precondition_basis(struct isl_tab *tab)
+{
+	isl_ctx *ctx;
+	isl_vec *f = NULL;
+	double *d = NULL, *b = NULL;
+	int first, n, dim;
+	int i, j, l;
+	int ok = 1;
+
+	if (!tab || !tab->basis)
+		return -1;
+
+	ctx = tab->mat->ctx;
+	dim = tab->n_var;
+	first = tab->n_zero;
+	n = dim - tab->n_unbounded - first;
+	if (n < 2)
+		return 0;
+
+	tab->basis = isl_mat_cow(tab->basis);
+	if (!tab->basis)
+		return -1;
+	if (isl_tab_extend_cons(tab, 1) < 0)
+		return -1;
+
+	f = isl_vec_alloc(ctx, 1 + dim);
+	d = isl_calloc_array(ctx, double, n * dim);
+	b = isl_alloc_array(ctx, double, n * n);
+	if (!f || !d || !b)
+		goto error;
+
+	for (i = 0; ok > 0 && i < n; ++i) {
+		isl_int *row = tab->basis->row[1 + first + i];
+
+		isl_int_set_si(f->el[0], 0);
+		isl_seq_neg(f->el + 1, row + 1, dim);
+		ok = add_vertex(tab, f->el, 1, d + i * dim);
+		if (ok <= 0)
+			break;
+		isl_seq_neg(f->el + 1, f->el + 1, dim);
+		ok = add_vertex(tab, f->el, -1, d + i * dim);
+	}
+	if (ok < 0)
+		goto error;
+
+	if (ok) {
+		for (j = 0; j < n; ++j) {
+			isl_int *row = tab->basis->row[1 + first + j];
+			for (i = 0; i < n; ++i) {
+				double v = 0;
+				for (l = 0; l < dim; ++l)
+					v += isl_int_get_d(row[1 + l]) *
+						d[i * dim + l];
+				b[j * n + i] = v;
+			}
+		}
+		tab->basis = lll_d(tab->basis, first, n, b);
+	}
+
+	isl_vec_free(f);
+	free(d);
+	free(b);
+
+	return tab->basis ? 0 : -1;
+error:
+	isl_vec_free(f);
+	free(d);
+	free(b);
+	return -1;
+}
@@ -45,6 +45,10 @@ static void save_alpha(GBR_LP *lp, int first, int n, GBR_type *alpha)
  * If ctx->opt->gbr_only_first is set, the user is only interested
  * in the first direction.  In this case we stop the basis reduction when
  * the width in the first direction becomes smaller than 2.
+ *
+ * If ctx->opt->gbr_precondition is set, then the basis is first
+ * brought close to a reduced basis using a cheaper, approximate computation
+ * such that the exact reduction below typically needs fewer LPs.
  */
 struct isl_tab *isl_tab_compute_reduced_basis(struct isl_tab *tab)
 {
@@ -83,14 +87,19 @@ struct isl_tab *isl_tab_compute_reduced_basis(struct isl_tab *tab)
 	ctx = tab->mat->ctx;
 	gbr_only_first = ctx->opt->gbr_only_first;
 	dim = tab->n_var;
-	B = tab->basis;
-	if (!B)
+	if (!tab->basis)
 		return tab;
 
 	n_bounded = dim - tab->n_unbounded;
 	if (n_bounded <= tab->n_zero + 1)
 		return tab;
 
+	if (ctx->opt->gbr_precondition && GBR_precondition(tab) < 0) {
+		tab->basis = isl_mat_free(tab->basis);
+		return tab;
+	}
+	B = tab->basis;
+
 	isl_int_init(tmp);
 	isl_int_init(mu[0]);
 	isl_int_init(mu[1]);
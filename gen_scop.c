@@ -0,0 +1,544 @@
+/*
+ * Use of this software is governed by the MIT license
+ */
+
+/* This program generates a synthetic static control part (SCoP)
+ * for stress testing the scheduler, dependence analysis and
+ * AST generation on inputs of a given size.
+ *
+ * Each statement S<k> has a loop nest of a randomly chosen depth,
+ * with bounds that depend on the parameters, writes to its own array A<k>
+ * using the identity access function and reads from arrays written by
+ * earlier statements and possibly from its own array at an earlier
+ * iteration.  Since every array element is written at most once,
+ * the flow dependences can be computed directly from the accesses.
+ * The statements are executed in textual order.
+ *
+ * All random choices are determined by the seed, using a fixed
+ * pseudo-random number generator such that the same seed produces
+ * the same output on all platforms.  To this end, each random choice
+ * is made in a separate statement rather than in an argument
+ * of a function call that also makes other random choices.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <isl/options.h>
+#include <isl/printer.h>
+#include <isl/set.h>
+#include <isl/union_set.h>
+#include <isl/union_map.h>
+
+#define FORMAT_YAML	0
+#define FORMAT_ISL	1
+#define FORMAT_CODEGEN	2
+
+struct isl_arg_choice gen_format[] = {
+	{"yaml",	FORMAT_YAML},
+	{"isl",		FORMAT_ISL},
+	{"codegen",	FORMAT_CODEGEN},
+	{0}
+};
+
+struct options {
+	struct isl_options	*isl;
+	int			 statements;
+	int			 depth;
+	int			 parameters;
+	int			 density;
+	int			 max_coefficient;
+	unsigned long		 seed;
+	unsigned		 format;
+};
+
+ISL_ARGS_START(struct options, options_args)
+ISL_ARG_CHILD(struct options, isl, "isl", &isl_options_args, "isl options")
+ISL_ARG_INT(struct options, statements, 0, "statements", "n", 4,
+	"number of statements")
+ISL_ARG_INT(struct options, depth, 0, "depth", "n", 3,
+	"maximal loop depth of a statement")
+ISL_ARG_INT(struct options, parameters, 0, "parameters", "n", 2,
+	"number of parameters")
+ISL_ARG_INT(struct options, density, 0, "density", "percentage", 30,
+	"probability that a statement reads from a given earlier statement "
+	"or from itself")
+ISL_ARG_INT(struct options, max_coefficient, 0, "max-coefficient", "n", 2,
+	"maximal absolute value of coefficients and offsets")
+ISL_ARG_ULONG(struct options, seed, 0, "seed", 1,
+	"seed of the pseudo-random number generator")
+ISL_ARG_CHOICE(struct options, format, 0, "format", gen_format,
+	FORMAT_YAML, "output format")
+ISL_ARGS_END
+
+ISL_ARG_DEF(options, struct options, options_args)
+
+/* Internal data structure for generating a SCoP.
+ *
+ * "state" is the state of the pseudo-random number generator.
+ * "depth" contains the loop depth of each statement.
+ */
+struct gen_data {
+	struct options *options;
+	unsigned long state;
+	int *depth;
+	int max_depth;
+};
+
+/* Return a pseudo-random number in [lo, hi].
+ *
+ * A simple linear congruential generator is used such that
+ * the sequence only depends on the seed.
+ */
+static int random_int(struct gen_data *data, int lo, int hi)
+{
+	data->state = (data->state * 1103515245UL + 12345UL) & 0xffffffffUL;
+	return lo + (int) ((data->state >> 16) % (hi - lo + 1));
+}
+
+/* Return 1 with probability "percentage" / 100.
+ */
+static int random_bool(struct gen_data *data, int percentage)
+{
+	return random_int(data, 0, 99) < percentage;
+}
+
+/* Print the parameters of the SCoP followed by an arrow.
+ */
+static __isl_give isl_printer *print_params(__isl_take isl_printer *p,
+	struct gen_data *data)
+{
+	int i;
+
+	p = isl_printer_print_str(p, "[");
+	for (i = 0; i < data->options->parameters; ++i) {
+		if (i)
+			p = isl_printer_print_str(p, ", ");
+		p = isl_printer_print_str(p, "N");
+		p = isl_printer_print_int(p, i);
+	}
+	return isl_printer_print_str(p, "] -> ");
+}
+
+/* Print the name "prefix"<k> followed by the "n" variables i0, ...
+ */
+static __isl_give isl_printer *print_tuple(__isl_take isl_printer *p,
+	const char *prefix, int k, int n)
+{
+	int i;
+
+	p = isl_printer_print_str(p, prefix);
+	p = isl_printer_print_int(p, k);
+	p = isl_printer_print_str(p, "[");
+	for (i = 0; i < n; ++i) {
+		if (i)
+			p = isl_printer_print_str(p, ", ");
+		p = isl_printer_print_str(p, "i");
+		p = isl_printer_print_int(p, i);
+	}
+	return isl_printer_print_str(p, "]");
+}
+
+/* Print the term "c" * "var"<pos>, with "c" positive.
+ */
+static __isl_give isl_printer *print_term(__isl_take isl_printer *p,
+	int c, const char *var, int pos)
+{
+	if (c != 1) {
+		p = isl_printer_print_int(p, c);
+		p = isl_printer_print_str(p, "*");
+	}
+	p = isl_printer_print_str(p, var);
+	return isl_printer_print_int(p, pos);
+}
+
+/* Print the constant "c" as a term of an affine expression.
+ */
+static __isl_give isl_printer *print_constant(__isl_take isl_printer *p,
+	int c)
+{
+	if (c == 0)
+		return p;
+	p = isl_printer_print_str(p, c < 0 ? " - " : " + ");
+	return isl_printer_print_int(p, c < 0 ? -c : c);
+}
+
+/* Parse the string printed to "p" as a union map and free "p".
+ */
+static __isl_give isl_union_map *read_union_map(__isl_take isl_printer *p)
+{
+	char *str;
+	isl_ctx *ctx;
+	isl_union_map *umap;
+
+	ctx = isl_printer_get_ctx(p);
+	str = isl_printer_get_str(p);
+	isl_printer_free(p);
+	umap = isl_union_map_read_from_str(ctx, str);
+	free(str);
+	return umap;
+}
+
+/* Parse the string printed to "p" as a union set and free "p".
+ */
+static __isl_give isl_union_set *read_union_set(__isl_take isl_printer *p)
+{
+	char *str;
+	isl_ctx *ctx;
+	isl_union_set *uset;
+
+	ctx = isl_printer_get_ctx(p);
+	str = isl_printer_get_str(p);
+	isl_printer_free(p);
+	uset = isl_union_set_read_from_str(ctx, str);
+	free(str);
+	return uset;
+}
+
+/* Construct the iteration domain of statement "k".
+ *
+ * Each loop iterator has a lower bound of zero or an affine function
+ * of the outer iterator and an upper bound that depends on
+ * one of the parameters (or a constant if there are no parameters).
+ */
+static __isl_give isl_union_set *statement_domain(isl_ctx *ctx,
+	struct gen_data *data, int k)
+{
+	int i;
+	int c = data->options->max_coefficient;
+	isl_printer *p;
+
+	p = isl_printer_to_str(ctx);
+	p = print_params(p, data);
+	p = isl_printer_print_str(p, "{ ");
+	p = print_tuple(p, "S", k, data->depth[k]);
+	p = isl_printer_print_str(p, " : ");
+	for (i = 0; i < data->depth[k]; ++i) {
+		if (i)
+			p = isl_printer_print_str(p, " and ");
+		p = print_term(p, 1, "i", i);
+		p = isl_printer_print_str(p, " >= ");
+		if (i > 0 && random_bool(data, 50)) {
+			p = print_term(p, random_int(data, 1, c), "i", i - 1);
+			p = print_constant(p, random_int(data, -c, c));
+		} else
+			p = isl_printer_print_str(p, "0");
+		p = isl_printer_print_str(p, " and ");
+		p = print_term(p, 1, "i", i);
+		p = isl_printer_print_str(p, " <= ");
+		if (data->options->parameters > 0) {
+			int n = data->options->parameters;
+			int coef, param;
+
+			coef = random_int(data, 1, c);
+			param = random_int(data, 0, n - 1);
+			p = print_term(p, coef, "N", param);
+			p = print_constant(p, random_int(data, -c, c));
+		} else
+			p = isl_printer_print_int(p, 10 * c);
+	}
+	p = isl_printer_print_str(p, " }");
+
+	return read_union_set(p);
+}
+
+/* Construct the write access relation of statement "k",
+ * which writes to element i of array A<k> in iteration i.
+ */
+static __isl_give isl_union_map *statement_write(isl_ctx *ctx,
+	struct gen_data *data, int k)
+{
+	isl_printer *p;
+
+	p = isl_printer_to_str(ctx);
+	p = print_params(p, data);
+	p = isl_printer_print_str(p, "{ ");
+	p = print_tuple(p, "S", k, data->depth[k]);
+	p = isl_printer_print_str(p, " -> ");
+	p = print_tuple(p, "A", k, data->depth[k]);
+	p = isl_printer_print_str(p, " }");
+
+	return read_union_map(p);
+}
+
+/* Construct a read access from statement "k" to array A<l>,
+ * which was written by statement "l".
+ * If "l" is equal to "k", then the last index is shifted
+ * such that the element was written in an earlier iteration.
+ * Otherwise, each index is an affine function of a randomly
+ * chosen iterator of statement "k".
+ */
+static __isl_give isl_union_map *statement_read(isl_ctx *ctx,
+	struct gen_data *data, int k, int l)
+{
+	int i, coef, pos;
+	int c = data->options->max_coefficient;
+	isl_printer *p;
+
+	p = isl_printer_to_str(ctx);
+	p = print_params(p, data);
+	p = isl_printer_print_str(p, "{ ");
+	p = print_tuple(p, "S", k, data->depth[k]);
+	p = isl_printer_print_str(p, " -> A");
+	p = isl_printer_print_int(p, l);
+	p = isl_printer_print_str(p, "[");
+	for (i = 0; i < data->depth[l]; ++i) {
+		if (i)
+			p = isl_printer_print_str(p, ", ");
+		if (l == k) {
+			p = print_term(p, 1, "i", i);
+			if (i == data->depth[k] - 1)
+				p = print_constant(p, -random_int(data, 1, c));
+			continue;
+		}
+		coef = random_bool(data, 50) ? 1 : random_int(data, 1, c);
+		pos = random_int(data, 0, data->depth[k] - 1);
+		p = print_term(p, coef, "i", pos);
+		p = print_constant(p, random_int(data, -c, c));
+	}
+	p = isl_printer_print_str(p, "] }");
+
+	return read_union_map(p);
+}
+
+/* Construct the schedule of statement "k", which executes
+ * statement "k" after all earlier statements and then
+ * its loop iterations in lexicographic order.
+ * The schedule has "max_depth" + 1 output dimensions.
+ */
+static __isl_give isl_union_map *statement_schedule(isl_ctx *ctx,
+	struct gen_data *data, int k)
+{
+	int i;
+	isl_printer *p;
+
+	p = isl_printer_to_str(ctx);
+	p = print_params(p, data);
+	p = isl_printer_print_str(p, "{ ");
+	p = print_tuple(p, "S", k, data->depth[k]);
+	p = isl_printer_print_str(p, " -> [");
+	p = isl_printer_print_int(p, k);
+	for (i = 0; i < data->max_depth; ++i) {
+		p = isl_printer_print_str(p, ", ");
+		if (i < data->depth[k])
+			p = print_term(p, 1, "i", i);
+		else
+			p = isl_printer_print_str(p, "0");
+	}
+	p = isl_printer_print_str(p, "] }");
+
+	return read_union_map(p);
+}
+
+/* Construct the context, requiring all parameters to be positive.
+ */
+static __isl_give isl_set *context(isl_ctx *ctx, struct gen_data *data)
+{
+	int i;
+	char *str;
+	isl_printer *p;
+	isl_set *set;
+
+	p = isl_printer_to_str(ctx);
+	p = print_params(p, data);
+	p = isl_printer_print_str(p, "{ : ");
+	for (i = 0; i < data->options->parameters; ++i) {
+		if (i)
+			p = isl_printer_print_str(p, " and ");
+		p = print_term(p, 1, "N", i);
+		p = isl_printer_print_str(p, " >= 1");
+	}
+	p = isl_printer_print_str(p, " }");
+	str = isl_printer_get_str(p);
+	isl_printer_free(p);
+	set = isl_set_read_from_str(ctx, str);
+	free(str);
+
+	return set;
+}
+
+/* Print "key" followed by the start of a quoted YAML value.
+ */
+static __isl_give isl_printer *start_entry(__isl_take isl_printer *p,
+	const char *key)
+{
+	p = isl_printer_print_str(p, key);
+	p = isl_printer_yaml_next(p);
+	return isl_printer_print_str(p, "\"");
+}
+
+/* Print the end of a quoted YAML value.
+ */
+static __isl_give isl_printer *end_entry(__isl_take isl_printer *p)
+{
+	p = isl_printer_print_str(p, "\"");
+	return isl_printer_yaml_next(p);
+}
+
+/* Print a comment line "# "<key>, used in the isl format.
+ */
+static __isl_give isl_printer *print_comment(__isl_take isl_printer *p,
+	const char *key)
+{
+	p = isl_printer_print_str(p, "# ");
+	p = isl_printer_print_str(p, key);
+	return isl_printer_end_line(p);
+}
+
+/* Print the SCoP in the format selected by the options.
+ *
+ * In the YAML format, the SCoP is printed as a mapping.
+ * In the isl format, each component is printed on its own line,
+ * preceded by a comment with its name.
+ * In the codegen format, the schedule, context and an empty options
+ * relation are printed such that the output can be passed
+ * to isl_codegen.
+ */
+static __isl_give isl_printer *print_scop(__isl_take isl_printer *p,
+	struct gen_data *data, __isl_keep isl_union_set *domain,
+	__isl_keep isl_set *context, __isl_keep isl_union_map *schedule,
+	__isl_keep isl_union_map *reads, __isl_keep isl_union_map *writes,
+	__isl_keep isl_union_map *dep)
+{
+	switch (data->options->format) {
+	case FORMAT_YAML:
+		p = isl_printer_yaml_start_mapping(p);
+		p = start_entry(p, "domain");
+		p = isl_printer_print_union_set(p, domain);
+		p = end_entry(p);
+		p = start_entry(p, "context");
+		p = isl_printer_print_set(p, context);
+		p = end_entry(p);
+		p = start_entry(p, "schedule");
+		p = isl_printer_print_union_map(p, schedule);
+		p = end_entry(p);
+		p = start_entry(p, "reads");
+		p = isl_printer_print_union_map(p, reads);
+		p = end_entry(p);
+		p = start_entry(p, "writes");
+		p = isl_printer_print_union_map(p, writes);
+		p = end_entry(p);
+		p = start_entry(p, "validity");
+		p = isl_printer_print_union_map(p, dep);
+		p = end_entry(p);
+		p = start_entry(p, "proximity");
+		p = isl_printer_print_union_map(p, dep);
+		p = end_entry(p);
+		p = isl_printer_yaml_end_mapping(p);
+		return isl_printer_end_line(p);
+	case FORMAT_ISL:
+		p = print_comment(p, "domain");
+		p = isl_printer_print_union_set(p, domain);
+		p = isl_printer_end_line(p);
+		p = print_comment(p, "context");
+		p = isl_printer_print_set(p, context);
+		p = isl_printer_end_line(p);
+		p = print_comment(p, "schedule");
+		p = isl_printer_print_union_map(p, schedule);
+		p = isl_printer_end_line(p);
+		p = print_comment(p, "reads");
+		p = isl_printer_print_union_map(p, reads);
+		p = isl_printer_end_line(p);
+		p = print_comment(p, "writes");
+		p = isl_printer_print_union_map(p, writes);
+		p = isl_printer_end_line(p);
+		p = print_comment(p, "dependences");
+		p = isl_printer_print_union_map(p, dep);
+		return isl_printer_end_line(p);
+	case FORMAT_CODEGEN:
+		p = isl_printer_print_union_map(p, schedule);
+		p = isl_printer_end_line(p);
+		p = isl_printer_print_set(p, context);
+		p = isl_printer_end_line(p);
+		p = isl_printer_print_str(p, "{ }");
+		return isl_printer_end_line(p);
+	}
+
+	return p;
+}
+
+int main(int argc, char **argv)
+{
+	int k, l;
+	isl_ctx *ctx;
+	struct options *options;
+	struct gen_data data;
+	isl_union_set *domain;
+	isl_union_map *schedule, *reads, *writes, *dep;
+	isl_set *ctx_set;
+	isl_space *space;
+	isl_printer *p;
+
+	options = options_new_with_defaults();
+	assert(options);
+	argc = options_parse(options, argc, argv, ISL_ARG_ALL);
+
+	ctx = isl_ctx_alloc_with_options(&options_args, options);
+
+	if (options->statements < 1 || options->depth < 1 ||
+	    options->parameters < 0 || options->max_coefficient < 1) {
+		fprintf(stderr, "invalid options\n");
+		isl_ctx_free(ctx);
+		return 1;
+	}
+
+	data.options = options;
+	data.state = options->seed & 0xffffffffUL;
+	data.max_depth = options->depth;
+	data.depth = isl_alloc_array(ctx, int, options->statements);
+	assert(data.depth);
+	for (k = 0; k < options->statements; ++k)
+		data.depth[k] = random_int(&data, 1, options->depth);
+
+	ctx_set = context(ctx, &data);
+	space = isl_set_get_space(ctx_set);
+	domain = isl_union_set_empty(isl_space_copy(space));
+	schedule = isl_union_map_empty(isl_space_copy(space));
+	reads = isl_union_map_empty(isl_space_copy(space));
+	writes = isl_union_map_empty(space);
+	for (k = 0; k < options->statements; ++k) {
+		isl_union_set *dom_k;
+		isl_union_map *reads_k;
+
+		dom_k = statement_domain(ctx, &data, k);
+		reads_k = isl_union_map_empty(isl_union_set_get_space(dom_k));
+		for (l = 0; l <= k; ++l)
+			if (random_bool(&data, options->density))
+				reads_k = isl_union_map_union(reads_k,
+					    statement_read(ctx, &data, k, l));
+		reads_k = isl_union_map_intersect_domain(reads_k,
+						isl_union_set_copy(dom_k));
+		reads = isl_union_map_union(reads, reads_k);
+		writes = isl_union_map_union(writes,
+			    isl_union_map_intersect_domain(
+				statement_write(ctx, &data, k),
+				isl_union_set_copy(dom_k)));
+		schedule = isl_union_map_union(schedule,
+			    isl_union_map_intersect_domain(
+				statement_schedule(ctx, &data, k),
+				isl_union_set_copy(dom_k)));
+		domain = isl_union_set_union(domain, dom_k);
+	}
+	free(data.depth);
+
+	dep = isl_union_map_apply_range(isl_union_map_copy(reads),
+			    isl_union_map_reverse(isl_union_map_copy(writes)));
+	dep = isl_union_map_reverse(dep);
+	dep = isl_union_map_gist_params(dep, isl_set_copy(ctx_set));
+	dep = isl_union_map_coalesce(dep);
+
+	p = isl_printer_to_file(ctx, stdout);
+	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_BLOCK);
+	p = print_scop(p, &data, domain, ctx_set, schedule, reads, writes, dep);
+	isl_printer_free(p);
+
+	isl_union_set_free(domain);
+	isl_set_free(ctx_set);
+	isl_union_map_free(schedule);
+	isl_union_map_free(reads);
+	isl_union_map_free(writes);
+	isl_union_map_free(dep);
+	isl_ctx_free(ctx);
+
+	return 0;
+}
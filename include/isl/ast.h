@@ -19,6 +19,9 @@ const char *isl_options_get_ast_iterator_type(isl_ctx *ctx);
 int isl_options_set_ast_always_print_block(isl_ctx *ctx, int val);
 int isl_options_get_ast_always_print_block(isl_ctx *ctx);
 
+int isl_options_set_ast_print_openmp(isl_ctx *ctx, int val);
+int isl_options_get_ast_print_openmp(isl_ctx *ctx);
+
 __isl_give isl_ast_expr *isl_ast_expr_from_val(__isl_take isl_val *v);
 __isl_give isl_ast_expr *isl_ast_expr_from_id(__isl_take isl_id *id);
 __isl_give isl_ast_expr *isl_ast_expr_neg(__isl_take isl_ast_expr *expr);
@@ -96,6 +99,8 @@ __isl_give isl_ast_expr *isl_ast_node_for_get_inc(
 __isl_give isl_ast_node *isl_ast_node_for_get_body(
 	__isl_keep isl_ast_node *node);
 int isl_ast_node_for_is_degenerate(__isl_keep isl_ast_node *node);
+int isl_ast_node_for_is_parallel(__isl_keep isl_ast_node *node);
+int isl_ast_node_for_is_vectorizable(__isl_keep isl_ast_node *node);
 
 __isl_give isl_ast_expr *isl_ast_node_if_get_cond(
 	__isl_keep isl_ast_node *node);
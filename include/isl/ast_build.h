@@ -59,6 +59,9 @@ __isl_null isl_ast_build *isl_ast_build_free(
 __isl_give isl_ast_build *isl_ast_build_set_options(
 	__isl_take isl_ast_build *build,
 	__isl_take isl_union_map *options);
+__isl_give isl_ast_build *isl_ast_build_set_dependences(
+	__isl_take isl_ast_build *build,
+	__isl_take isl_union_map *dependences);
 __isl_give isl_ast_build *isl_ast_build_set_iterators(
 	__isl_take isl_ast_build *build,
 	__isl_take isl_id_list *iterators);
@@ -92,6 +95,9 @@ __isl_give isl_ast_expr *isl_ast_build_call_from_multi_pw_aff(
 
 __isl_give isl_ast_node *isl_ast_build_ast_from_schedule(
 	__isl_keep isl_ast_build *build, __isl_take isl_union_map *schedule);
+__isl_give isl_ast_node *isl_ast_build_ast_from_schedule_specialized(
+	__isl_keep isl_ast_build *build, __isl_take isl_union_map *schedule,
+	__isl_take isl_set_list *contexts);
 
 #if defined(__cplusplus)
 }
@@ -68,6 +68,9 @@ extern "C" {
  */
 struct isl_stats {
 	long	gbr_solved_lps;
+	long	tab_pivots;
+	long	tab_allocs;
+	long	lp_solves;
 };
 enum isl_error {
 	isl_error_none = 0,
@@ -150,14 +153,36 @@ int isl_ctx_parse_options(isl_ctx *ctx, int argc, char **argv, unsigned flags);
 void isl_ctx_ref(struct isl_ctx *ctx);
 void isl_ctx_deref(struct isl_ctx *ctx);
 void isl_ctx_free(isl_ctx *ctx);
+int isl_ctx_reset(isl_ctx *ctx);
 
 void isl_ctx_abort(isl_ctx *ctx);
 void isl_ctx_resume(isl_ctx *ctx);
 int isl_ctx_aborted(isl_ctx *ctx);
 
+struct isl_cancel_token;
+typedef struct isl_cancel_token isl_cancel_token;
+
+isl_cancel_token *isl_cancel_token_alloc(void);
+void isl_cancel_token_free(isl_cancel_token *token);
+void isl_cancel_token_cancel(isl_cancel_token *token);
+void isl_cancel_token_reset(isl_cancel_token *token);
+int isl_cancel_token_is_cancelled(isl_cancel_token *token);
+void isl_ctx_set_cancel_token(isl_ctx *ctx, isl_cancel_token *token);
+isl_cancel_token *isl_ctx_get_cancel_token(isl_ctx *ctx);
+
+void isl_ctx_set_progress_callback(isl_ctx *ctx, unsigned long period,
+	int (*progress)(isl_ctx *ctx, unsigned long operations, void *user),
+	void *user);
+
 void isl_ctx_set_max_operations(isl_ctx *ctx, unsigned long max_operations);
 unsigned long isl_ctx_get_max_operations(isl_ctx *ctx);
 void isl_ctx_reset_operations(isl_ctx *ctx);
+unsigned long isl_ctx_get_operations(isl_ctx *ctx);
+
+size_t isl_ctx_get_compacted_bytes(isl_ctx *ctx);
+
+const struct isl_stats *isl_ctx_get_stats(isl_ctx *ctx);
+void isl_ctx_reset_stats(isl_ctx *ctx);
 
 #define ISL_ARG_CTX_DECL(prefix,st,args)				\
 st *isl_ctx_peek_ ## prefix(isl_ctx *ctx);
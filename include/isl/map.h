@@ -123,6 +123,7 @@ struct isl_basic_map *isl_basic_map_identity_like(struct isl_basic_map *model);
 struct isl_basic_map *isl_basic_map_finalize(struct isl_basic_map *bmap);
 __isl_null isl_basic_map *isl_basic_map_free(__isl_take isl_basic_map *bmap);
 __isl_give isl_basic_map *isl_basic_map_copy(__isl_keep isl_basic_map *bmap);
+__isl_give isl_basic_map *isl_basic_map_compact(__isl_take isl_basic_map *bmap);
 struct isl_basic_map *isl_basic_map_extend(struct isl_basic_map *base,
 		unsigned nparam, unsigned n_in, unsigned n_out, unsigned extra,
 		unsigned n_eq, unsigned n_ineq);
@@ -327,9 +328,18 @@ __isl_give isl_map *isl_map_lex_gt_first(__isl_take isl_space *dim, unsigned n);
 __isl_give isl_map *isl_map_lex_ge_first(__isl_take isl_space *dim, unsigned n);
 __isl_give isl_map *isl_map_lex_gt(__isl_take isl_space *set_dim);
 __isl_give isl_map *isl_map_lex_ge(__isl_take isl_space *set_dim);
+__isl_give isl_map *isl_map_intersect_lex_lt_first(__isl_take isl_map *map,
+	unsigned n);
+__isl_give isl_map *isl_map_intersect_lex_le_first(__isl_take isl_map *map,
+	unsigned n);
+__isl_give isl_map *isl_map_intersect_lex_gt_first(__isl_take isl_map *map,
+	unsigned n);
+__isl_give isl_map *isl_map_intersect_lex_ge_first(__isl_take isl_map *map,
+	unsigned n);
 struct isl_map *isl_map_finalize(struct isl_map *map);
 __isl_null isl_map *isl_map_free(__isl_take isl_map *map);
 __isl_give isl_map *isl_map_copy(__isl_keep isl_map *map);
+__isl_give isl_map *isl_map_compact(__isl_take isl_map *map);
 struct isl_map *isl_map_extend(struct isl_map *base,
 		unsigned nparam, unsigned n_in, unsigned n_out);
 __isl_export
@@ -34,6 +34,8 @@ int isl_options_get_on_error(isl_ctx *ctx);
 
 int isl_options_set_gbr_only_first(isl_ctx *ctx, int val);
 int isl_options_get_gbr_only_first(isl_ctx *ctx);
+int isl_options_set_gbr_precondition(isl_ctx *ctx, int val);
+int isl_options_get_gbr_precondition(isl_ctx *ctx);
 
 #define		ISL_SCHEDULE_ALGORITHM_ISL		0
 #define		ISL_SCHEDULE_ALGORITHM_FEAUTRIER	1
@@ -43,6 +45,15 @@ int isl_options_get_schedule_algorithm(isl_ctx *ctx);
 int isl_options_set_coalesce_bounded_wrapping(isl_ctx *ctx, int val);
 int isl_options_get_coalesce_bounded_wrapping(isl_ctx *ctx);
 
+int isl_options_set_intern_spaces(isl_ctx *ctx, int val);
+int isl_options_get_intern_spaces(isl_ctx *ctx);
+
+int isl_options_set_cache_param_alignments(isl_ctx *ctx, int val);
+int isl_options_get_cache_param_alignments(isl_ctx *ctx);
+
+int isl_options_set_compact(isl_ctx *ctx, int val);
+int isl_options_get_compact(isl_ctx *ctx);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,64 @@
+#ifndef ISL_QUAST_H
+#define ISL_QUAST_H
+
+#include <isl/ctx.h>
+#include <isl/space.h>
+#include <isl/set.h>
+#include <isl/map.h>
+#include <isl/aff.h>
+#include <isl/val.h>
+#include <isl/point.h>
+#include <isl/ast_build.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+struct isl_quast;
+typedef struct isl_quast isl_quast;
+
+enum isl_quast_type {
+	isl_quast_type_error = -1,
+	isl_quast_type_empty,
+	isl_quast_type_leaf,
+	isl_quast_type_if
+};
+
+isl_ctx *isl_quast_get_ctx(__isl_keep isl_quast *quast);
+__isl_give isl_space *isl_quast_get_space(__isl_keep isl_quast *quast);
+__isl_give isl_basic_set *isl_quast_get_domain(__isl_keep isl_quast *quast);
+
+__isl_give isl_quast *isl_quast_copy(__isl_keep isl_quast *quast);
+__isl_null isl_quast *isl_quast_free(__isl_take isl_quast *quast);
+
+enum isl_quast_type isl_quast_get_type(__isl_keep isl_quast *quast);
+__isl_give isl_aff *isl_quast_if_get_cond(__isl_keep isl_quast *quast);
+__isl_give isl_quast *isl_quast_if_get_then(__isl_keep isl_quast *quast);
+__isl_give isl_quast *isl_quast_if_get_else(__isl_keep isl_quast *quast);
+__isl_give isl_multi_aff *isl_quast_leaf_get_multi_aff(
+	__isl_keep isl_quast *quast);
+
+int isl_quast_n_node(__isl_keep isl_quast *quast);
+
+__isl_give isl_quast *isl_basic_map_lexmin_quast(
+	__isl_take isl_basic_map *bmap);
+__isl_give isl_quast *isl_basic_map_lexmax_quast(
+	__isl_take isl_basic_map *bmap);
+__isl_give isl_quast *isl_basic_map_partial_lexmin_quast(
+	__isl_take isl_basic_map *bmap, __isl_take isl_basic_set *dom);
+__isl_give isl_quast *isl_basic_map_partial_lexmax_quast(
+	__isl_take isl_basic_map *bmap, __isl_take isl_basic_set *dom);
+
+__isl_give isl_pw_multi_aff *isl_quast_to_pw_multi_aff(
+	__isl_take isl_quast *quast);
+__isl_give isl_multi_val *isl_quast_eval(__isl_take isl_quast *quast,
+	__isl_take isl_point *pnt);
+
+__isl_give isl_ast_node *isl_ast_build_node_from_quast(
+	__isl_keep isl_ast_build *build, __isl_take isl_quast *quast);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -69,6 +69,11 @@ void isl_schedule_constraints_dump(__isl_keep isl_schedule_constraints *sc);
 
 __isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
 	__isl_take isl_schedule_constraints *sc);
+__isl_give isl_schedule *isl_schedule_constraints_compute_best_schedule(
+	__isl_take isl_schedule_constraints *sc, int n,
+	int (*set_options)(isl_ctx *ctx, int i, void *user),
+	double (*score)(__isl_keep isl_schedule *schedule, void *user),
+	unsigned long max_operations, void *user);
 
 __isl_give isl_schedule *isl_union_set_compute_schedule(
 	__isl_take isl_union_set *domain,
@@ -80,6 +85,8 @@ __isl_give isl_schedule *isl_schedule_from_domain(
 	__isl_take isl_union_set *domain);
 __isl_give isl_schedule *isl_schedule_copy(__isl_keep isl_schedule *sched);
 __isl_null isl_schedule *isl_schedule_free(__isl_take isl_schedule *sched);
+__isl_give isl_schedule *isl_schedule_compact(
+	__isl_take isl_schedule *schedule);
 __isl_give isl_union_map *isl_schedule_get_map(__isl_keep isl_schedule *sched);
 
 isl_ctx *isl_schedule_get_ctx(__isl_keep isl_schedule *sched);
@@ -99,6 +99,7 @@ struct isl_basic_set *isl_basic_set_extend_constraints(
 struct isl_basic_set *isl_basic_set_finalize(struct isl_basic_set *bset);
 __isl_null isl_basic_set *isl_basic_set_free(__isl_take isl_basic_set *bset);
 __isl_give isl_basic_set *isl_basic_set_copy(__isl_keep isl_basic_set *bset);
+__isl_give isl_basic_set *isl_basic_set_compact(__isl_take isl_basic_set *bset);
 struct isl_basic_set *isl_basic_set_dup(struct isl_basic_set *bset);
 __isl_give isl_basic_set *isl_basic_set_empty(__isl_take isl_space *dim);
 struct isl_basic_set *isl_basic_set_empty_like(struct isl_basic_set *bset);
@@ -265,6 +266,7 @@ __isl_give isl_set *isl_set_add_basic_set(__isl_take isl_set *set,
 struct isl_set *isl_set_finalize(struct isl_set *set);
 __isl_give isl_set *isl_set_copy(__isl_keep isl_set *set);
 __isl_null isl_set *isl_set_free(__isl_take isl_set *set);
+__isl_give isl_set *isl_set_compact(__isl_take isl_set *set);
 struct isl_set *isl_set_dup(struct isl_set *set);
 __isl_constructor
 __isl_give isl_set *isl_set_from_basic_set(__isl_take isl_basic_set *bset);
@@ -524,6 +526,8 @@ __isl_give isl_basic_set *isl_set_solutions(__isl_take isl_set *set);
 
 __isl_give isl_pw_aff *isl_set_dim_max(__isl_take isl_set *set, int pos);
 __isl_give isl_pw_aff *isl_set_dim_min(__isl_take isl_set *set, int pos);
+int isl_set_box_hull(__isl_keep isl_set *set,
+	__isl_give isl_multi_pw_aff **lower, __isl_give isl_multi_pw_aff **upper);
 
 __isl_give char *isl_set_to_str(__isl_keep isl_set *set);
 
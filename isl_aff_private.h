@@ -81,6 +81,8 @@ __isl_give isl_aff *isl_aff_add_constant(__isl_take isl_aff *aff, isl_int v);
 
 __isl_give isl_aff *isl_aff_normalize(__isl_take isl_aff *aff);
 
+__isl_give isl_basic_set *isl_aff_nonneg_basic_set(__isl_take isl_aff *aff);
+
 __isl_give isl_aff *isl_aff_expand_divs( __isl_take isl_aff *aff,
 	__isl_take isl_mat *div, int *exp);
 
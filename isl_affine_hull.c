@@ -113,6 +113,7 @@ static void delete_row(struct isl_basic_set *bset, unsigned row)
 	int r;
 
 	t = bset->eq[row];
+	ISL_F_CLR(bset, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	bset->n_eq--;
 	for (r = row; r < bset->n_eq; ++r)
 		bset->eq[r] = bset->eq[r+1];
@@ -8,6 +8,7 @@
  */
 
 #include <isl_ast_private.h>
+#include <isl_printer_private.h>
 
 #undef BASE
 #define BASE ast_expr
@@ -891,6 +892,8 @@ __isl_give isl_ast_node *isl_ast_node_dup(__isl_keep isl_ast_node *node)
 			return isl_ast_node_free(dup);
 		break;
 	case isl_ast_node_for:
+		dup->u.f.degenerate = node->u.f.degenerate;
+		dup->u.f.parallel = node->u.f.parallel;
 		dup->u.f.iterator = isl_ast_expr_copy(node->u.f.iterator);
 		dup->u.f.init = isl_ast_expr_copy(node->u.f.init);
 		dup->u.f.cond = isl_ast_expr_copy(node->u.f.cond);
@@ -1021,6 +1024,99 @@ int isl_ast_node_for_is_degenerate(__isl_keep isl_ast_node *node)
 	return node->u.f.degenerate;
 }
 
+/* Mark the given for node as being parallel, i.e., as not carrying
+ * any dependences.
+ */
+__isl_give isl_ast_node *isl_ast_node_for_mark_parallel(
+	__isl_take isl_ast_node *node)
+{
+	node = isl_ast_node_cow(node);
+	if (!node)
+		return NULL;
+	node->u.f.parallel = 1;
+	return node;
+}
+
+int isl_ast_node_for_is_parallel(__isl_keep isl_ast_node *node)
+{
+	if (!node)
+		return -1;
+	if (node->type != isl_ast_node_for)
+		isl_die(isl_ast_node_get_ctx(node), isl_error_invalid,
+			"not a for node", return -1);
+	return node->u.f.parallel;
+}
+
+static int contains_loop(__isl_keep isl_ast_node *node);
+
+/* Does any element of "list" contain a (non-degenerate) for node?
+ */
+static int list_contains_loop(__isl_keep isl_ast_node_list *list)
+{
+	int i;
+
+	if (!list)
+		return -1;
+
+	for (i = 0; i < list->n; ++i) {
+		int r = contains_loop(list->p[i]);
+		if (r < 0 || r)
+			return r;
+	}
+
+	return 0;
+}
+
+/* Does "node" contain a (non-degenerate) for node?
+ */
+static int contains_loop(__isl_keep isl_ast_node *node)
+{
+	int r;
+
+	if (!node)
+		return -1;
+
+	switch (node->type) {
+	case isl_ast_node_for:
+		if (!node->u.f.degenerate)
+			return 1;
+		return contains_loop(node->u.f.body);
+	case isl_ast_node_if:
+		r = contains_loop(node->u.i.then);
+		if (r < 0 || r || !node->u.i.else_node)
+			return r;
+		return contains_loop(node->u.i.else_node);
+	case isl_ast_node_block:
+		return list_contains_loop(node->u.b.children);
+	case isl_ast_node_user:
+		return 0;
+	case isl_ast_node_error:
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Is the given for node a vectorizable loop?
+ * That is, is it a parallel loop that does not contain
+ * any other (non-degenerate) loop?
+ */
+int isl_ast_node_for_is_vectorizable(__isl_keep isl_ast_node *node)
+{
+	int parallel, inner;
+
+	parallel = isl_ast_node_for_is_parallel(node);
+	if (parallel <= 0)
+		return parallel;
+	if (node->u.f.degenerate)
+		return 0;
+
+	inner = contains_loop(node->u.f.body);
+	if (inner < 0)
+		return -1;
+	return !inner;
+}
+
 __isl_give isl_ast_expr *isl_ast_node_for_get_iterator(
 	__isl_keep isl_ast_node *node)
 {
@@ -1106,6 +1202,28 @@ error:
 	return NULL;
 }
 
+/* Replace the else branch of the if node "node" by "child".
+ */
+__isl_give isl_ast_node *isl_ast_node_if_set_else(
+	__isl_take isl_ast_node *node, __isl_take isl_ast_node *child)
+{
+	node = isl_ast_node_cow(node);
+	if (!node || !child)
+		goto error;
+	if (node->type != isl_ast_node_if)
+		isl_die(isl_ast_node_get_ctx(node), isl_error_invalid,
+			"not an if node", goto error);
+
+	isl_ast_node_free(node->u.i.else_node);
+	node->u.i.else_node = child;
+
+	return node;
+error:
+	isl_ast_node_free(node);
+	isl_ast_node_free(child);
+	return NULL;
+}
+
 __isl_give isl_ast_node *isl_ast_node_if_get_then(
 	__isl_keep isl_ast_node *node)
 {
@@ -1668,6 +1786,44 @@ static __isl_give isl_printer *end_block(__isl_take isl_printer *p)
 	return p;
 }
 
+/* Print an OpenMP pragma for the non-degenerate for node "node", if needed.
+ *
+ * A "parallel for" pragma is printed for a parallel loop that is not
+ * nested inside another loop that was printed with a "parallel for" pragma.
+ * A "simd" pragma is printed for a vectorizable loop, combined
+ * with the "parallel for" pragma if both apply.
+ * The iterators of inner loops are declared inside the loop nest
+ * and are therefore private to each iteration, such that
+ * no explicit "private" clause is required.
+ * Set *parallel if a "parallel for" pragma was printed.
+ */
+static __isl_give isl_printer *print_openmp_pragma(__isl_take isl_printer *p,
+	__isl_keep isl_ast_node *node,
+	__isl_keep isl_ast_print_options *options, int *parallel)
+{
+	int simd;
+
+	*parallel = 0;
+	if (!node->u.f.parallel)
+		return p;
+	*parallel = !p->omp_parallel;
+	simd = isl_ast_node_for_is_vectorizable(node);
+	if (simd < 0)
+		return isl_printer_free(p);
+	if (!*parallel && !simd)
+		return p;
+
+	p = isl_printer_start_line(p);
+	p = isl_printer_print_str(p, "#pragma omp");
+	if (*parallel)
+		p = isl_printer_print_str(p, " parallel for");
+	if (simd)
+		p = isl_printer_print_str(p, " simd");
+	p = isl_printer_end_line(p);
+
+	return p;
+}
+
 /* Print the for node "node".
  *
  * If the for node is degenerate, it is printed as
@@ -1686,17 +1842,28 @@ static __isl_give isl_printer *end_block(__isl_take isl_printer *p)
  * then we print a block around a degenerate for loop such that the variable
  * declaration will not conflict with any potential other declaration
  * of the same variable.
+ *
+ * If the ast_print_openmp option is set, then a non-degenerate for loop
+ * may be preceded by an OpenMP pragma.  While printing the body
+ * of a loop that was printed with a "parallel for" pragma,
+ * p->omp_parallel is set to avoid nested parallel regions.
  */
 static __isl_give isl_printer *print_for_c(__isl_take isl_printer *p,
 	__isl_keep isl_ast_node *node,
 	__isl_keep isl_ast_print_options *options, int in_block, int in_list)
 {
+	isl_ctx *ctx;
 	isl_id *id;
 	const char *name;
 	const char *type;
 
-	type = isl_options_get_ast_iterator_type(isl_printer_get_ctx(p));
+	ctx = isl_printer_get_ctx(p);
+	type = isl_options_get_ast_iterator_type(ctx);
 	if (!node->u.f.degenerate) {
+		int parallel = 0;
+
+		if (isl_options_get_ast_print_openmp(ctx))
+			p = print_openmp_pragma(p, node, options, &parallel);
 		id = isl_ast_expr_get_id(node->u.f.iterator);
 		name = isl_id_get_name(id);
 		isl_id_free(id);
@@ -1714,7 +1881,11 @@ static __isl_give isl_printer *print_for_c(__isl_take isl_printer *p,
 		p = isl_printer_print_str(p, " += ");
 		p = isl_printer_print_ast_expr(p, node->u.f.inc);
 		p = isl_printer_print_str(p, ")");
+		if (parallel && p)
+			p->omp_parallel = 1;
 		p = print_body_c(p, node->u.f.body, NULL, options);
+		if (parallel && p)
+			p->omp_parallel = 0;
 	} else {
 		id = isl_ast_expr_get_id(node->u.f.iterator);
 		name = isl_id_get_name(id);
@@ -182,6 +182,7 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	dup->executed = isl_union_map_copy(build->executed);
 	dup->single_valued = build->single_valued;
 	dup->options = isl_union_map_copy(build->options);
+	dup->dependences = isl_union_map_copy(build->dependences);
 	dup->at_each_domain = build->at_each_domain;
 	dup->at_each_domain_user = build->at_each_domain_user;
 	dup->before_each_for = build->before_each_for;
@@ -195,6 +196,7 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	    !dup->pending || !dup->values ||
 	    !dup->strides || !dup->offsets || !dup->options ||
 	    (build->executed && !dup->executed) ||
+	    (build->dependences && !dup->dependences) ||
 	    (build->value && !dup->value))
 		return isl_ast_build_free(dup);
 
@@ -223,6 +225,9 @@ __isl_give isl_ast_build *isl_ast_build_align_params(
 						isl_space_copy(model));
 	build->options = isl_union_map_align_params(build->options,
 						isl_space_copy(model));
+	if (build->dependences)
+		build->dependences = isl_union_map_align_params(
+				build->dependences, isl_space_copy(model));
 	isl_space_free(model);
 
 	if (!build->domain || !build->values || !build->offsets ||
@@ -266,6 +271,7 @@ __isl_null isl_ast_build *isl_ast_build_free(
 	isl_multi_aff_free(build->schedule_map);
 	isl_union_map_free(build->executed);
 	isl_union_map_free(build->options);
+	isl_union_map_free(build->dependences);
 
 	free(build);
 
@@ -296,6 +302,50 @@ error:
 	return isl_ast_build_free(build);
 }
 
+/* Replace build->dependences by "dependences".
+ *
+ * The dependences relate statement instances, i.e., elements
+ * of the domain of the schedule passed to isl_ast_build_ast_from_schedule.
+ * They are used to determine which of the generated for loops
+ * are parallel.
+ */
+__isl_give isl_ast_build *isl_ast_build_set_dependences(
+	__isl_take isl_ast_build *build, __isl_take isl_union_map *dependences)
+{
+	build = isl_ast_build_cow(build);
+
+	if (!build || !dependences)
+		goto error;
+
+	isl_union_map_free(build->dependences);
+	build->dependences = dependences;
+
+	return build;
+error:
+	isl_union_map_free(dependences);
+	return isl_ast_build_free(build);
+}
+
+/* Return a copy of the dependences set by isl_ast_build_set_dependences,
+ * or NULL if no dependences have been set.
+ */
+__isl_give isl_union_map *isl_ast_build_get_dependences(
+	__isl_keep isl_ast_build *build)
+{
+	if (!build)
+		return NULL;
+	return isl_union_map_copy(build->dependences);
+}
+
+/* Have any dependences been set through isl_ast_build_set_dependences?
+ */
+int isl_ast_build_has_dependences(__isl_keep isl_ast_build *build)
+{
+	if (!build)
+		return -1;
+	return build->dependences != NULL;
+}
+
 /* Set the iterators for the next code generation.
  *
  * If we still have some iterators left from the previous code generation
@@ -791,6 +841,33 @@ error:
 	return NULL;
 }
 
+/* Apply "fn" to "build" and "set", where "fn" restricts "build"
+ * to "set", unless "set" is obviously a universe.
+ * In the latter case, there is nothing to do and we avoid
+ * making a copy of "build".
+ */
+static __isl_give isl_ast_build *restrict_unless_universe(
+	__isl_take isl_ast_build *build, __isl_take isl_set *set,
+	__isl_give isl_ast_build *(*fn)(__isl_take isl_ast_build *build,
+		__isl_take isl_set *set))
+{
+	int universe;
+
+	universe = isl_set_plain_is_universe(set);
+	if (universe < 0)
+		goto error;
+	if (universe) {
+		isl_set_free(set);
+		return build;
+	}
+
+	return fn(build, set);
+error:
+	isl_ast_build_free(build);
+	isl_set_free(set);
+	return NULL;
+}
+
 /* Intersect build->domain with "set", where "set" is specified
  * in terms of the internal schedule domain.
  */
@@ -815,14 +892,12 @@ error:
 	return NULL;
 }
 
-/* Intersect build->generated and build->domain with "set",
- * where "set" is specified in terms of the internal schedule domain.
+/* Intersect build->generated with "set", where "set" is specified
+ * in terms of the internal schedule domain and has known divs.
  */
-__isl_give isl_ast_build *isl_ast_build_restrict_generated(
+static __isl_give isl_ast_build *restrict_generated_only(
 	__isl_take isl_ast_build *build, __isl_take isl_set *set)
 {
-	set = isl_set_compute_divs(set);
-	build = isl_ast_build_restrict_internal(build, isl_set_copy(set));
 	build = isl_ast_build_cow(build);
 	if (!build)
 		goto error;
@@ -840,15 +915,41 @@ error:
 	return NULL;
 }
 
+/* Intersect build->generated and build->domain with "set",
+ * where "set" is specified in terms of the internal schedule domain
+ * and has known divs.
+ */
+static __isl_give isl_ast_build *restrict_generated(
+	__isl_take isl_ast_build *build, __isl_take isl_set *set)
+{
+	build = isl_ast_build_restrict_internal(build, isl_set_copy(set));
+	return restrict_generated_only(build, set);
+}
+
+/* Intersect build->generated and build->domain with "set",
+ * where "set" is specified in terms of the internal schedule domain.
+ */
+__isl_give isl_ast_build *isl_ast_build_restrict_generated(
+	__isl_take isl_ast_build *build, __isl_take isl_set *set)
+{
+	set = isl_set_compute_divs(set);
+	return restrict_unless_universe(build, set, &restrict_generated);
+}
+
 /* Replace the set of pending constraints by "guard", which is then
  * no longer considered as pending.
  * That is, add "guard" to the generated constraints and clear all pending
  * constraints, making the domain equal to the generated constraints.
+ *
+ * Since the domain is replaced by the generated constraints,
+ * there is no need to intersect the original domain with "guard".
  */
 __isl_give isl_ast_build *isl_ast_build_replace_pending_by_guard(
 	__isl_take isl_ast_build *build, __isl_take isl_set *guard)
 {
-	build = isl_ast_build_restrict_generated(build, guard);
+	guard = isl_set_compute_divs(guard);
+	build = restrict_unless_universe(build, guard,
+					&restrict_generated_only);
 	build = isl_ast_build_cow(build);
 	if (!build)
 		return NULL;
@@ -865,12 +966,12 @@ __isl_give isl_ast_build *isl_ast_build_replace_pending_by_guard(
 }
 
 /* Intersect build->pending and build->domain with "set",
- * where "set" is specified in terms of the internal schedule domain.
+ * where "set" is specified in terms of the internal schedule domain
+ * and has known divs.
  */
-__isl_give isl_ast_build *isl_ast_build_restrict_pending(
+static __isl_give isl_ast_build *restrict_pending(
 	__isl_take isl_ast_build *build, __isl_take isl_set *set)
 {
-	set = isl_set_compute_divs(set);
 	build = isl_ast_build_restrict_internal(build, isl_set_copy(set));
 	build = isl_ast_build_cow(build);
 	if (!build)
@@ -889,6 +990,16 @@ error:
 	return NULL;
 }
 
+/* Intersect build->pending and build->domain with "set",
+ * where "set" is specified in terms of the internal schedule domain.
+ */
+__isl_give isl_ast_build *isl_ast_build_restrict_pending(
+	__isl_take isl_ast_build *build, __isl_take isl_set *set)
+{
+	set = isl_set_compute_divs(set);
+	return restrict_unless_universe(build, set, &restrict_pending);
+}
+
 /* Intersect build->domain with "set", where "set" is specified
  * in terms of the external schedule domain.
  */
@@ -1458,7 +1569,8 @@ static const char *option_str[] = {
  *	  separation_class[[i] -> [c]]
  *		-> separation_class[[i] -> [c]] : i < pos;
  *	  separation_class[[i] -> [c]]
- *		-> separation_class[[i + 1] -> [c]] : i >= pos }
+ *		-> separation_class[[i + 1] -> [c]] : i >= pos;
+ *	  isolate[] -> isolate[] }
  */
 static __isl_give isl_union_map *options_insert_dim(
 	__isl_take isl_union_map *options, __isl_take isl_space *space, int pos)
@@ -1494,6 +1606,12 @@ static __isl_give isl_union_map *options_insert_dim(
 	map = isl_map_set_tuple_name(map, isl_dim_out, name);
 	insertion = isl_union_map_add_map(insertion, map);
 
+	space = isl_union_map_get_space(options);
+	space = isl_space_set_from_params(space);
+	space = isl_space_set_tuple_name(space, isl_dim_set, "isolate");
+	map = isl_map_identity(isl_space_map_from_set(space));
+	insertion = isl_union_map_add_map(insertion, map);
+
 	options = isl_union_map_apply_range(options, insertion);
 
 	return options;
@@ -2054,6 +2172,38 @@ __isl_give isl_set *isl_ast_build_get_option_domain(
 	return domain;
 }
 
+/* Extract the isolated schedule domain from build->options.
+ *
+ * In particular, find the subset of build->options that is of
+ * the following form
+ *
+ *	schedule_domain -> isolate[]
+ *
+ * and return the corresponding domain.
+ * In contrast to the other options, the isolate option does not
+ * refer to a specific schedule dimension, so the domain is returned
+ * without eliminating any dimensions.
+ *
+ * Note that the domain of build->options has been reformulated
+ * in terms of the internal build space in embed_options.
+ */
+__isl_give isl_set *isl_ast_build_get_isolated(__isl_keep isl_ast_build *build)
+{
+	isl_space *space;
+	isl_map *option;
+
+	if (!build)
+		return NULL;
+
+	space = isl_ast_build_get_space(build, 1);
+	space = isl_space_from_domain(space);
+	space = isl_space_set_tuple_name(space, isl_dim_out, "isolate");
+
+	option = isl_union_map_extract_map(build->options, space);
+
+	return isl_map_domain(option);
+}
+
 /* Extract the separation class mapping at the current depth.
  *
  * In particular, find and return the subset of build->options that is of
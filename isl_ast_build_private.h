@@ -110,6 +110,10 @@ enum isl_ast_build_domain_type {
  * in turn only used by user code from within a callback.
  * The value is set right before we may be calling such a callback.
  *
+ * "dependences" contains the dependences between statement instances,
+ * as set by isl_ast_build_set_dependences.  It is NULL if no dependences
+ * have been set, in which case no for loops are marked parallel.
+ *
  * "single_valued" is set if the current inverse schedule (which may or may
  * not be stored in "executed") is known to be single valued, specifically
  * an inverse schedule that was not (appeared not to be) single valued
@@ -157,6 +161,7 @@ struct isl_ast_build {
 	void *create_leaf_user;
 
 	isl_union_map *executed;
+	isl_union_map *dependences;
 	int single_valued;
 };
 
@@ -189,6 +194,9 @@ __isl_give isl_ast_build *isl_ast_build_include_stride(
 __isl_give isl_ast_build *isl_ast_build_set_executed(
 	__isl_take isl_ast_build *build,
 	__isl_take isl_union_map *executed);
+__isl_give isl_union_map *isl_ast_build_get_dependences(
+	__isl_keep isl_ast_build *build);
+int isl_ast_build_has_dependences(__isl_keep isl_ast_build *build);
 __isl_give isl_ast_build *isl_ast_build_set_single_valued(
 	__isl_take isl_ast_build *build, int sv);
 __isl_give isl_set *isl_ast_build_get_domain(
@@ -250,6 +258,8 @@ void isl_ast_build_dump(__isl_keep isl_ast_build *build);
 __isl_give isl_set *isl_ast_build_get_option_domain(
 	__isl_keep isl_ast_build *build,
 	enum isl_ast_build_domain_type type);
+__isl_give isl_set *isl_ast_build_get_isolated(
+	__isl_keep isl_ast_build *build);
 __isl_give isl_map *isl_ast_build_get_separation_class(
 	__isl_keep isl_ast_build *build);
 __isl_give isl_set *isl_ast_build_eliminate(
@@ -1298,6 +1298,75 @@ static __isl_give isl_ast_node *create_for(__isl_keep isl_ast_build *build,
 	return node;
 }
 
+/* Is the loop at the current depth of "build" parallel?
+ * That is, does it not carry any of the dependences set by the user?
+ *
+ * "executed" is the inverse schedule of the statement instances
+ * executed by the loop.
+ * We map the dependences to the (internal) schedule domain and
+ * check that no pair of dependent instances that is executed
+ * for the same values of the outer loop iterators
+ * is executed by different iterations of the loop.
+ */
+static int is_parallel(__isl_keep isl_union_map *executed,
+	__isl_keep isl_ast_build *build)
+{
+	int i, depth;
+	int empty;
+	isl_space *space;
+	isl_map *carried, *lt;
+	isl_union_map *deps, *schedule;
+
+	deps = isl_ast_build_get_dependences(build);
+	schedule = isl_union_map_reverse(isl_union_map_copy(executed));
+	deps = isl_union_map_apply_domain(deps, isl_union_map_copy(schedule));
+	deps = isl_union_map_apply_range(deps, schedule);
+
+	depth = isl_ast_build_get_depth(build);
+	space = isl_ast_build_get_space(build, 1);
+	carried = isl_map_universe(isl_space_map_from_set(space));
+	for (i = 0; i < depth; ++i)
+		carried = isl_map_equate(carried, isl_dim_in, i,
+					    isl_dim_out, i);
+	lt = isl_map_order_lt(isl_map_copy(carried), isl_dim_in, depth,
+				isl_dim_out, depth);
+	carried = isl_map_order_gt(carried, isl_dim_in, depth,
+				isl_dim_out, depth);
+	carried = isl_map_union(carried, lt);
+	deps = isl_union_map_intersect(deps, isl_union_map_from_map(carried));
+
+	empty = isl_union_map_is_empty(deps);
+	isl_union_map_free(deps);
+
+	return empty;
+}
+
+/* Create a for node for the current level and mark it parallel
+ * if it is not degenerate, if the user has specified dependences
+ * and if the loop does not carry any of those dependences.
+ */
+static __isl_give isl_ast_node *create_for_node(
+	__isl_keep isl_union_map *executed, __isl_keep isl_ast_build *build,
+	int degenerate)
+{
+	int parallel;
+	isl_ast_node *node;
+
+	node = create_for(build, degenerate);
+	if (degenerate)
+		return node;
+
+	parallel = isl_ast_build_has_dependences(build);
+	if (parallel > 0)
+		parallel = is_parallel(executed, build);
+	if (parallel < 0)
+		return isl_ast_node_free(node);
+	if (parallel)
+		node = isl_ast_node_for_mark_parallel(node);
+
+	return node;
+}
+
 /* If the ast_build_exploit_nested_bounds option is set, then return
  * the constraints enforced by all elements in "list".
  * Otherwise, return the universe.
@@ -1384,7 +1453,8 @@ static __isl_give isl_set *extract_pending(__isl_keep isl_ast_build *build,
  * in the inverse schedule.  This operation also eliminates the current
  * dimension from the inverse schedule making sure no inner dimensions depend
  * on the current dimension.  Otherwise, we create a for node, marking
- * it degenerate if appropriate.  The initial for node is still incomplete
+ * it degenerate or parallel if appropriate.
+ * The initial for node is still incomplete
  * and will be completed in either refine_degenerate or refine_generic.
  *
  * We then generate a sequence of grafts for the next level,
@@ -1440,7 +1510,7 @@ static __isl_give isl_ast_graft *create_node_scaled(
 	if (eliminated)
 		executed = plug_in_values(executed, sub_build);
 	else
-		node = create_for(build, degenerate);
+		node = create_for_node(executed, build, degenerate);
 
 	body_build = isl_ast_build_copy(sub_build);
 	body_build = isl_ast_build_increase_depth(body_build);
@@ -2998,13 +3068,13 @@ static __isl_give isl_basic_set_list *compute_domains(
 }
 
 /* Generate code for a single component, after shifting (if any)
- * has been applied.
+ * has been applied, without taking into account the isolate option.
  *
  * We first split up the domain at the current depth into disjoint
  * basic sets based on the user-specified options.
  * Then we generated code for each of them and concatenate the results.
  */
-static __isl_give isl_ast_graft_list *generate_shifted_component(
+static __isl_give isl_ast_graft_list *generate_shifted_component_base(
 	__isl_take isl_union_map *executed, __isl_take isl_ast_build *build)
 {
 	isl_basic_set_list *domain_list;
@@ -3020,6 +3090,134 @@ static __isl_give isl_ast_graft_list *generate_shifted_component(
 	return list;
 }
 
+/* Generate code for the part of the inverse schedule "executed"
+ * that has "domain" as its schedule domain.
+ *
+ * If the restricted inverse schedule is empty, then no code
+ * needs to be generated.
+ */
+static __isl_give isl_ast_graft_list *generate_shifted_component_part(
+	__isl_keep isl_union_map *executed, __isl_take isl_set *domain,
+	__isl_keep isl_ast_build *build)
+{
+	isl_union_set *uset;
+	int empty;
+
+	uset = isl_union_set_from_set(domain);
+	executed = isl_union_map_copy(executed);
+	executed = isl_union_map_intersect_domain(executed, uset);
+	empty = isl_union_map_is_empty(executed);
+	if (empty < 0)
+		goto error;
+	if (empty) {
+		isl_ctx *ctx;
+		isl_union_map_free(executed);
+		ctx = isl_ast_build_get_ctx(build);
+		return isl_ast_graft_list_alloc(ctx, 0);
+	}
+
+	build = isl_ast_build_copy(build);
+	return generate_shifted_component_base(executed, build);
+error:
+	isl_union_map_free(executed);
+	return NULL;
+}
+
+/* Generate code for a single component, after shifting (if any)
+ * has been applied.
+ *
+ * We first check if the user has specified an isolated schedule domain
+ * (through the isolate option) that intersects the current schedule domain.
+ * If so, we break up the schedule domain into iterations that
+ * precede the isolated domain at the current depth,
+ * the isolated domain itself, the iterations that follow
+ * the isolated domain at the current depth and
+ * the remaining iterations (those that are incomparable
+ * to the isolated domain at the current depth).
+ * The isolated domain is first projected onto the current and outer
+ * dimensions and replaced by its unshifted simple hull such that
+ * the other pieces can be described as lying entirely before or after it.
+ * We generate an AST for each piece and concatenate the results.
+ * Since the code for the isolated piece is generated separately,
+ * the constraints of the isolated domain end up in the build domain
+ * of the inner levels, such that the inner loops of the isolated piece
+ * do not require any of the bounds or guards that are only needed
+ * for the other pieces.
+ * If the isolated domain does not intersect the schedule domain,
+ * then we generate an AST for the entire inverse schedule.
+ */
+static __isl_give isl_ast_graft_list *generate_shifted_component(
+	__isl_take isl_union_map *executed, __isl_take isl_ast_build *build)
+{
+	int i, depth;
+	int empty;
+	isl_space *space;
+	isl_union_set *schedule_domain;
+	isl_set *domain;
+	isl_basic_set *hull;
+	isl_set *isolated, *before, *after;
+	isl_map *gt, *lt;
+	isl_ast_graft_list *list, *res;
+
+	isolated = isl_ast_build_get_isolated(build);
+	empty = isl_set_plain_is_empty(isolated);
+	if (empty < 0)
+		goto error;
+	if (empty) {
+		isl_set_free(isolated);
+		return generate_shifted_component_base(executed, build);
+	}
+
+	schedule_domain = isl_union_map_domain(isl_union_map_copy(executed));
+	domain = isl_set_from_union_set(schedule_domain);
+
+	isolated = isl_set_intersect(isolated, isl_set_copy(domain));
+	isolated = isl_set_intersect(isolated, isl_ast_build_get_domain(build));
+	empty = isl_set_is_empty(isolated);
+	if (empty < 0 || empty) {
+		isl_set_free(isolated);
+		isl_set_free(domain);
+		if (empty < 0)
+			goto error;
+		return generate_shifted_component_base(executed, build);
+	}
+	isolated = isl_ast_build_eliminate(build, isolated);
+	hull = isl_set_unshifted_simple_hull(isolated);
+	isolated = isl_set_from_basic_set(hull);
+
+	depth = isl_ast_build_get_depth(build);
+	space = isl_space_map_from_set(isl_set_get_space(isolated));
+	gt = isl_map_universe(space);
+	for (i = 0; i < depth; ++i)
+		gt = isl_map_equate(gt, isl_dim_in, i, isl_dim_out, i);
+	gt = isl_map_order_gt(gt, isl_dim_in, depth, isl_dim_out, depth);
+	lt = isl_map_reverse(isl_map_copy(gt));
+	before = isl_set_apply(isl_set_copy(isolated), gt);
+	after = isl_set_apply(isl_set_copy(isolated), lt);
+
+	domain = isl_set_subtract(domain, isl_set_copy(isolated));
+	before = isl_set_intersect(before, isl_set_copy(domain));
+	domain = isl_set_subtract(domain, isl_set_copy(before));
+	after = isl_set_intersect(after, isl_set_copy(domain));
+	domain = isl_set_subtract(domain, isl_set_copy(after));
+
+	res = generate_shifted_component_part(executed, domain, build);
+	list = generate_shifted_component_part(executed, before, build);
+	res = isl_ast_graft_list_concat(res, list);
+	list = generate_shifted_component_part(executed, isolated, build);
+	res = isl_ast_graft_list_concat(res, list);
+	list = generate_shifted_component_part(executed, after, build);
+	res = isl_ast_graft_list_concat(res, list);
+
+	isl_ast_build_free(build);
+	isl_union_map_free(executed);
+	return res;
+error:
+	isl_ast_build_free(build);
+	isl_union_map_free(executed);
+	return NULL;
+}
+
 struct isl_set_map_pair {
 	isl_set *set;
 	isl_map *map;
@@ -4034,3 +4232,152 @@ __isl_give isl_ast_node *isl_ast_build_ast_from_schedule(
 
 	return node;
 }
+
+/* Generate an AST for "schedule" within "build" that is specialized
+ * to the parameter domain "context" and return the result in *node.
+ * Also return an expression for the condition under which
+ * this specialized AST should be executed in *guard.
+ *
+ * "remaining" is the part of the domain of "build" that is not covered
+ * by any earlier specialization.  It is updated to exclude "context".
+ *
+ * The condition is simplified with respect to the constraints
+ * in "build", while the specialized AST is generated
+ * in a copy of "build" that has been restricted to "context".
+ * If "context" is disjoint from "remaining",
+ * then no specialized AST is needed and *node is set to NULL.
+ * If "context" contains all of "remaining",
+ * then the guard is not needed and *guard is set to NULL.
+ */
+static int generate_specialized(__isl_keep isl_ast_build *build,
+	__isl_keep isl_union_map *schedule, __isl_take isl_set *context,
+	__isl_keep isl_set **remaining,
+	__isl_give isl_ast_node **node, __isl_give isl_ast_expr **guard)
+{
+	isl_space *space;
+	isl_set *cond;
+	int empty, universe;
+
+	*node = NULL;
+	*guard = NULL;
+
+	if (!isl_set_is_params(context))
+		isl_die(isl_set_get_ctx(context), isl_error_invalid,
+			"expecting parameter domain", goto error);
+
+	build = isl_ast_build_copy(build);
+	build = isl_ast_build_align_params(build, isl_set_get_space(context));
+	context = isl_set_align_params(context,
+					isl_ast_build_get_space(build, 1));
+	space = isl_ast_build_get_space(build, 1);
+	cond = isl_set_intersect_params(isl_set_universe(space), context);
+	*remaining = isl_set_align_params(*remaining, isl_set_get_space(cond));
+	empty = isl_set_is_disjoint(cond, *remaining);
+	universe = isl_set_is_subset(*remaining, cond);
+	if (empty < 0 || universe < 0 || empty) {
+		isl_set_free(cond);
+		isl_ast_build_free(build);
+		return empty < 0 || universe < 0 ? -1 : 0;
+	}
+	*remaining = isl_set_subtract(*remaining, isl_set_copy(cond));
+
+	cond = isl_set_gist(cond, isl_ast_build_get_domain(build));
+	if (!universe)
+		*guard = isl_ast_build_expr_from_set(build, isl_set_copy(cond));
+	build = isl_ast_build_restrict(build, isl_set_params(cond));
+	*node = isl_ast_build_ast_from_schedule(build,
+					    isl_union_map_copy(schedule));
+	isl_ast_build_free(build);
+
+	if (!*remaining || !*node || (!universe && !*guard)) {
+		*node = isl_ast_node_free(*node);
+		*guard = isl_ast_expr_free(*guard);
+		return -1;
+	}
+
+	return 0;
+error:
+	isl_set_free(context);
+	return -1;
+}
+
+/* Generate an AST that visits the elements in the domain of "schedule"
+ * in the relative order specified by the corresponding image element(s),
+ * with specialized versions of the AST for each of the parameter domains
+ * in "contexts".
+ *
+ * The specialized ASTs are generated in the same way
+ * as in isl_ast_build_ast_from_schedule, except that the constraints
+ * of the corresponding parameter domain are added to "build",
+ * allowing the AST generator to simplify loop bounds and guards.
+ * The result is a sequence of if/else nodes that selects
+ * the first specialized AST for which the parameter domain is satisfied
+ * and that falls back to the generic AST otherwise.
+ * Parameter domains that cannot be satisfied given the constraints
+ * in "build" and the earlier parameter domains are ignored.
+ * If a parameter domain covers all remaining cases,
+ * then the corresponding specialized AST is selected unconditionally
+ * and no further versions are generated.
+ */
+__isl_give isl_ast_node *isl_ast_build_ast_from_schedule_specialized(
+	__isl_keep isl_ast_build *build, __isl_take isl_union_map *schedule,
+	__isl_take isl_set_list *contexts)
+{
+	int i, n;
+	isl_ast_node **node;
+	isl_ast_expr **guard;
+	isl_ast_node *res = NULL;
+	isl_set *remaining;
+	isl_ctx *ctx;
+
+	if (!build || !schedule || !contexts)
+		goto error;
+
+	ctx = isl_ast_build_get_ctx(build);
+	n = isl_set_list_n_set(contexts);
+	node = isl_calloc_array(ctx, isl_ast_node *, n);
+	guard = isl_calloc_array(ctx, isl_ast_expr *, n);
+	remaining = isl_ast_build_get_domain(build);
+	if (n && (!node || !guard))
+		goto error_alloc;
+
+	for (i = 0; i < n; ++i) {
+		isl_set *context = isl_set_list_get_set(contexts, i);
+		if (generate_specialized(build, schedule, context, &remaining,
+					&node[i], &guard[i]) < 0)
+			goto error_alloc;
+		if (node[i] && !guard[i])
+			break;
+	}
+
+	if (i < n)
+		res = isl_ast_node_copy(node[i]);
+	else
+		res = isl_ast_build_ast_from_schedule(build,
+						isl_union_map_copy(schedule));
+	while (--i >= 0) {
+		isl_ast_node *if_node;
+
+		if (!node[i])
+			continue;
+		if_node = isl_ast_node_alloc_if(isl_ast_expr_copy(guard[i]));
+		if_node = isl_ast_node_if_set_then(if_node,
+						isl_ast_node_copy(node[i]));
+		res = isl_ast_node_if_set_else(if_node, res);
+	}
+
+error_alloc:
+	for (i = 0; i < n; ++i) {
+		if (node)
+			isl_ast_node_free(node[i]);
+		if (guard)
+			isl_ast_expr_free(guard[i]);
+	}
+	free(node);
+	free(guard);
+	isl_set_free(remaining);
+error:
+	isl_set_list_free(contexts);
+	isl_union_map_free(schedule);
+	return res;
+}
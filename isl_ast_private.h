@@ -66,6 +66,7 @@ struct isl_ast_node {
 		} i;
 		struct {
 			unsigned degenerate : 1;
+			unsigned parallel : 1;
 			isl_ast_expr *iterator;
 			isl_ast_expr *init;
 			isl_ast_expr *cond;
@@ -83,6 +84,8 @@ struct isl_ast_node {
 __isl_give isl_ast_node *isl_ast_node_alloc_for(__isl_take isl_id *id);
 __isl_give isl_ast_node *isl_ast_node_for_mark_degenerate(
 	__isl_take isl_ast_node *node);
+__isl_give isl_ast_node *isl_ast_node_for_mark_parallel(
+	__isl_take isl_ast_node *node);
 __isl_give isl_ast_node *isl_ast_node_alloc_if(__isl_take isl_ast_expr *guard);
 __isl_give isl_ast_node *isl_ast_node_alloc_block(
 	__isl_take isl_ast_node_list *list);
@@ -92,6 +95,8 @@ __isl_give isl_ast_node *isl_ast_node_for_set_body(
 	__isl_take isl_ast_node *node, __isl_take isl_ast_node *body);
 __isl_give isl_ast_node *isl_ast_node_if_set_then(
 	__isl_take isl_ast_node *node, __isl_take isl_ast_node *child);
+__isl_give isl_ast_node *isl_ast_node_if_set_else(
+	__isl_take isl_ast_node *node, __isl_take isl_ast_node *child);
 
 struct isl_ast_print_options {
 	int ref;
@@ -62,7 +62,10 @@ static struct isl_blk extend(struct isl_ctx *ctx, struct isl_blk block,
 	return block;
 }
 
-static void isl_blk_free_force(struct isl_ctx *ctx, struct isl_blk block)
+/* Free "block" without keeping it in the cache of "ctx",
+ * such that its memory is returned to the system.
+ */
+void isl_blk_free_force(struct isl_ctx *ctx, struct isl_blk block)
 {
 	int i;
 
@@ -104,6 +107,14 @@ struct isl_blk isl_blk_alloc(struct isl_ctx *ctx, size_t n)
 	return extend(ctx, block, n);
 }
 
+/* Allocate a block of exactly "n" elements, without reusing
+ * a (possibly larger) block from the cache.
+ */
+struct isl_blk isl_blk_alloc_exact(struct isl_ctx *ctx, size_t n)
+{
+	return extend(ctx, isl_blk_empty(), n);
+}
+
 struct isl_blk isl_blk_extend(struct isl_ctx *ctx, struct isl_blk block,
 				size_t new_n)
 {
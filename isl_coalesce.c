@@ -15,6 +15,7 @@
  * B.P. 105 - 78153 Le Chesnay, France
  */
 
+#include <isl_ctx_private.h>
 #include "isl_map_private.h"
 #include <isl_seq.h>
 #include <isl/options.h>
@@ -2479,6 +2480,8 @@ static int coalesce_range(isl_ctx *ctx, struct isl_coalesce_info *info,
 
 			if (info[j].removed)
 				continue;
+			if (isl_ctx_check_abort(ctx) < 0)
+				return -1;
 			if (info[i].removed)
 				isl_die(ctx, isl_error_internal,
 					"basic map unexpectedly removed",
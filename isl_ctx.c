@@ -7,9 +7,13 @@
  * Computerwetenschappen, Celestijnenlaan 200A, B-3001 Leuven, Belgium
  */
 
+#include <string.h>
 #include <isl_ctx_private.h>
-#include <isl/vec.h>
+#include <isl_vec_private.h>
 #include <isl_options_private.h>
+#include <isl_space_private.h>
+#include <isl_id_private.h>
+#include <isl_reordering.h>
 
 #define __isl_calloc(type,size)		((type *)calloc(1, size))
 #define __isl_calloc_type(type)		__isl_calloc(type,sizeof(type))
@@ -25,25 +29,71 @@ static void *check_non_null(isl_ctx *ctx, void *p, size_t size)
 	isl_die(ctx, isl_error_alloc, "allocation failure", return NULL);
 }
 
+/* Atomic accessors for flags that may be set from a thread
+ * other than the one performing the computation.
+ */
+#if defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define isl_atomic_load(p)	__atomic_load_n(p, __ATOMIC_RELAXED)
+#define isl_atomic_store(p,v)	__atomic_store_n(p, v, __ATOMIC_RELAXED)
+#else
+#define isl_atomic_load(p)	(*(volatile int *)(p))
+#define isl_atomic_store(p,v)	(*(volatile int *)(p) = (v))
+#endif
+
+/* A cancellation token that can be attached to one or more isl_ctx
+ * objects.  "cancelled" is only accessed through
+ * isl_atomic_load and isl_atomic_store such that the token
+ * can be cancelled from any thread.
+ */
+struct isl_cancel_token {
+	int cancelled;
+};
+
+/* Check whether the computation in "ctx" should be aborted,
+ * either because the user has explicitly aborted the computation
+ * or because the cancellation token attached to "ctx" has been cancelled.
+ * Return 0 if the computation may continue and
+ * return -1 (after setting the error) if it should be aborted.
+ *
+ * This function does not count as an operation and can therefore
+ * be called in inner loops without affecting the operation count.
+ */
+int isl_ctx_check_abort(isl_ctx *ctx)
+{
+	if (!ctx)
+		return -1;
+	if (isl_atomic_load(&ctx->abort) ||
+	    (ctx->cancel_token &&
+	     isl_atomic_load(&ctx->cancel_token->cancelled))) {
+		isl_ctx_set_error(ctx, isl_error_abort);
+		return -1;
+	}
+	return 0;
+}
+
 /* Prepare for performing the next "operation" in the context.
  * Return 0 if we are allowed to perform this operation and
  * return -1 if we should abort the computation.
  *
  * In particular, we should stop if the user has explicitly aborted
- * the computation or if the maximal number of operations has been exceeded.
+ * the computation, if the attached cancellation token has been cancelled,
+ * if the maximal number of operations has been exceeded or
+ * if the progress callback asks us to stop.
  */
 int isl_ctx_next_operation(isl_ctx *ctx)
 {
-	if (!ctx)
+	if (isl_ctx_check_abort(ctx) < 0)
 		return -1;
-	if (ctx->abort) {
-		isl_ctx_set_error(ctx, isl_error_abort);
-		return -1;
-	}
 	if (ctx->max_operations && ctx->operations >= ctx->max_operations)
 		isl_die(ctx, isl_error_quota,
 			"maximal number of operations exceeded", return -1);
 	ctx->operations++;
+	if (ctx->progress && ctx->operations % ctx->progress_period == 0 &&
+	    ctx->progress(ctx, ctx->operations, ctx->progress_user) < 0) {
+		isl_ctx_set_error(ctx, isl_error_abort);
+		return -1;
+	}
 	return 0;
 }
 
@@ -166,6 +216,8 @@ isl_ctx *isl_ctx_alloc_with_options(struct isl_args *args, void *user_opt)
 
 	if (isl_hash_table_init(ctx, &ctx->id_table, 0))
 		goto error;
+	if (isl_hash_table_init(ctx, &ctx->space_table, 0))
+		goto error;
 
 	ctx->stats = isl_calloc_type(ctx, struct isl_stats);
 	if (!ctx->stats)
@@ -193,11 +245,14 @@ isl_ctx *isl_ctx_alloc_with_options(struct isl_args *args, void *user_opt)
 
 	ctx->n_cached = 0;
 	ctx->n_miss = 0;
+	ctx->n_vec_cached = 0;
+	ctx->n_reordering_cached = 0;
 
 	ctx->error = isl_error_none;
 
 	ctx->operations = 0;
 	isl_ctx_set_max_operations(ctx, ctx->opt->max_operations);
+	ctx->compacted = 0;
 
 	return ctx;
 error:
@@ -233,12 +288,20 @@ void isl_ctx_deref(struct isl_ctx *ctx)
 static void print_stats(isl_ctx *ctx)
 {
 	fprintf(stderr, "operations: %lu\n", ctx->operations);
+	fprintf(stderr, "tableau pivots: %ld\n", ctx->stats->tab_pivots);
+	fprintf(stderr, "tableau allocations: %ld\n", ctx->stats->tab_allocs);
+	fprintf(stderr, "LP solves: %ld\n", ctx->stats->lp_solves);
+	fprintf(stderr, "GBR LP solves: %ld\n", ctx->stats->gbr_solved_lps);
+	if (ctx->compacted)
+		fprintf(stderr, "compacted bytes: %zu\n", ctx->compacted);
 }
 
 void isl_ctx_free(struct isl_ctx *ctx)
 {
 	if (!ctx)
 		return;
+	isl_reordering_clear_cache(ctx);
+	isl_space_clear_interned(ctx);
 	if (ctx->ref != 0)
 		isl_die(ctx, isl_error_invalid,
 			"isl_ctx freed, but some objects still reference it",
@@ -248,7 +311,9 @@ void isl_ctx_free(struct isl_ctx *ctx)
 		print_stats(ctx);
 
 	isl_hash_table_clear(&ctx->id_table);
+	isl_hash_table_clear(&ctx->space_table);
 	isl_blk_clear_cache(ctx);
+	isl_vec_clear_cache(ctx);
 	isl_int_clear(ctx->zero);
 	isl_int_clear(ctx->one);
 	isl_int_clear(ctx->two);
@@ -261,6 +326,237 @@ void isl_ctx_free(struct isl_ctx *ctx)
 	free(ctx);
 }
 
+/* An object that is reachable from the caches of an isl_ctx,
+ * along with its reference count "ref" and the number "n_cache_ref"
+ * of references to the object that are held by the caches
+ * or by other objects that are reachable from the caches.
+ */
+struct isl_cached_object {
+	void *ptr;
+	int ref;
+	int n_cache_ref;
+};
+
+/* Data used for collecting the objects that are reachable
+ * from the caches of "ctx".
+ * "table" contains an isl_cached_object for each of these objects.
+ * "n_ctx_ref" is the number of references to "ctx" held by these objects.
+ */
+struct isl_cache_refs {
+	isl_ctx *ctx;
+	struct isl_hash_table table;
+	int n_ctx_ref;
+};
+
+static int has_ptr(const void *entry, const void *val)
+{
+	const struct isl_cached_object *obj = entry;
+
+	return obj->ptr == val;
+}
+
+/* Record a reference to the object "ptr" with reference count "ref".
+ * Return 1 if "ptr" had not been encountered before, 0 if it had
+ * and -1 on error.
+ */
+static int add_cached_ref(struct isl_cache_refs *refs, void *ptr, int ref)
+{
+	uint32_t hash;
+	struct isl_hash_table_entry *entry;
+	struct isl_cached_object *obj;
+
+	hash = isl_hash_builtin(isl_hash_init(), ptr);
+	entry = isl_hash_table_find(refs->ctx, &refs->table, hash,
+				    &has_ptr, ptr, 1);
+	if (!entry)
+		return -1;
+	if (entry->data) {
+		obj = entry->data;
+		obj->n_cache_ref++;
+		return 0;
+	}
+	obj = isl_alloc_type(refs->ctx, struct isl_cached_object);
+	if (!obj)
+		return -1;
+	obj->ptr = ptr;
+	obj->ref = ref;
+	obj->n_cache_ref = 1;
+	entry->data = obj;
+	return 1;
+}
+
+/* Record a reference to "id", unless it is NULL or isl_id_none,
+ * which does not have a proper reference count.
+ * An isl_id holds a single reference to its isl_ctx.
+ */
+static int add_cached_id_ref(struct isl_cache_refs *refs, isl_id *id)
+{
+	int r;
+
+	if (!id || id->ref < 0)
+		return 0;
+	r = add_cached_ref(refs, id, id->ref);
+	if (r > 0)
+		refs->n_ctx_ref++;
+	return r < 0 ? -1 : 0;
+}
+
+/* Record a reference to "space" and, if "space" had not been
+ * encountered before, the references held by "space" itself.
+ * An isl_space holds a single reference to its isl_ctx.
+ * The results of earlier operations cached in an interned space
+ * do not hold a reference (see space_derive).
+ */
+static int add_cached_space_ref(struct isl_cache_refs *refs,
+	isl_space *space)
+{
+	int i, r;
+
+	if (!space)
+		return 0;
+	r = add_cached_ref(refs, space, space->ref);
+	if (r <= 0)
+		return r;
+	refs->n_ctx_ref++;
+	for (i = 0; i < 2; ++i) {
+		if (add_cached_id_ref(refs, space->tuple_id[i]) < 0)
+			return -1;
+		if (add_cached_space_ref(refs, space->nested[i]) < 0)
+			return -1;
+	}
+	for (i = 0; i < space->n_id; ++i)
+		if (add_cached_id_ref(refs, space->ids[i]) < 0)
+			return -1;
+	return 0;
+}
+
+/* Record a reference to "exp" and, if "exp" had not been
+ * encountered before, the reference to its space.
+ */
+static int add_cached_reordering_ref(struct isl_cache_refs *refs,
+	isl_reordering *exp)
+{
+	int r;
+
+	if (!exp)
+		return 0;
+	r = add_cached_ref(refs, exp, exp->ref);
+	if (r <= 0)
+		return r;
+	return add_cached_space_ref(refs, exp->dim);
+}
+
+static int add_interned_ref(void **entry, void *user)
+{
+	return add_cached_space_ref(user, *entry);
+}
+
+/* Is "obj" referenced by anything other than the caches?
+ */
+static int is_referenced_outside(void **entry, void *user)
+{
+	struct isl_cached_object *obj = *entry;
+
+	return obj->ref != obj->n_cache_ref ? -1 : 0;
+}
+
+static int free_cached_object(void **entry, void *user)
+{
+	free(*entry);
+	return 0;
+}
+
+/* Are all references to "ctx" held by the caches of "ctx",
+ * i.e., would clearing the caches leave no object referencing "ctx"?
+ *
+ * The caches are not modified.  Instead, all objects reachable
+ * from the cached parameter alignments and the interned spaces
+ * are collected along with the number of references to them
+ * from within the caches.  If any of these objects is referenced
+ * from elsewhere, then it would survive the clearing of the caches.
+ * Otherwise, they would all get freed and they would release
+ * the "n_ctx_ref" references they hold to "ctx".
+ */
+static int only_referenced_by_caches(isl_ctx *ctx)
+{
+	int i;
+	int only = 1;
+	struct isl_cache_refs refs;
+
+	if (ctx->ref == 0)
+		return 1;
+
+	refs.ctx = ctx;
+	refs.n_ctx_ref = 0;
+	if (isl_hash_table_init(ctx, &refs.table, ctx->space_table.n) < 0)
+		return -1;
+	for (i = 0; i < ctx->n_reordering_cached; ++i) {
+		struct isl_reordering_cache *entry = &ctx->reordering_cache[i];
+
+		if (add_cached_space_ref(&refs, entry->alignee) < 0 ||
+		    add_cached_space_ref(&refs, entry->aligner) < 0 ||
+		    add_cached_reordering_ref(&refs, entry->exp) < 0)
+			only = -1;
+	}
+	if (only >= 0 && ctx->space_table.n > 0 &&
+	    isl_hash_table_foreach(ctx, &ctx->space_table,
+				   &add_interned_ref, &refs) < 0)
+		only = -1;
+	if (only >= 0 && refs.table.n > 0 &&
+	    isl_hash_table_foreach(ctx, &refs.table,
+				   &is_referenced_outside, NULL) < 0)
+		only = 0;
+	if (only > 0 && ctx->ref != refs.n_ctx_ref)
+		only = 0;
+	isl_hash_table_foreach(ctx, &refs.table, &free_cached_object, NULL);
+	isl_hash_table_clear(&refs.table);
+
+	return only;
+}
+
+/* Reset "ctx" to the state it was in right after it was allocated,
+ * except that its options are kept and that the block and vector caches
+ * as well as the (now empty) hash tables keep their allocated memory,
+ * such that "ctx" can be reused for an independent computation
+ * without paying for the allocation of a fresh context.
+ * The cached parameter alignments and the interned spaces are dropped
+ * since they refer to identifiers that may no longer be valid.
+ * As in isl_ctx_free, it is an error for any object
+ * to still reference "ctx", except for the objects in these caches.
+ * In this case, "ctx" is left untouched.
+ */
+int isl_ctx_reset(isl_ctx *ctx)
+{
+	int only;
+
+	if (!ctx)
+		return -1;
+	only = only_referenced_by_caches(ctx);
+	if (only < 0)
+		return -1;
+	if (!only)
+		isl_die(ctx, isl_error_invalid,
+			"isl_ctx reset, but some objects still reference it",
+			return -1);
+
+	isl_reordering_clear_cache(ctx);
+	isl_space_clear_interned(ctx);
+
+	if (ctx->opt->print_stats)
+		print_stats(ctx);
+
+	ctx->error = isl_error_none;
+	isl_ctx_resume(ctx);
+	isl_ctx_set_cancel_token(ctx, NULL);
+	isl_ctx_set_progress_callback(ctx, 0, NULL, NULL);
+	ctx->operations = 0;
+	isl_ctx_set_max_operations(ctx, ctx->opt->max_operations);
+	isl_ctx_reset_stats(ctx);
+	ctx->compacted = 0;
+
+	return 0;
+}
+
 struct isl_options *isl_ctx_options(isl_ctx *ctx)
 {
 	if (!ctx)
@@ -284,21 +580,95 @@ void isl_ctx_set_error(isl_ctx *ctx, enum isl_error error)
 		ctx->error = error;
 }
 
+/* Abort the computation in "ctx".
+ * This function may be called from a thread other than the one
+ * performing the computation.
+ */
 void isl_ctx_abort(isl_ctx *ctx)
 {
 	if (ctx)
-		ctx->abort = 1;
+		isl_atomic_store(&ctx->abort, 1);
 }
 
 void isl_ctx_resume(isl_ctx *ctx)
 {
 	if (ctx)
-		ctx->abort = 0;
+		isl_atomic_store(&ctx->abort, 0);
 }
 
 int isl_ctx_aborted(isl_ctx *ctx)
 {
-	return ctx ? ctx->abort : -1;
+	return ctx ? isl_atomic_load(&ctx->abort) : -1;
+}
+
+/* Allocate a cancellation token that has not been cancelled.
+ */
+isl_cancel_token *isl_cancel_token_alloc(void)
+{
+	return calloc(1, sizeof(isl_cancel_token));
+}
+
+void isl_cancel_token_free(isl_cancel_token *token)
+{
+	free(token);
+}
+
+/* Cancel all computations in the isl_ctx objects to which
+ * "token" is attached.
+ * This function may be called from any thread.
+ */
+void isl_cancel_token_cancel(isl_cancel_token *token)
+{
+	if (token)
+		isl_atomic_store(&token->cancelled, 1);
+}
+
+/* Reset "token" such that it no longer cancels computations.
+ */
+void isl_cancel_token_reset(isl_cancel_token *token)
+{
+	if (token)
+		isl_atomic_store(&token->cancelled, 0);
+}
+
+int isl_cancel_token_is_cancelled(isl_cancel_token *token)
+{
+	return token ? isl_atomic_load(&token->cancelled) : -1;
+}
+
+/* Attach "token" to "ctx", replacing any previously attached token.
+ * "ctx" does not take ownership of "token", which needs to remain
+ * valid for as long as it is attached.
+ * A NULL "token" detaches the current token.
+ */
+void isl_ctx_set_cancel_token(isl_ctx *ctx, isl_cancel_token *token)
+{
+	if (ctx)
+		ctx->cancel_token = token;
+}
+
+isl_cancel_token *isl_ctx_get_cancel_token(isl_ctx *ctx)
+{
+	return ctx ? ctx->cancel_token : NULL;
+}
+
+/* Call "progress" every "period" operations performed by "ctx",
+ * with the total number of operations performed so far.
+ * If "progress" returns a negative value, then the computation
+ * is aborted.
+ * A NULL "progress" or a zero "period" removes the callback.
+ */
+void isl_ctx_set_progress_callback(isl_ctx *ctx, unsigned long period,
+	int (*progress)(isl_ctx *ctx, unsigned long operations, void *user),
+	void *user)
+{
+	if (!ctx)
+		return;
+	if (period == 0)
+		progress = NULL;
+	ctx->progress = progress;
+	ctx->progress_user = progress ? user : NULL;
+	ctx->progress_period = progress ? period : 0;
 }
 
 int isl_ctx_parse_options(isl_ctx *ctx, int argc, char **argv, unsigned flags)
@@ -324,6 +694,14 @@ unsigned long isl_ctx_get_max_operations(isl_ctx *ctx)
 	return ctx ? ctx->max_operations : 0;
 }
 
+/* Return the number of bytes that have been reclaimed by compacting
+ * objects that belong to "ctx".
+ */
+size_t isl_ctx_get_compacted_bytes(isl_ctx *ctx)
+{
+	return ctx ? ctx->compacted : 0;
+}
+
 /* Reset the number of operations performed by "ctx".
  */
 void isl_ctx_reset_operations(isl_ctx *ctx)
@@ -332,3 +710,28 @@ void isl_ctx_reset_operations(isl_ctx *ctx)
 		return;
 	ctx->operations = 0;
 }
+
+/* Return the number of operations performed by "ctx"
+ * since it was created or since the last call
+ * to isl_ctx_reset_operations.
+ */
+unsigned long isl_ctx_get_operations(isl_ctx *ctx)
+{
+	return ctx ? ctx->operations : 0;
+}
+
+/* Return the internal counters of "ctx".
+ */
+const struct isl_stats *isl_ctx_get_stats(isl_ctx *ctx)
+{
+	return ctx ? ctx->stats : NULL;
+}
+
+/* Reset the internal counters of "ctx".
+ */
+void isl_ctx_reset_stats(isl_ctx *ctx)
+{
+	if (!ctx)
+		return;
+	memset(ctx->stats, 0, sizeof(*ctx->stats));
+}
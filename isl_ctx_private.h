@@ -1,6 +1,25 @@
+#ifndef ISL_CTX_PRIVATE_H
+#define ISL_CTX_PRIVATE_H
+
 #include <isl/ctx.h>
 #include <isl_blk.h>
 
+#define ISL_VEC_CACHE_SIZE	20
+#define ISL_REORDERING_CACHE_SIZE	8
+
+struct isl_vec;
+struct isl_space;
+struct isl_reordering;
+
+/* An entry in the cache of parameter alignment reorderings.
+ * "exp" aligns the parameters of "alignee" to those of "aligner".
+ */
+struct isl_reordering_cache {
+	struct isl_space	*alignee;
+	struct isl_space	*aligner;
+	struct isl_reordering	*exp;
+};
+
 struct isl_ctx {
 	int			ref;
 
@@ -21,14 +40,31 @@ struct isl_ctx {
 	int			n_cached;
 	int			n_miss;
 	struct isl_blk		cache[ISL_BLK_CACHE_SIZE];
+	int			n_vec_cached;
+	struct isl_vec		*vec_cache[ISL_VEC_CACHE_SIZE];
+	int			n_reordering_cached;
+	struct isl_reordering_cache
+				reordering_cache[ISL_REORDERING_CACHE_SIZE];
 	struct isl_hash_table	id_table;
+	struct isl_hash_table	space_table;
 
 	enum isl_error		error;
 
 	int			abort;
+	isl_cancel_token	*cancel_token;
+
+	int			(*progress)(isl_ctx *ctx,
+					unsigned long operations, void *user);
+	void			*progress_user;
+	unsigned long		progress_period;
 
 	unsigned long		operations;
 	unsigned long		max_operations;
+
+	size_t			compacted;
 };
 
+int isl_ctx_check_abort(isl_ctx *ctx);
 int isl_ctx_next_operation(isl_ctx *ctx);
+
+#endif
@@ -849,22 +849,18 @@ static __isl_give isl_flow *compute_mem_based_dependences(
 	for (i = 0; i < acc->n_may; ++i) {
 		int plevel;
 		int is_before;
-		isl_space *dim;
-		isl_map *before;
 		isl_map *dep;
 
 		plevel = acc->level_before(acc->source[i].data, acc->sink.data);
 		is_before = plevel & 1;
 		plevel >>= 1;
 
-		dim = isl_map_get_space(res->dep[i].map);
-		if (is_before)
-			before = isl_map_lex_le_first(dim, plevel);
-		else
-			before = isl_map_lex_lt_first(dim, plevel);
 		dep = isl_map_apply_range(isl_map_copy(acc->source[i].map),
 			isl_map_reverse(isl_map_copy(acc->sink.map)));
-		dep = isl_map_intersect(dep, before);
+		if (is_before)
+			dep = isl_map_intersect_lex_le_first(dep, plevel);
+		else
+			dep = isl_map_intersect_lex_lt_first(dep, plevel);
 		mustdo = isl_set_subtract(mustdo,
 					    isl_map_range(isl_map_copy(dep)));
 		res->dep[i].map = isl_map_union(res->dep[i].map, dep);
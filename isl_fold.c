@@ -9,6 +9,7 @@
  */
 
 #define ISL_DIM_H
+#include <isl_ctx_private.h>
 #include <isl_map_private.h>
 #include <isl_union_map_private.h>
 #include <isl_polynomial_private.h>
@@ -199,6 +199,53 @@ int isl_hash_table_foreach(struct isl_ctx *ctx,
 	return 0;
 }
 
+/* Call "fn" on each entry of "table" and remove those entries
+ * for which "fn" returns 1.  "fn" is responsible for freeing
+ * the data of an entry that is removed.
+ *
+ * Removing an entry may move entries that appear later
+ * in the same cluster of occupied entries.
+ * The traversal therefore starts right after an empty entry,
+ * such that such entries have not been visited yet, and
+ * the current position is visited again after a removal.
+ */
+int isl_hash_table_foreach_remove(struct isl_ctx *ctx,
+				struct isl_hash_table *table,
+				int (*fn)(void **entry, void *user), void *user)
+{
+	size_t size;
+	uint32_t start, i;
+
+	if (!table->entries)
+		return -1;
+
+	size = 1 << table->bits;
+	for (start = 0; start < size; ++start)
+		if (!table->entries[start].data)
+			break;
+
+	for (i = 1; i <= size; ) {
+		struct isl_hash_table_entry *entry;
+		int r;
+
+		entry = &table->entries[(start + i) % size];
+		if (!entry->data) {
+			++i;
+			continue;
+		}
+		r = fn(&entry->data, user);
+		if (r < 0)
+			return -1;
+		if (r == 0) {
+			++i;
+			continue;
+		}
+		isl_hash_table_remove(ctx, table, entry);
+	}
+
+	return 0;
+}
+
 void isl_hash_table_remove(struct isl_ctx *ctx,
 				struct isl_hash_table *table,
 				struct isl_hash_table_entry *entry)
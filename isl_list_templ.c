@@ -12,6 +12,7 @@
  * and Ecole Normale Superieure, 45 rue d’Ulm, 75230 Paris, France
  */
 
+#include <isl_ctx_private.h>
 #include <isl_sort.h>
 #include <isl_tarjan.h>
 
@@ -77,6 +78,34 @@ __isl_give LIST(EL) *FN(LIST(EL),dup)(__isl_keep LIST(EL) *list)
 	return dup;
 }
 
+/* Drop any room for additional elements from "list",
+ * provided "list" is not shared.
+ * The number of bytes saved is recorded in the isl_ctx.
+ * The elements themselves are left untouched.
+ */
+__isl_give LIST(EL) *FN(LIST(EL),compact)(__isl_take LIST(EL) *list)
+{
+	isl_ctx *ctx;
+	LIST(EL) *shrunk;
+	size_t n;
+
+	if (!list)
+		return NULL;
+	if (list->ref != 1 || list->size <= 1 || list->n >= list->size)
+		return list;
+
+	ctx = list->ctx;
+	n = list->n ? list->n : 1;
+	shrunk = isl_realloc(ctx, list, LIST(EL),
+			sizeof(LIST(EL)) + (n - 1) * sizeof(struct EL *));
+	if (!shrunk)
+		return list;
+	ctx->compacted += (shrunk->size - n) * sizeof(struct EL *);
+	shrunk->size = n;
+
+	return shrunk;
+}
+
 __isl_give LIST(EL) *FN(LIST(EL),cow)(__isl_take LIST(EL) *list)
 {
 	if (!list)
@@ -22,6 +22,7 @@
 #include "isl_space_private.h"
 #include "isl_equalities.h"
 #include <isl_lp_private.h>
+#include <isl_ilp_private.h>
 #include <isl_seq.h>
 #include <isl/set.h>
 #include <isl/map.h>
@@ -1106,6 +1107,89 @@ __isl_null isl_basic_set *isl_basic_set_free(__isl_take isl_basic_set *bset)
 	return isl_basic_map_free((struct isl_basic_map *)bset);
 }
 
+/* Reallocate the constraints of "bmap" such that there is
+ * no room left for additional constraints or existentially
+ * quantified variables and record the number of bytes saved in the isl_ctx.
+ *
+ * Since the meaning of "bmap" does not change, it is modified in place,
+ * even if it is shared.  The existing coefficients are swapped
+ * into the new blocks rather than copied.
+ * The old blocks are not kept in the block cache of the isl_ctx
+ * since the memory would then not actually be reclaimed.
+ * If any of the allocations fails, then "bmap" is left untouched.
+ */
+__isl_give isl_basic_map *isl_basic_map_compact(__isl_take isl_basic_map *bmap)
+{
+	int i;
+	isl_ctx *ctx;
+	size_t before, after;
+	unsigned n_row, row_size;
+	struct isl_blk block, block2;
+	isl_int **ineq, **eq, **div = NULL;
+
+	if (!bmap)
+		return NULL;
+
+	n_row = bmap->n_eq + bmap->n_ineq;
+	row_size = 1 + isl_basic_map_total_dim(bmap);
+	before = (bmap->block.size + bmap->block2.size) * sizeof(isl_int) +
+		(bmap->c_size + bmap->extra) * sizeof(isl_int *);
+	after = (n_row * row_size + bmap->n_div * (1 + row_size)) *
+			sizeof(isl_int) +
+		(n_row + bmap->n_div) * sizeof(isl_int *);
+	if (after >= before)
+		return bmap;
+
+	ctx = bmap->ctx;
+	block = isl_blk_alloc_exact(ctx, n_row * row_size);
+	block2 = isl_blk_alloc_exact(ctx, bmap->n_div * (1 + row_size));
+	ineq = isl_alloc_array(ctx, isl_int *, n_row);
+	if (bmap->n_div)
+		div = isl_alloc_array(ctx, isl_int *, bmap->n_div);
+	if (isl_blk_is_error(block) || isl_blk_is_error(block2) ||
+	    (n_row && !ineq) || (bmap->n_div && !div)) {
+		isl_blk_free(ctx, block);
+		isl_blk_free(ctx, block2);
+		free(ineq);
+		free(div);
+		return bmap;
+	}
+
+	eq = ineq + bmap->n_ineq;
+	for (i = 0; i < n_row; ++i)
+		ineq[i] = block.data + i * row_size;
+	for (i = 0; i < bmap->n_ineq; ++i)
+		isl_seq_swp_or_cpy(ineq[i], bmap->ineq[i], row_size);
+	for (i = 0; i < bmap->n_eq; ++i)
+		isl_seq_swp_or_cpy(eq[i], bmap->eq[i], row_size);
+	for (i = 0; i < bmap->n_div; ++i) {
+		div[i] = block2.data + i * (1 + row_size);
+		isl_seq_swp_or_cpy(div[i], bmap->div[i], 1 + row_size);
+	}
+
+	free(bmap->div);
+	isl_blk_free_force(ctx, bmap->block2);
+	free(bmap->ineq);
+	isl_blk_free_force(ctx, bmap->block);
+
+	bmap->block = block;
+	bmap->block2 = block2;
+	bmap->ineq = ineq;
+	bmap->eq = eq;
+	bmap->div = div;
+	bmap->c_size = n_row;
+	bmap->extra = bmap->n_div;
+
+	ctx->compacted += before - after;
+
+	return bmap;
+}
+
+__isl_give isl_basic_set *isl_basic_set_compact(__isl_take isl_basic_set *bset)
+{
+	return isl_basic_map_compact(bset);
+}
+
 static int room_for_con(struct isl_basic_map *bmap, unsigned n)
 {
 	return bmap->n_eq + bmap->n_ineq + n <= bmap->c_size;
@@ -1171,6 +1255,7 @@ int isl_basic_map_alloc_equality(struct isl_basic_map *bmap)
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_IMPLICIT);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_ALL_EQUALITIES);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NORMALIZED_DIVS);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	if ((bmap->eq - bmap->ineq) + bmap->n_eq == bmap->c_size) {
 		isl_int *t;
 		int j = isl_basic_map_alloc_inequality(bmap);
@@ -1200,6 +1285,7 @@ int isl_basic_map_free_equality(struct isl_basic_map *bmap, unsigned n)
 	if (!bmap)
 		return -1;
 	isl_assert(bmap->ctx, n <= bmap->n_eq, return -1);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	bmap->n_eq -= n;
 	return 0;
 }
@@ -1221,6 +1307,7 @@ int isl_basic_map_drop_equality(struct isl_basic_map *bmap, unsigned pos)
 		bmap->eq[pos] = bmap->eq[bmap->n_eq - 1];
 		bmap->eq[bmap->n_eq - 1] = t;
 	}
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	bmap->n_eq--;
 	return 0;
 }
@@ -1253,6 +1340,7 @@ void isl_basic_map_inequality_to_equality(
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NORMALIZED);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NORMALIZED_DIVS);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_ALL_EQUALITIES);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 }
 
 static int room_for_ineq(struct isl_basic_map *bmap, unsigned n)
@@ -1271,6 +1359,7 @@ int isl_basic_map_alloc_inequality(struct isl_basic_map *bmap)
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NORMALIZED);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_ALL_EQUALITIES);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	isl_seq_clr(bmap->ineq[bmap->n_ineq] +
 		      1 + isl_basic_map_total_dim(bmap),
 		      bmap->extra - bmap->n_div);
@@ -1287,6 +1376,7 @@ int isl_basic_map_free_inequality(struct isl_basic_map *bmap, unsigned n)
 	if (!bmap)
 		return -1;
 	isl_assert(bmap->ctx, n <= bmap->n_ineq, return -1);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	bmap->n_ineq -= n;
 	return 0;
 }
@@ -1309,6 +1399,7 @@ int isl_basic_map_drop_inequality(struct isl_basic_map *bmap, unsigned pos)
 		bmap->ineq[bmap->n_ineq - 1] = t;
 		ISL_F_CLR(bmap, ISL_BASIC_MAP_NORMALIZED);
 	}
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	bmap->n_ineq--;
 	return 0;
 }
@@ -1377,6 +1468,7 @@ int isl_basic_map_alloc_div(struct isl_basic_map *bmap)
 		      1 + 1 + isl_basic_map_total_dim(bmap),
 		      bmap->extra - bmap->n_div);
 	ISL_F_CLR(bmap, ISL_BASIC_MAP_NORMALIZED_DIVS);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	return bmap->n_div++;
 }
 
@@ -1390,6 +1482,7 @@ int isl_basic_map_free_div(struct isl_basic_map *bmap, unsigned n)
 	if (!bmap)
 		return -1;
 	isl_assert(bmap->ctx, n <= bmap->n_div, return -1);
+	ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	bmap->n_div -= n;
 	return 0;
 }
@@ -1629,6 +1722,7 @@ struct isl_basic_map *isl_basic_map_cow(struct isl_basic_map *bmap)
 	if (bmap) {
 		ISL_F_CLR(bmap, ISL_BASIC_SET_FINAL);
 		ISL_F_CLR(bmap, ISL_BASIC_MAP_REDUCED_COEFFICIENTS);
+		ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	}
 	return bmap;
 }
@@ -2637,6 +2731,43 @@ struct isl_set *isl_set_grow(struct isl_set *set, int n)
 	return (struct isl_set *)isl_map_grow((struct isl_map *)set, n);
 }
 
+/* Compact the basic maps of "map" and, if "map" is not shared,
+ * drop any room for additional basic maps.
+ * The number of bytes saved is recorded in the isl_ctx.
+ */
+__isl_give isl_map *isl_map_compact(__isl_take isl_map *map)
+{
+	int i;
+	isl_ctx *ctx;
+	isl_map *shrunk;
+	size_t n;
+
+	if (!map)
+		return NULL;
+
+	for (i = 0; i < map->n; ++i)
+		map->p[i] = isl_basic_map_compact(map->p[i]);
+
+	if (map->ref != 1 || map->size <= 1 || map->n >= map->size)
+		return map;
+
+	ctx = map->ctx;
+	n = map->n ? map->n : 1;
+	shrunk = isl_realloc(ctx, map, struct isl_map,
+			sizeof(struct isl_map) + (n - 1) * sizeof(isl_basic_map *));
+	if (!shrunk)
+		return map;
+	ctx->compacted += (shrunk->size - n) * sizeof(isl_basic_map *);
+	shrunk->size = n;
+
+	return shrunk;
+}
+
+__isl_give isl_set *isl_set_compact(__isl_take isl_set *set)
+{
+	return isl_map_compact(set);
+}
+
 struct isl_set *isl_set_dup(struct isl_set *set)
 {
 	int i;
@@ -4261,84 +4392,332 @@ __isl_give isl_map *isl_map_lex_ge(__isl_take isl_space *set_dim)
 	return map_lex_gte(isl_space_map_from_set(set_dim), 1);
 }
 
-__isl_give isl_map *isl_set_lex_le_set(__isl_take isl_set *set1,
-	__isl_take isl_set *set2)
+/* Add the constraint var_pos1 <= var_pos2 - 1 (or var_pos1 <= var_pos2
+ * if "equal" is set) to "bmap", where "pos1" and "pos2" refer to
+ * the variables of "bmap", i.e., excluding the constant term.
+ */
+static __isl_give isl_basic_map *add_var_order(__isl_take isl_basic_map *bmap,
+	unsigned pos1, unsigned pos2, int equal)
+{
+	int k;
+
+	bmap = isl_basic_map_cow(bmap);
+	bmap = isl_basic_map_extend_constraints(bmap, 0, 1);
+	k = isl_basic_map_alloc_inequality(bmap);
+	if (k < 0)
+		goto error;
+	isl_seq_clr(bmap->ineq[k], 1 + isl_basic_map_total_dim(bmap));
+	if (!equal)
+		isl_int_set_si(bmap->ineq[k][0], -1);
+	isl_int_set_si(bmap->ineq[k][1 + pos1], -1);
+	isl_int_set_si(bmap->ineq[k][1 + pos2], 1);
+	bmap = isl_basic_map_simplify(bmap);
+	return isl_basic_map_finalize(bmap);
+error:
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
+/* Add the constraint var_pos1 = var_pos2 to "bmap", where "pos1" and "pos2"
+ * refer to the variables of "bmap", i.e., excluding the constant term.
+ */
+static __isl_give isl_basic_map *add_var_equal(__isl_take isl_basic_map *bmap,
+	unsigned pos1, unsigned pos2)
+{
+	int k;
+
+	bmap = isl_basic_map_cow(bmap);
+	bmap = isl_basic_map_extend_constraints(bmap, 1, 0);
+	k = isl_basic_map_alloc_equality(bmap);
+	if (k < 0)
+		goto error;
+	isl_seq_clr(bmap->eq[k], 1 + isl_basic_map_total_dim(bmap));
+	isl_int_set_si(bmap->eq[k][1 + pos1], -1);
+	isl_int_set_si(bmap->eq[k][1 + pos2], 1);
+	return isl_basic_map_simplify(bmap);
+error:
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
+/* Add the parts of "bmap" where the sequence of "n" variables
+ * starting at position "pos1" is lexicographically smaller than
+ * (or equal to if "equal" is set) the sequence of "n" variables
+ * starting at position "pos2" to "map".
+ * "n" is assumed to be positive.
+ *
+ * Rather than intersecting "bmap" with each of the "n" disjuncts
+ * of the explicit lexicographic order, we keep track of the part
+ * of "bmap" where the first "i" pairs of variables are equal and
+ * only construct the next disjunct from this prefix.
+ * If the prefix turns out to be empty, then so are all
+ * remaining disjuncts and we stop.
+ */
+static __isl_give isl_map *add_lex_lte_parts(__isl_take isl_map *map,
+	__isl_take isl_basic_map *bmap, unsigned pos1, unsigned pos2,
+	unsigned n, int equal)
+{
+	int i;
+
+	for (i = 0; i < n; ++i) {
+		isl_basic_map *part;
+
+		if (i + 1 == n) {
+			part = add_var_order(bmap, pos1 + i, pos2 + i, equal);
+			return isl_map_add_basic_map(map, part);
+		}
+		part = add_var_order(isl_basic_map_copy(bmap),
+					pos1 + i, pos2 + i, 0);
+		map = isl_map_add_basic_map(map, part);
+		bmap = add_var_equal(bmap, pos1 + i, pos2 + i);
+		if (!bmap || !map)
+			break;
+		if (ISL_F_ISSET(bmap, ISL_BASIC_MAP_EMPTY))
+			break;
+	}
+
+	isl_basic_map_free(bmap);
+	if (!bmap)
+		return isl_map_free(map);
+	return map;
+}
+
+/* Intersect "map" with the relation that requires the sequence
+ * of "n" variables starting at position "pos1" to be lexicographically
+ * smaller than (or equal to if "equal" is set) the sequence of "n"
+ * variables starting at position "pos2".
+ * The positions refer to the variables of the basic maps in "map",
+ * i.e., excluding the constant term.
+ *
+ * The lexicographic order is never constructed explicitly.
+ * Instead, it is expanded on each basic map of "map" separately,
+ * skipping those parts that are trivially empty.
+ * Since the parts constructed from a single basic map are disjoint,
+ * the result is disjoint if "map" is.
+ */
+static __isl_give isl_map *map_intersect_lex_lte(__isl_take isl_map *map,
+	unsigned pos1, unsigned pos2, unsigned n, int equal)
+{
+	int i;
+	unsigned flags = 0;
+	isl_map *res;
+
+	if (!map)
+		return NULL;
+	if (n == 0) {
+		if (equal)
+			return map;
+		res = isl_map_empty(isl_map_get_space(map));
+		isl_map_free(map);
+		return res;
+	}
+
+	if (ISL_F_ISSET(map, ISL_MAP_DISJOINT))
+		ISL_FL_SET(flags, ISL_MAP_DISJOINT);
+	res = isl_map_alloc_space(isl_map_get_space(map), map->n * n, flags);
+	for (i = 0; res && i < map->n; ++i)
+		res = add_lex_lte_parts(res, isl_basic_map_copy(map->p[i]),
+					pos1, pos2, n, equal);
+
+	isl_map_free(map);
+	return res;
+}
+
+/* Intersect "map" with the relation that requires the first "n"
+ * input dimensions to be lexicographically smaller than
+ * (or equal to if "equal" is set) the first "n" output dimensions.
+ */
+static __isl_give isl_map *map_intersect_lex_lte_first(__isl_take isl_map *map,
+	unsigned n, int equal)
+{
+	unsigned nparam, n_in;
+
+	if (!map)
+		return NULL;
+	if (n > isl_map_dim(map, isl_dim_in) ||
+	    n > isl_map_dim(map, isl_dim_out))
+		isl_die(isl_map_get_ctx(map), isl_error_invalid,
+			"too many dimensions in lexicographic order",
+			return isl_map_free(map));
+
+	nparam = isl_map_dim(map, isl_dim_param);
+	n_in = isl_map_dim(map, isl_dim_in);
+	return map_intersect_lex_lte(map, nparam, nparam + n_in, n, equal);
+}
+
+/* Intersect "map" with the relation that requires the first "n"
+ * input dimensions to be lexicographically greater than
+ * (or equal to if "equal" is set) the first "n" output dimensions.
+ */
+static __isl_give isl_map *map_intersect_lex_gte_first(__isl_take isl_map *map,
+	unsigned n, int equal)
+{
+	unsigned nparam, n_in;
+
+	if (!map)
+		return NULL;
+	if (n > isl_map_dim(map, isl_dim_in) ||
+	    n > isl_map_dim(map, isl_dim_out))
+		isl_die(isl_map_get_ctx(map), isl_error_invalid,
+			"too many dimensions in lexicographic order",
+			return isl_map_free(map));
+
+	nparam = isl_map_dim(map, isl_dim_param);
+	n_in = isl_map_dim(map, isl_dim_in);
+	return map_intersect_lex_lte(map, nparam + n_in, nparam, n, equal);
+}
+
+/* Intersect "map" with the relation that requires the first "n"
+ * input dimensions to be lexicographically smaller than
+ * the first "n" output dimensions, without constructing
+ * this relation explicitly.
+ */
+__isl_give isl_map *isl_map_intersect_lex_lt_first(__isl_take isl_map *map,
+	unsigned n)
+{
+	return map_intersect_lex_lte_first(map, n, 0);
+}
+
+/* Intersect "map" with the relation that requires the first "n"
+ * input dimensions to be lexicographically smaller than or equal to
+ * the first "n" output dimensions, without constructing
+ * this relation explicitly.
+ */
+__isl_give isl_map *isl_map_intersect_lex_le_first(__isl_take isl_map *map,
+	unsigned n)
+{
+	return map_intersect_lex_lte_first(map, n, 1);
+}
+
+/* Intersect "map" with the relation that requires the first "n"
+ * input dimensions to be lexicographically greater than
+ * the first "n" output dimensions, without constructing
+ * this relation explicitly.
+ */
+__isl_give isl_map *isl_map_intersect_lex_gt_first(__isl_take isl_map *map,
+	unsigned n)
+{
+	return map_intersect_lex_gte_first(map, n, 0);
+}
+
+/* Intersect "map" with the relation that requires the first "n"
+ * input dimensions to be lexicographically greater than or equal to
+ * the first "n" output dimensions, without constructing
+ * this relation explicitly.
+ */
+__isl_give isl_map *isl_map_intersect_lex_ge_first(__isl_take isl_map *map,
+	unsigned n)
+{
+	return map_intersect_lex_gte_first(map, n, 1);
+}
+
+/* Construct a map between the elements of "set1" and "set2"
+ * that are lexicographically smaller than (or equal to if "equal" is set)
+ * each other, if "lt" is set, or greater than (or equal to) each other,
+ * if "lt" is not set.
+ */
+static __isl_give isl_map *set_lex_cmp_set(__isl_take isl_set *set1,
+	__isl_take isl_set *set2, int lt, int equal)
 {
 	isl_map *map;
-	map = isl_map_lex_le(isl_set_get_space(set1));
+	unsigned n;
+
+	map = isl_map_universe(isl_space_map_from_set(isl_set_get_space(set1)));
 	map = isl_map_intersect_domain(map, set1);
 	map = isl_map_intersect_range(map, set2);
-	return map;
+	n = isl_map_dim(map, isl_dim_out);
+	if (lt)
+		return map_intersect_lex_lte_first(map, n, equal);
+	else
+		return map_intersect_lex_gte_first(map, n, equal);
+}
+
+__isl_give isl_map *isl_set_lex_le_set(__isl_take isl_set *set1,
+	__isl_take isl_set *set2)
+{
+	return set_lex_cmp_set(set1, set2, 1, 1);
 }
 
 __isl_give isl_map *isl_set_lex_lt_set(__isl_take isl_set *set1,
 	__isl_take isl_set *set2)
 {
-	isl_map *map;
-	map = isl_map_lex_lt(isl_set_get_space(set1));
-	map = isl_map_intersect_domain(map, set1);
-	map = isl_map_intersect_range(map, set2);
-	return map;
+	return set_lex_cmp_set(set1, set2, 1, 0);
 }
 
 __isl_give isl_map *isl_set_lex_ge_set(__isl_take isl_set *set1,
 	__isl_take isl_set *set2)
 {
-	isl_map *map;
-	map = isl_map_lex_ge(isl_set_get_space(set1));
-	map = isl_map_intersect_domain(map, set1);
-	map = isl_map_intersect_range(map, set2);
-	return map;
+	return set_lex_cmp_set(set1, set2, 0, 1);
 }
 
 __isl_give isl_map *isl_set_lex_gt_set(__isl_take isl_set *set1,
 	__isl_take isl_set *set2)
+{
+	return set_lex_cmp_set(set1, set2, 0, 0);
+}
+
+/* Construct a map between the domain elements of "map1" and "map2"
+ * that have images that are lexicographically smaller than
+ * (or equal to if "equal" is set) each other, if "lt" is set,
+ * or greater than (or equal to) each other, if "lt" is not set.
+ *
+ * We compute the product [A -> B] -> [C -> D] of "map1" and "map2",
+ * intersect it with the lexicographic order on C and D and
+ * project out the range, rather than applying "map1" and "map2"
+ * to each of the disjuncts of an explicit lexicographic order.
+ */
+static __isl_give isl_map *map_lex_cmp_map(__isl_take isl_map *map1,
+	__isl_take isl_map *map2, int lt, int equal)
 {
 	isl_map *map;
-	map = isl_map_lex_gt(isl_set_get_space(set1));
-	map = isl_map_intersect_domain(map, set1);
-	map = isl_map_intersect_range(map, set2);
-	return map;
+	unsigned nparam, n_in, n;
+
+	if (!map1 || !map2)
+		goto error;
+	if (!isl_space_tuple_is_equal(map1->dim, isl_dim_out,
+				      map2->dim, isl_dim_out))
+		isl_die(isl_map_get_ctx(map1), isl_error_invalid,
+			"ranges don't match", goto error);
+
+	n = isl_map_dim(map1, isl_dim_out);
+	map = isl_map_product(map1, map2);
+	nparam = isl_map_dim(map, isl_dim_param);
+	n_in = isl_map_dim(map, isl_dim_in);
+	if (lt)
+		map = map_intersect_lex_lte(map, nparam + n_in,
+					    nparam + n_in + n, n, equal);
+	else
+		map = map_intersect_lex_lte(map, nparam + n_in + n,
+					    nparam + n_in, n, equal);
+	return isl_set_unwrap(isl_map_domain(map));
+error:
+	isl_map_free(map1);
+	isl_map_free(map2);
+	return NULL;
 }
 
 __isl_give isl_map *isl_map_lex_le_map(__isl_take isl_map *map1,
 	__isl_take isl_map *map2)
 {
-	isl_map *map;
-	map = isl_map_lex_le(isl_space_range(isl_map_get_space(map1)));
-	map = isl_map_apply_domain(map, isl_map_reverse(map1));
-	map = isl_map_apply_range(map, isl_map_reverse(map2));
-	return map;
+	return map_lex_cmp_map(map1, map2, 1, 1);
 }
 
 __isl_give isl_map *isl_map_lex_lt_map(__isl_take isl_map *map1,
 	__isl_take isl_map *map2)
 {
-	isl_map *map;
-	map = isl_map_lex_lt(isl_space_range(isl_map_get_space(map1)));
-	map = isl_map_apply_domain(map, isl_map_reverse(map1));
-	map = isl_map_apply_range(map, isl_map_reverse(map2));
-	return map;
+	return map_lex_cmp_map(map1, map2, 1, 0);
 }
 
 __isl_give isl_map *isl_map_lex_ge_map(__isl_take isl_map *map1,
 	__isl_take isl_map *map2)
 {
-	isl_map *map;
-	map = isl_map_lex_ge(isl_space_range(isl_map_get_space(map1)));
-	map = isl_map_apply_domain(map, isl_map_reverse(map1));
-	map = isl_map_apply_range(map, isl_map_reverse(map2));
-	return map;
+	return map_lex_cmp_map(map1, map2, 0, 1);
 }
 
 __isl_give isl_map *isl_map_lex_gt_map(__isl_take isl_map *map1,
 	__isl_take isl_map *map2)
 {
-	isl_map *map;
-	map = isl_map_lex_gt(isl_space_range(isl_map_get_space(map1)));
-	map = isl_map_apply_domain(map, isl_map_reverse(map1));
-	map = isl_map_apply_range(map, isl_map_reverse(map2));
-	return map;
+	return map_lex_cmp_map(map1, map2, 0, 0);
 }
 
 __isl_give isl_basic_map *isl_basic_map_from_basic_set(
@@ -5445,6 +5824,8 @@ __isl_give isl_map *isl_map_add_basic_map(__isl_take isl_map *map,
 	}
 	isl_assert(map->ctx, isl_space_is_equal(map->dim, bmap->dim), goto error);
 	isl_assert(map->ctx, map->n < map->size, goto error);
+	if (map->ctx->opt->compact)
+		bmap = isl_basic_map_compact(bmap);
 	map->p[map->n] = bmap;
 	map->n++;
 	ISL_F_CLR(map, ISL_MAP_NORMALIZED);
@@ -6259,6 +6640,39 @@ error:
 #define ADD	isl_map_union_disjoint
 #include "isl_map_lexopt_templ.c"
 
+/* Return the part of "map1" where the image of a domain element
+ * is lexicographically greater than (if "gt" is set) or
+ * smaller than (if "gt" is not set), or equal to (if "equal" is set),
+ * some image of the same domain element in "map2".
+ * "map1" and "map2" are assumed to live in the same space.
+ *
+ * That is, for "gt" set, compute map1 * (map2 . "<") or map1 * (map2 . "<=").
+ * We compute the range product x -> [y -> z] of "map1" and "map2",
+ * intersect it with the lexicographic order on y and z
+ * and project out z, rather than applying "map2" to each of
+ * the disjuncts of an explicit lexicographic order.
+ */
+static __isl_give isl_map *map_intersect_range_lex_cmp(
+	__isl_take isl_map *map1, __isl_take isl_map *map2, int gt, int equal)
+{
+	isl_space *space;
+	unsigned nparam, n_in, n;
+
+	space = isl_map_get_space(map1);
+	n = isl_map_dim(map1, isl_dim_out);
+	map1 = isl_map_range_product(map1, map2);
+	nparam = isl_map_dim(map1, isl_dim_param);
+	n_in = isl_map_dim(map1, isl_dim_in);
+	if (gt)
+		map1 = map_intersect_lex_lte(map1, nparam + n_in + n,
+					     nparam + n_in, n, equal);
+	else
+		map1 = map_intersect_lex_lte(map1, nparam + n_in,
+					     nparam + n_in + n, n, equal);
+	map1 = isl_map_project_out(map1, isl_dim_out, n, n);
+	return isl_map_reset_space(map1, space);
+}
+
 /* Given a map "map", compute the lexicographically minimal
  * (or maximal) image element for each domain element in dom.
  * Set *empty to those elements in dom that do not have an image element.
@@ -6338,22 +6752,14 @@ static __isl_give isl_map *isl_map_partial_lexopt_aligned(
 		isl_map *lt, *le;
 		isl_map *res_i;
 		isl_set *todo_i;
-		isl_space *dim = isl_space_range(isl_map_get_space(res));
 
 		res_i = basic_map_partial_lexopt(isl_basic_map_copy(map->p[i]),
 					isl_set_copy(dom), &todo_i, max);
 
-		if (max) {
-			lt = isl_map_lex_lt(isl_space_copy(dim));
-			le = isl_map_lex_le(dim);
-		} else {
-			lt = isl_map_lex_gt(isl_space_copy(dim));
-			le = isl_map_lex_ge(dim);
-		}
-		lt = isl_map_apply_range(isl_map_copy(res), lt);
-		lt = isl_map_intersect(lt, isl_map_copy(res_i));
-		le = isl_map_apply_range(isl_map_copy(res_i), le);
-		le = isl_map_intersect(le, isl_map_copy(res));
+		lt = map_intersect_range_lex_cmp(isl_map_copy(res_i),
+					isl_map_copy(res), max, 0);
+		le = map_intersect_range_lex_cmp(isl_map_copy(res),
+					isl_map_copy(res_i), max, 1);
 
 		if (!isl_map_is_empty(lt) || !isl_map_is_empty(le)) {
 			res = isl_map_intersect_domain(res,
@@ -6599,6 +7005,271 @@ __isl_give isl_pw_aff *isl_set_dim_min(__isl_take isl_set *set, int pos)
 	return set_dim_opt(set, pos, 0);
 }
 
+/* Compute the integer minimum (or maximum if "max" is set) of
+ * the set dimension "pos" of "bset" and store it in "opt",
+ * given a tableau "tab" of "bset" that may be reused across calls.
+ * "f" is a vector of size 1 + the total dimension of "bset"
+ * that can be used as scratch space.
+ *
+ * We first solve the LP relaxation on "tab".  Since the tableau
+ * is not reset between calls, it is warm-started from the optimum
+ * of the previous call.  If the optimum is attained at an integer point,
+ * then it is also the integer optimum.  Otherwise, we fall back
+ * to isl_basic_set_solve_ilp, which requires any existentially
+ * quantified variables to be turned into set variables first.
+ */
+static enum isl_lp_result basic_set_dim_opt_tab(
+	__isl_keep isl_basic_set *bset, struct isl_tab *tab, int pos, int max,
+	__isl_keep isl_vec *f, isl_int *opt)
+{
+	enum isl_lp_result res;
+	isl_int denom;
+	int integer;
+
+	isl_seq_clr(f->el, f->size);
+	isl_int_set_si(f->el[1 + pos], max ? -1 : 1);
+
+	isl_int_init(denom);
+	res = isl_tab_min(tab, f->el, bset->ctx->one, opt, &denom, 0);
+	integer = res == isl_lp_ok && isl_int_is_one(denom);
+	isl_int_clear(denom);
+	if (res != isl_lp_ok)
+		return res;
+	if (integer) {
+		integer = isl_tab_sample_is_integer(tab);
+		if (integer < 0)
+			return isl_lp_error;
+	}
+	if (!integer) {
+		isl_int_set_si(f->el[1 + pos], 1);
+		bset = isl_basic_set_underlying_set(isl_basic_set_copy(bset));
+		res = isl_basic_set_solve_ilp(bset, max, f->el, opt, NULL);
+		isl_basic_set_free(bset);
+		return res;
+	}
+	if (max)
+		isl_int_neg(*opt, *opt);
+	return isl_lp_ok;
+}
+
+/* Update the bounds in "lower" and "upper" to include the bounds on
+ * the set dimensions of "bset", which is assumed not to have
+ * any parameters.  "empty" is set if no bounds have been stored yet
+ * and is reset as soon as a non-empty "bset" is encountered.
+ *
+ * A single tableau is constructed for "bset" and reused for
+ * computing all the bounds.
+ */
+static int basic_set_update_box(__isl_keep isl_basic_set *bset,
+	__isl_keep isl_vec *lower, __isl_keep isl_vec *upper, int *empty)
+{
+	int i;
+	unsigned total;
+	isl_ctx *ctx;
+	struct isl_tab *tab;
+	isl_vec *f = NULL, *box = NULL;
+	enum isl_lp_result res = isl_lp_ok;
+
+	if (!bset)
+		return -1;
+
+	ctx = isl_basic_set_get_ctx(bset);
+	tab = isl_tab_from_basic_set(bset, 0);
+	if (!tab)
+		return -1;
+	if (tab->empty) {
+		isl_tab_free(tab);
+		return 0;
+	}
+
+	total = isl_basic_set_total_dim(bset);
+	f = isl_vec_alloc(ctx, 1 + total);
+	box = isl_vec_alloc(ctx, 2 * lower->size);
+	if (!f || !box)
+		goto error;
+
+	for (i = 0; i < lower->size; ++i) {
+		res = basic_set_dim_opt_tab(bset, tab, i, 0, f, &box->el[i]);
+		if (res != isl_lp_ok)
+			break;
+		res = basic_set_dim_opt_tab(bset, tab, i, 1, f,
+					    &box->el[lower->size + i]);
+		if (res != isl_lp_ok)
+			break;
+	}
+	if (res == isl_lp_error)
+		goto error;
+	if (res == isl_lp_unbounded)
+		isl_die(ctx, isl_error_invalid,
+			"unbounded optimum", goto error);
+
+	if (res == isl_lp_ok) {
+		for (i = 0; i < lower->size; ++i) {
+			isl_int *b = &box->el[lower->size + i];
+
+			if (*empty || isl_int_lt(box->el[i], lower->el[i]))
+				isl_int_set(lower->el[i], box->el[i]);
+			if (*empty || isl_int_gt(*b, upper->el[i]))
+				isl_int_set(upper->el[i], *b);
+		}
+		*empty = 0;
+	}
+
+	isl_vec_free(box);
+	isl_vec_free(f);
+	isl_tab_free(tab);
+	return 0;
+error:
+	isl_vec_free(box);
+	isl_vec_free(f);
+	isl_tab_free(tab);
+	return -1;
+}
+
+/* Construct an isl_multi_pw_aff in "space" with constant values
+ * taken from "v", or with empty piecewise expressions if "empty" is set.
+ */
+static __isl_give isl_multi_pw_aff *multi_pw_aff_from_vec(
+	__isl_take isl_space *space, __isl_keep isl_vec *v, int empty)
+{
+	int i;
+	isl_ctx *ctx;
+	isl_local_space *ls;
+	isl_multi_pw_aff *mpa;
+
+	if (!space || !v)
+		goto error;
+
+	ctx = isl_space_get_ctx(space);
+	ls = isl_local_space_from_space(isl_space_domain(isl_space_copy(space)));
+	mpa = isl_multi_pw_aff_alloc(space);
+	for (i = 0; i < v->size; ++i) {
+		isl_pw_aff *pa;
+
+		if (empty) {
+			isl_space *space_i;
+			space_i = isl_local_space_get_space(ls);
+			space_i = isl_space_from_domain(space_i);
+			space_i = isl_space_add_dims(space_i, isl_dim_out, 1);
+			pa = isl_pw_aff_empty(space_i);
+		} else {
+			isl_aff *aff;
+			aff = isl_aff_zero_on_domain(isl_local_space_copy(ls));
+			aff = isl_aff_set_constant_val(aff,
+				    isl_val_int_from_isl_int(ctx, v->el[i]));
+			pa = isl_pw_aff_from_aff(aff);
+		}
+		mpa = isl_multi_pw_aff_set_pw_aff(mpa, i, pa);
+	}
+	isl_local_space_free(ls);
+
+	return mpa;
+error:
+	isl_space_free(space);
+	return NULL;
+}
+
+/* Compute the box hull of a "set" without parameters,
+ * i.e., the smallest box containing the integer points of "set",
+ * and return its lower and upper bounds in "lower" and "upper".
+ */
+static int set_box_hull_constant(__isl_keep isl_set *set,
+	__isl_give isl_multi_pw_aff **lower, __isl_give isl_multi_pw_aff **upper)
+{
+	int i;
+	int empty = 1;
+	unsigned dim;
+	isl_space *space;
+	isl_vec *lo, *up;
+
+	dim = isl_set_dim(set, isl_dim_set);
+	lo = isl_vec_alloc(isl_set_get_ctx(set), dim);
+	up = isl_vec_alloc(isl_set_get_ctx(set), dim);
+	if (!lo || !up)
+		goto error;
+
+	for (i = 0; i < set->n; ++i)
+		if (basic_set_update_box(set->p[i], lo, up, &empty) < 0)
+			goto error;
+
+	space = isl_space_from_range(isl_set_get_space(set));
+	*lower = multi_pw_aff_from_vec(isl_space_copy(space), lo, empty);
+	*upper = multi_pw_aff_from_vec(space, up, empty);
+
+	isl_vec_free(lo);
+	isl_vec_free(up);
+	if (!*lower || !*upper)
+		return -1;
+	return 0;
+error:
+	isl_vec_free(lo);
+	isl_vec_free(up);
+	return -1;
+}
+
+/* Compute the box hull of "set", i.e., the smallest box containing
+ * the integer points of "set", and return its lower and upper bounds
+ * as functions of the parameters in "lower" and "upper".
+ * The bounds are only defined for those parameter values
+ * for which "set" is not empty.
+ * "set" is required to be bounded.
+ *
+ * If "set" has no parameters, then the bounds are computed
+ * one basic set at a time, reusing a single tableau for all
+ * the linear programming problems on a given basic set.
+ * Otherwise, each bound is computed using a parametric integer
+ * programming problem by set_dim_opt.
+ */
+int isl_set_box_hull(__isl_keep isl_set *set,
+	__isl_give isl_multi_pw_aff **lower, __isl_give isl_multi_pw_aff **upper)
+{
+	int i;
+	unsigned dim;
+	isl_space *space;
+
+	if (lower)
+		*lower = NULL;
+	if (upper)
+		*upper = NULL;
+	if (!set)
+		return -1;
+	if (!lower || !upper)
+		isl_die(isl_set_get_ctx(set), isl_error_invalid,
+			"output arguments required", return -1);
+
+	if (isl_set_dim(set, isl_dim_param) == 0) {
+		if (set_box_hull_constant(set, lower, upper) >= 0)
+			return 0;
+		goto error;
+	}
+
+	dim = isl_set_dim(set, isl_dim_set);
+	space = isl_space_from_range(isl_set_get_space(set));
+	*lower = isl_multi_pw_aff_alloc(isl_space_copy(space));
+	*upper = isl_multi_pw_aff_alloc(isl_space_copy(space));
+	for (i = 0; i < dim; ++i) {
+		isl_pw_aff *pa;
+
+		pa = set_dim_opt(isl_set_copy(set), i, 0);
+		pa = isl_pw_aff_reset_domain_space(pa,
+					isl_space_domain(isl_space_copy(space)));
+		*lower = isl_multi_pw_aff_set_pw_aff(*lower, i, pa);
+		pa = set_dim_opt(isl_set_copy(set), i, 1);
+		pa = isl_pw_aff_reset_domain_space(pa,
+					isl_space_domain(isl_space_copy(space)));
+		*upper = isl_multi_pw_aff_set_pw_aff(*upper, i, pa);
+	}
+	isl_space_free(space);
+	if (!*lower || !*upper)
+		goto error;
+
+	return 0;
+error:
+	*lower = isl_multi_pw_aff_free(*lower);
+	*upper = isl_multi_pw_aff_free(*upper);
+	return -1;
+}
+
 /* Apply a preimage specified by "mat" on the parameters of "bset".
  * bset is assumed to have only parameters and divs.
  */
@@ -7021,6 +7692,7 @@ static struct isl_map *compute_divs(struct isl_basic_map *bmap)
 			swap_div(bmap, i - n_known, i);
 		bmap->n_div -= n_known;
 		bmap->extra -= n_known;
+		ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	}
 	bmap = isl_basic_map_reset_space(bmap, dim);
 	bset = (struct isl_basic_set *)bmap;
@@ -7069,10 +7741,111 @@ static int map_divs_known(__isl_keep isl_map *map)
 	return 1;
 }
 
+/* Check whether it is ok to define div "div" of "bmap" based on
+ * the equality "eq".
+ * To avoid the introduction of circular definitions of divs, we
+ * do not allow such a definition if the resulting expression would refer to
+ * any other unknown divs or if any known div is defined in
+ * terms of the unknown div.
+ */
+static int ok_to_set_div_from_eq(__isl_keep isl_basic_map *bmap,
+	int div, isl_int *eq)
+{
+	int j;
+	unsigned total = 1 + isl_space_dim(bmap->dim, isl_dim_all);
+
+	for (j = 0; j < bmap->n_div; ++j) {
+		if (div == j)
+			continue;
+		if (isl_int_is_zero(bmap->div[j][0])) {
+			if (!isl_int_is_zero(eq[total + j]))
+				return 0;
+		} else {
+			if (!isl_int_is_zero(bmap->div[j][1 + total + div]))
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Set the expression of the unknown div "div" of "bmap"
+ * from the equality "eq" in which it appears with a non-zero coefficient.
+ * If the equality is of the form
+ *
+ *	f + c d = 0
+ *
+ * then d = -f/c, where the division is exact for every element
+ * of "bmap", such that d can be represented as floor(-f/c)
+ * (or floor(f/-c) if c is negative).
+ */
+static void set_div_from_eq(__isl_keep isl_basic_map *bmap, int div,
+	isl_int *eq)
+{
+	unsigned total = 1 + isl_space_dim(bmap->dim, isl_dim_all);
+
+	if (isl_int_is_pos(eq[total + div])) {
+		isl_seq_neg(bmap->div[div] + 1, eq, total + bmap->n_div);
+		isl_int_set(bmap->div[div][0], eq[total + div]);
+	} else {
+		isl_seq_cpy(bmap->div[div] + 1, eq, total + bmap->n_div);
+		isl_int_neg(bmap->div[div][0], eq[total + div]);
+	}
+	isl_int_set_si(bmap->div[div][1 + total + div], 0);
+}
+
+/* Try and find explicit representations for the unknown divs of "bmap"
+ * directly from its constraints, without having to resort to
+ * parametric integer programming.
+ *
+ * Pairs of opposite inequalities that define a div are detected
+ * by isl_basic_map_remove_duplicate_constraints.
+ * Additionally, an unknown div that appears in an equality
+ * that does not involve any other unknown div is fixed by
+ * that equality.
+ * Since setting the expression of one div may allow the expression
+ * of another div to be set, we repeat this process until
+ * no further progress can be made.
+ */
+static __isl_give isl_basic_map *set_divs_from_constraints(
+	__isl_take isl_basic_map *bmap)
+{
+	int i, j;
+	int progress;
+	unsigned total;
+
+	bmap = isl_basic_map_cow(bmap);
+	bmap = isl_basic_map_remove_duplicate_constraints(bmap, NULL, 1);
+	if (!bmap)
+		return NULL;
+
+	total = 1 + isl_space_dim(bmap->dim, isl_dim_all);
+	do {
+		progress = 0;
+		for (i = 0; i < bmap->n_div; ++i) {
+			if (!isl_int_is_zero(bmap->div[i][0]))
+				continue;
+			for (j = 0; j < bmap->n_eq; ++j) {
+				if (isl_int_is_zero(bmap->eq[j][total + i]))
+					continue;
+				if (!ok_to_set_div_from_eq(bmap, i,
+							    bmap->eq[j]))
+					continue;
+				set_div_from_eq(bmap, i, bmap->eq[j]);
+				progress = 1;
+				break;
+			}
+		}
+	} while (progress);
+
+	return isl_basic_map_order_divs(bmap);
+}
+
 /* If bmap contains any unknown divs, then compute explicit
  * expressions for them.  However, this computation may be
  * quite expensive, so first try to remove divs that aren't
- * strictly needed.
+ * strictly needed and then try to read off the expressions
+ * of the remaining unknown divs from the constraints.
  */
 struct isl_map *isl_basic_map_compute_divs(struct isl_basic_map *bmap)
 {
@@ -7093,6 +7866,17 @@ struct isl_map *isl_basic_map_compute_divs(struct isl_basic_map *bmap)
 	if (known)
 		return isl_map_from_basic_map(bmap);
 
+	bmap = set_divs_from_constraints(bmap);
+
+	known = isl_basic_map_divs_known(bmap);
+	if (known < 0)
+		goto error;
+	if (known) {
+		bmap = isl_basic_map_simplify(bmap);
+		bmap = isl_basic_map_finalize(bmap);
+		return isl_map_from_basic_map(bmap);
+	}
+
 	map = compute_divs(bmap);
 	return map;
 error:
@@ -7933,21 +8717,125 @@ int isl_basic_set_is_equal(
 		(struct isl_basic_map *)bset1, (struct isl_basic_map *)bset2);
 }
 
+/* Does "bmap" contain the sample point cached by a previous
+ * emptiness test?
+ */
+static int basic_map_contains_cached_sample(__isl_keep isl_basic_map *bmap)
+{
+	unsigned total;
+
+	total = 1 + isl_basic_map_total_dim(bmap);
+	if (!bmap->sample || bmap->sample->size != total)
+		return 0;
+	return isl_basic_map_contains(bmap, bmap->sample);
+}
+
+/* Is "bmap" obviously non-empty?
+ * That is, is it a universe or does it contain the sample point
+ * cached by a previous emptiness test?
+ */
+static int basic_map_plain_is_non_empty(__isl_keep isl_basic_map *bmap)
+{
+	if (!bmap)
+		return -1;
+	if (ISL_F_ISSET(bmap, ISL_BASIC_MAP_EMPTY))
+		return 0;
+	if (isl_basic_map_is_universe(bmap))
+		return 1;
+	if (ISL_F_ISSET(bmap, ISL_BASIC_MAP_RATIONAL))
+		return 0;
+	return basic_map_contains_cached_sample(bmap);
+}
+
+/* Return the number of constraints in "map", summed over its basic maps.
+ * This is used as an estimate of the cost of the tableau based
+ * tests on "map".
+ */
+int isl_map_n_constraint_total(__isl_keep isl_map *map)
+{
+	int i;
+	int n = 0;
+
+	if (!map)
+		return 0;
+	for (i = 0; i < map->n; ++i)
+		n += map->p[i]->n_eq + map->p[i]->n_ineq;
+	return n;
+}
+
+/* Compare the basic maps at positions "a" and "b" of "map"
+ * based on their number of constraints.
+ */
+static int cmp_n_constraint(const void *a, const void *b, void *user)
+{
+	isl_map *map = user;
+	isl_basic_map *bmap1 = map->p[*(const int *) a];
+	isl_basic_map *bmap2 = map->p[*(const int *) b];
+
+	return (bmap1->n_eq + bmap1->n_ineq) - (bmap2->n_eq + bmap2->n_ineq);
+}
+
+/* Return the positions of the basic maps of "map" ordered
+ * by increasing number of constraints.
+ * Predicates that can stop as soon as the answer is known for
+ * one of the basic maps use this order to perform the cheapest tests first.
+ * The caller is responsible for freeing the result.
+ */
+int *isl_map_cheapest_first(__isl_keep isl_map *map)
+{
+	int i;
+	int *order;
+
+	if (!map)
+		return NULL;
+	order = isl_alloc_array(map->ctx, int, map->n);
+	if (map->n && !order)
+		return NULL;
+	for (i = 0; i < map->n; ++i)
+		order[i] = i;
+	if (isl_sort(order, map->n, sizeof(int), &cmp_n_constraint, map) < 0) {
+		free(order);
+		return NULL;
+	}
+	return order;
+}
+
+/* Is "map" empty?
+ *
+ * We first look for a basic map that is obviously non-empty.
+ * Otherwise, we perform the full emptiness test on the basic maps,
+ * starting from the ones with the fewest constraints and stopping
+ * at the first non-empty one.
+ */
 int isl_map_is_empty(struct isl_map *map)
 {
 	int i;
 	int is_empty;
+	int *order;
 
 	if (!map)
 		return -1;
+	if (map->n == 0)
+		return 1;
 	for (i = 0; i < map->n; ++i) {
-		is_empty = isl_basic_map_is_empty(map->p[i]);
-		if (is_empty < 0)
-			return -1;
-		if (!is_empty)
-			return 0;
+		int non_empty = basic_map_plain_is_non_empty(map->p[i]);
+		if (non_empty < 0 || non_empty)
+			return non_empty < 0 ? -1 : 0;
 	}
-	return 1;
+	if (map->n == 1)
+		return isl_basic_map_is_empty(map->p[0]);
+
+	order = isl_map_cheapest_first(map);
+	if (!order)
+		return -1;
+	is_empty = 1;
+	for (i = 0; i < map->n; ++i) {
+		is_empty = isl_basic_map_is_empty(map->p[order[i]]);
+		if (is_empty < 0 || !is_empty)
+			break;
+	}
+	free(order);
+	return is_empty;
 }
 
 int isl_map_plain_is_empty(__isl_keep isl_map *map)
@@ -8089,8 +8977,7 @@ int isl_basic_map_is_empty(struct isl_basic_map *bmap)
 {
 	struct isl_basic_set *bset = NULL;
 	struct isl_vec *sample = NULL;
-	int empty;
-	unsigned total;
+	int empty, contains;
 
 	if (!bmap)
 		return -1;
@@ -8109,14 +8996,11 @@ int isl_basic_map_is_empty(struct isl_basic_map *bmap)
 		return empty;
 	}
 
-	total = 1 + isl_basic_map_total_dim(bmap);
-	if (bmap->sample && bmap->sample->size == total) {
-		int contains = isl_basic_map_contains(bmap, bmap->sample);
-		if (contains < 0)
-			return -1;
-		if (contains)
-			return 0;
-	}
+	contains = basic_map_contains_cached_sample(bmap);
+	if (contains < 0)
+		return -1;
+	if (contains)
+		return 0;
 	isl_vec_free(bmap->sample);
 	bmap->sample = NULL;
 	bset = isl_basic_map_underlying_set(isl_basic_map_copy(bmap));
@@ -11236,10 +12120,7 @@ __isl_give isl_map *isl_map_align_params(__isl_take isl_map *map,
 	if (!isl_space_match(map->dim, isl_dim_param, model, isl_dim_param)) {
 		isl_reordering *exp;
 
-		model = isl_space_drop_dims(model, isl_dim_in,
-					0, isl_space_dim(model, isl_dim_in));
-		model = isl_space_drop_dims(model, isl_dim_out,
-					0, isl_space_dim(model, isl_dim_out));
+		model = isl_space_params(model);
 		exp = isl_parameter_alignment_reordering(map->dim, model);
 		exp = isl_reordering_extend_space(exp, isl_map_get_space(map));
 		map = isl_map_realign(map, exp);
@@ -11281,10 +12162,7 @@ __isl_give isl_basic_map *isl_basic_map_align_params(
 		isl_reordering *exp;
 		struct isl_dim_map *dim_map;
 
-		model = isl_space_drop_dims(model, isl_dim_in,
-					0, isl_space_dim(model, isl_dim_in));
-		model = isl_space_drop_dims(model, isl_dim_out,
-					0, isl_space_dim(model, isl_dim_out));
+		model = isl_space_params(model);
 		exp = isl_parameter_alignment_reordering(bmap->dim, model);
 		exp = isl_reordering_extend_space(exp,
 					isl_basic_map_get_space(bmap));
@@ -43,6 +43,7 @@ struct isl_basic_map {
 #define ISL_BASIC_MAP_NORMALIZED_DIVS	(1 << 6)
 #define ISL_BASIC_MAP_ALL_EQUALITIES	(1 << 7)
 #define ISL_BASIC_MAP_REDUCED_COEFFICIENTS	(1 << 8)
+#define ISL_BASIC_MAP_NO_REDUNDANT_DIVS	(1 << 9)
 #define ISL_BASIC_SET_FINAL		(1 << 0)
 #define ISL_BASIC_SET_EMPTY		(1 << 1)
 #define ISL_BASIC_SET_NO_IMPLICIT	(1 << 2)
@@ -52,6 +53,7 @@ struct isl_basic_map {
 #define ISL_BASIC_SET_NORMALIZED_DIVS	(1 << 6)
 #define ISL_BASIC_SET_ALL_EQUALITIES	(1 << 7)
 #define ISL_BASIC_SET_REDUCED_COEFFICIENTS	(1 << 8)
+#define ISL_BASIC_SET_NO_REDUNDANT_DIVS	(1 << 9)
 	unsigned flags;
 
 	struct isl_ctx *ctx;
@@ -224,6 +226,7 @@ struct isl_basic_set *isl_basic_set_gauss(
 	struct isl_basic_set *bset, int *progress);
 __isl_give isl_basic_set *isl_basic_set_sort_constraints(
 	__isl_take isl_basic_set *bset);
+struct isl_basic_map *isl_basic_map_normalize(struct isl_basic_map *bmap);
 int isl_basic_map_plain_cmp(const __isl_keep isl_basic_map *bmap1,
 	const __isl_keep isl_basic_map *bmap2);
 int isl_basic_map_plain_is_equal(__isl_keep isl_basic_map *bmap1,
@@ -268,6 +271,9 @@ struct isl_map *isl_map_remove_empty_parts(struct isl_map *map);
 struct isl_set *isl_set_remove_empty_parts(struct isl_set *set);
 __isl_give isl_map *isl_map_remove_obvious_duplicates(__isl_take isl_map *map);
 
+int isl_map_n_constraint_total(__isl_keep isl_map *map);
+int *isl_map_cheapest_first(__isl_keep isl_map *map);
+
 struct isl_set *isl_set_normalize(struct isl_set *set);
 
 struct isl_set *isl_set_drop_vars(
@@ -606,6 +606,63 @@ static struct isl_basic_map *eliminate_divs_ineq(
 	return bmap;
 }
 
+/* Return the position of the equality of "bmap" at position "first"
+ * or later that should be used to eliminate the variable at position "pos",
+ * or bmap->n_eq if none of these equalities involves the variable.
+ * The equalities are assumed not to involve any later variables.
+ *
+ * Eliminating the variable using an equality with coefficient c
+ * for the variable multiplies the other constraints that involve
+ * the variable by |c|/g, with g the gcd of c and their coefficients.
+ * The equality with the smallest coefficient in absolute value
+ * is therefore selected, preferably a unit coefficient.
+ * Among those, the equality with the fewest non-zero coefficients
+ * is selected, since each of them may introduce a non-zero coefficient
+ * in the other constraints (Markowitz-style pivoting).
+ * In case of a tie, the first equality is selected.
+ */
+static int select_pivot(struct isl_basic_map *bmap, int first, int pos)
+{
+	int k;
+	int best = bmap->n_eq;
+	int best_n = -1;
+
+	for (k = first; k < bmap->n_eq; ++k) {
+		int cmp;
+
+		if (isl_int_is_zero(bmap->eq[k][1 + pos]))
+			continue;
+		if (best == bmap->n_eq) {
+			best = k;
+			continue;
+		}
+		cmp = isl_int_abs_cmp(bmap->eq[k][1 + pos],
+					bmap->eq[best][1 + pos]);
+		if (cmp > 0)
+			continue;
+		if (cmp == 0) {
+			int n;
+
+			if (best_n < 0)
+				best_n = isl_seq_n_non_zero(bmap->eq[best],
+							    1 + pos);
+			n = isl_seq_n_non_zero(bmap->eq[k], 1 + pos);
+			if (n >= best_n)
+				continue;
+			best_n = n;
+		} else
+			best_n = -1;
+		best = k;
+	}
+
+	return best;
+}
+
+/* Perform Gaussian elimination on the equalities of "bmap",
+ * eliminating the variables from last to first.
+ * The equality that is used to eliminate a given variable
+ * is selected by select_pivot.
+ */
 struct isl_basic_map *isl_basic_map_gauss(
 	struct isl_basic_map *bmap, int *progress)
 {
@@ -626,9 +683,7 @@ struct isl_basic_map *isl_basic_map_gauss(
 	last_var = total - 1;
 	for (done = 0; done < bmap->n_eq; ++done) {
 		for (; last_var >= 0; --last_var) {
-			for (k = done; k < bmap->n_eq; ++k)
-				if (!isl_int_is_zero(bmap->eq[k][1+last_var]))
-					break;
+			k = select_pivot(bmap, done, last_var);
 			if (k < bmap->n_eq)
 				break;
 		}
@@ -1320,8 +1375,10 @@ struct isl_basic_map *isl_basic_map_simplify(struct isl_basic_map *bmap)
 		bmap = normalize_divs(bmap, &progress);
 		bmap = isl_basic_map_remove_duplicate_constraints(bmap,
 								&progress, 1);
-		if (bmap && progress)
+		if (bmap && progress) {
 			ISL_F_CLR(bmap, ISL_BASIC_MAP_REDUCED_COEFFICIENTS);
+			ISL_F_CLR(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
+		}
 	}
 	return bmap;
 }
@@ -2651,17 +2708,62 @@ int isl_map_plain_is_disjoint(__isl_keep isl_map *map1,
 	return 1;
 }
 
+/* Are all pairs of basic maps in "map1" and "map2" disjoint?
+ * The two maps are assumed to live in the same space.
+ *
+ * Instead of computing the full intersection, we check the pairs
+ * one by one, starting from the basic maps with the fewest constraints,
+ * and stop as soon as we find a pair that intersects.
+ * Pairs that are obviously disjoint are skipped without
+ * computing their intersection.
+ */
+static int map_basic_maps_are_disjoint(__isl_keep isl_map *map1,
+	__isl_keep isl_map *map2)
+{
+	int i, j;
+	int disjoint = 1;
+	int *order1, *order2;
+
+	order1 = isl_map_cheapest_first(map1);
+	order2 = isl_map_cheapest_first(map2);
+	if (!order1 || !order2)
+		disjoint = -1;
+
+	for (i = 0; disjoint == 1 && i < map1->n; ++i)
+		for (j = 0; disjoint == 1 && j < map2->n; ++j) {
+			isl_basic_map *bmap1 = map1->p[order1[i]];
+			isl_basic_map *bmap2 = map2->p[order2[j]];
+			isl_basic_map *test;
+
+			disjoint = isl_basic_map_plain_is_disjoint(bmap1,
+								   bmap2);
+			if (disjoint < 0 || disjoint)
+				continue;
+			test = isl_basic_map_intersect(
+						isl_basic_map_copy(bmap1),
+						isl_basic_map_copy(bmap2));
+			disjoint = isl_basic_map_is_empty(test);
+			isl_basic_map_free(test);
+		}
+
+	free(order1);
+	free(order2);
+	return disjoint;
+}
+
 /* Are "map1" and "map2" disjoint?
  *
  * They are disjoint if they are "obviously disjoint" or if one of them
  * is empty.  Otherwise, they are not disjoint if one of them is universal.
- * If none of these cases apply, we compute the intersection and see if
- * the result is empty.
+ * If none of these cases apply and the two maps have the same parameters,
+ * then we check the pairs of basic maps one by one.
+ * Otherwise, we compute the intersection and see if the result is empty.
  */
 int isl_map_is_disjoint(__isl_keep isl_map *map1, __isl_keep isl_map *map2)
 {
 	int disjoint;
 	int intersect;
+	int match;
 	isl_map *test;
 
 	disjoint = isl_map_plain_is_disjoint(map1, map2);
@@ -2684,6 +2786,13 @@ int isl_map_is_disjoint(__isl_keep isl_map *map1, __isl_keep isl_map *map2)
 	if (intersect < 0 || intersect)
 		return intersect < 0 ? -1 : 0;
 
+	match = isl_space_match(map1->dim, isl_dim_param,
+				map2->dim, isl_dim_param);
+	if (match < 0)
+		return -1;
+	if (match)
+		return map_basic_maps_are_disjoint(map1, map2);
+
 	test = isl_map_intersect(isl_map_copy(map1), isl_map_copy(map2));
 	disjoint = isl_map_is_empty(test);
 	isl_map_free(test);
@@ -2916,11 +3025,65 @@ static void construct_test_ineq(struct isl_basic_map *bmap, int i,
 	isl_int_sub(ineq[0], ineq[0], g);
 }
 
+/* Does the pair of lower bound l and upper bound u on div i
+ * allow at least one integer value of the div for any value
+ * of the other variables that satisfies both bounds?
+ *
+ * If the coefficient of the div in either bound is 1 or -1,
+ * then the bound itself fixes an integer value of the div
+ * that satisfies the other bound as well.
+ * Otherwise, we construct the test inequality of construct_test_ineq
+ * in "vec" and check whether it is satisfied by all elements
+ * of the basic map, by minimizing it over "tab".
+ * The tableau is only constructed the first time it is needed.
+ *
+ * Return 1 if the pair allows an integer value, 0 if it does not
+ * (or if we could not determine this) and -1 on error.
+ * If the basic map turns out to be empty, then it is marked as such
+ * and 0 is returned.
+ */
+static int is_integer_pair(struct isl_basic_map **bmap, struct isl_tab **tab,
+	int i, int l, int u, struct isl_vec *vec, isl_int *g, isl_int fl,
+	isl_int fu)
+{
+	unsigned dim;
+	enum isl_lp_result res;
+
+	dim = isl_space_dim((*bmap)->dim, isl_dim_all);
+	if (isl_int_is_one((*bmap)->ineq[l][1 + dim + i]) ||
+	    isl_int_is_negone((*bmap)->ineq[u][1 + dim + i]))
+		return 1;
+
+	if (!*tab)
+		*tab = isl_tab_from_basic_map(*bmap, 0);
+	if (!*tab)
+		return -1;
+
+	construct_test_ineq(*bmap, i, l, u, vec->el, *g, fl, fu);
+	res = isl_tab_min(*tab, vec->el, (*bmap)->ctx->one, g, NULL, 0);
+	if (res == isl_lp_error)
+		return -1;
+	if (res == isl_lp_empty) {
+		*bmap = isl_basic_map_set_to_empty(*bmap);
+		return *bmap ? 0 : -1;
+	}
+	if (res != isl_lp_ok || isl_int_is_neg(*g))
+		return 0;
+	return 1;
+}
+
 /* Remove more kinds of divs that are not strictly needed.
  * In particular, if all pairs of lower and upper bounds on a div
  * are such that they allow at least one integer value of the div,
  * the we can eliminate the div using Fourier-Motzkin without
  * introducing any spurious solutions.
+ *
+ * All tests are performed on the same tableau, which is only
+ * constructed if some pair of bounds cannot be handled
+ * by the simple test in is_integer_pair.
+ * If no div can be removed, then this is recorded in the basic map
+ * such that subsequent calls to isl_basic_map_drop_redundant_divs
+ * can return immediately.
  */
 static struct isl_basic_map *drop_more_redundant_divs(
 	struct isl_basic_map *bmap, int *pairs, int n)
@@ -2943,12 +3106,9 @@ static struct isl_basic_map *drop_more_redundant_divs(
 	if (!vec)
 		goto error;
 
-	tab = isl_tab_from_basic_map(bmap, 0);
-
 	while (n > 0) {
 		int i, l, u;
 		int best = -1;
-		enum isl_lp_result res;
 
 		for (i = 0; i < bmap->n_div; ++i) {
 			if (!pairs[i])
@@ -2963,24 +3123,22 @@ static struct isl_basic_map *drop_more_redundant_divs(
 			if (!isl_int_is_pos(bmap->ineq[l][1 + dim + i]))
 				continue;
 			for (u = 0; u < bmap->n_ineq; ++u) {
+				int ok;
+
 				if (!isl_int_is_neg(bmap->ineq[u][1 + dim + i]))
 					continue;
-				construct_test_ineq(bmap, i, l, u,
-						    vec->el, g, fl, fu);
-				res = isl_tab_min(tab, vec->el,
-						  bmap->ctx->one, &g, NULL, 0);
-				if (res == isl_lp_error)
+				ok = is_integer_pair(&bmap, &tab, i, l, u,
+						    vec, &g, fl, fu);
+				if (ok < 0)
 					goto error;
-				if (res == isl_lp_empty) {
-					bmap = isl_basic_map_set_to_empty(bmap);
-					break;
-				}
-				if (res != isl_lp_ok || isl_int_is_neg(g))
+				if (!ok)
 					break;
 			}
 			if (u < bmap->n_ineq)
 				break;
 		}
+		if (ISL_F_ISSET(bmap, ISL_BASIC_MAP_EMPTY))
+			break;
 		if (l == bmap->n_ineq) {
 			remove = i;
 			break;
@@ -2998,8 +3156,11 @@ static struct isl_basic_map *drop_more_redundant_divs(
 
 	free(pairs);
 
-	if (remove < 0)
+	if (remove < 0) {
+		if (!ISL_F_ISSET(bmap, ISL_BASIC_MAP_EMPTY))
+			ISL_F_SET(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 		return bmap;
+	}
 
 	bmap = isl_basic_map_remove_dims(bmap, isl_dim_div, remove, 1);
 	return isl_basic_map_drop_redundant_divs(bmap);
@@ -3175,6 +3336,10 @@ static struct isl_basic_map *coalesce_or_drop_more_redundant_divs(
  *
  * If any divs are left after these simple checks then we move on
  * to more complicated cases in drop_more_redundant_divs.
+ *
+ * If a previous call found that none of the divs can be dropped and
+ * the constraints have not been modified since, then the basic map
+ * is marked ISL_BASIC_MAP_NO_REDUNDANT_DIVS and we return immediately.
  */
 struct isl_basic_map *isl_basic_map_drop_redundant_divs(
 	struct isl_basic_map *bmap)
@@ -3188,6 +3353,8 @@ struct isl_basic_map *isl_basic_map_drop_redundant_divs(
 		goto error;
 	if (bmap->n_div == 0)
 		return bmap;
+	if (ISL_F_ISSET(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS))
+		return bmap;
 
 	off = isl_space_dim(bmap->dim, isl_dim_all);
 	pairs = isl_calloc_array(bmap->ctx, int, bmap->n_div);
@@ -3277,6 +3444,7 @@ struct isl_basic_map *isl_basic_map_drop_redundant_divs(
 		return coalesce_or_drop_more_redundant_divs(bmap, pairs, n);
 
 	free(pairs);
+	ISL_F_SET(bmap, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
 	return bmap;
 error:
 	free(pairs);
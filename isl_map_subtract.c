@@ -7,6 +7,7 @@
  * Computerwetenschappen, Celestijnenlaan 200A, B-3001 Leuven, Belgium
  */
 
+#include <isl_ctx_private.h>
 #include <isl_map_private.h>
 #include <isl_seq.h>
 #include <isl/set.h>
@@ -14,6 +15,7 @@
 #include "isl_tab.h"
 #include <isl_point_private.h>
 #include <isl_vec_private.h>
+#include <isl_sort.h>
 
 /* Expand the constraint "c" into "v".  The initial "dim" dimensions
  * are the same, but "v" may have more divs than "c" and the divs of "c"
@@ -337,6 +339,8 @@ static int basic_map_collect_diff(__isl_take isl_basic_map *bmap,
 	init = 1;
 
 	while (level >= 0) {
+		if (isl_ctx_check_abort(ctx) < 0)
+			goto error;
 		if (level >= map->n) {
 			int empty;
 			struct isl_basic_map *bm;
@@ -841,9 +845,393 @@ int isl_set_is_subset(struct isl_set *set1, struct isl_set *set2)
 			(struct isl_map *)set1, (struct isl_map *)set2);
 }
 
+/* Check if output dimension "pos" of "bmap" has simple bounds, i.e.,
+ * if the only constraints involving this dimension are
+ * a single constant lower bound and a single constant upper bound
+ * or a single equality that fixes the dimension to a constant value.
+ * If so, store the bounds in "lower" and "upper".
+ * The dimension is also not allowed to appear in any of
+ * the integer division expressions.
+ *
+ * Return 1 if the dimension has simple bounds, 0 if it does not and
+ * -1 on error.
+ */
+static int basic_map_has_simple_bounds(__isl_keep isl_basic_map *bmap,
+	unsigned pos, isl_int *lower, isl_int *upper)
+{
+	int i;
+	int has_lower = 0, has_upper = 0;
+	unsigned total;
+
+	if (!bmap)
+		return -1;
+
+	total = isl_basic_map_total_dim(bmap);
+	pos += isl_basic_map_offset(bmap, isl_dim_out);
+
+	for (i = 0; i < bmap->n_div; ++i)
+		if (!isl_int_is_zero(bmap->div[i][1 + pos]))
+			return 0;
+
+	for (i = 0; i < bmap->n_eq; ++i) {
+		if (isl_int_is_zero(bmap->eq[i][pos]))
+			continue;
+		if (has_lower)
+			return 0;
+		if (!isl_int_is_one(bmap->eq[i][pos]) &&
+		    !isl_int_is_negone(bmap->eq[i][pos]))
+			return 0;
+		if (isl_seq_first_non_zero(bmap->eq[i] + 1, pos - 1) != -1 ||
+		    isl_seq_first_non_zero(bmap->eq[i] + pos + 1,
+						total - pos) != -1)
+			return 0;
+		if (isl_int_is_one(bmap->eq[i][pos]))
+			isl_int_neg(*lower, bmap->eq[i][0]);
+		else
+			isl_int_set(*lower, bmap->eq[i][0]);
+		isl_int_set(*upper, *lower);
+		has_lower = has_upper = 1;
+	}
+
+	for (i = 0; i < bmap->n_ineq; ++i) {
+		if (isl_int_is_zero(bmap->ineq[i][pos]))
+			continue;
+		if (isl_seq_first_non_zero(bmap->ineq[i] + 1, pos - 1) != -1 ||
+		    isl_seq_first_non_zero(bmap->ineq[i] + pos + 1,
+						total - pos) != -1)
+			return 0;
+		if (isl_int_is_one(bmap->ineq[i][pos])) {
+			if (has_lower)
+				return 0;
+			isl_int_neg(*lower, bmap->ineq[i][0]);
+			has_lower = 1;
+		} else if (isl_int_is_negone(bmap->ineq[i][pos])) {
+			if (has_upper)
+				return 0;
+			isl_int_set(*upper, bmap->ineq[i][0]);
+			has_upper = 1;
+		} else
+			return 0;
+	}
+
+	return has_lower && has_upper;
+}
+
+/* Intersect "bmap" with the constraints lower <= x <= upper,
+ * with x output dimension "pos".
+ */
+static __isl_give isl_basic_map *basic_map_add_bounds(
+	__isl_take isl_basic_map *bmap, unsigned pos,
+	isl_int lower, isl_int upper)
+{
+	int k;
+	unsigned total;
+
+	bmap = isl_basic_map_cow(bmap);
+	bmap = isl_basic_map_extend_constraints(bmap, 0, 2);
+	if (!bmap)
+		return NULL;
+	total = isl_basic_map_total_dim(bmap);
+	pos += isl_basic_map_offset(bmap, isl_dim_out);
+
+	k = isl_basic_map_alloc_inequality(bmap);
+	if (k < 0)
+		goto error;
+	isl_seq_clr(bmap->ineq[k], 1 + total);
+	isl_int_set_si(bmap->ineq[k][pos], 1);
+	isl_int_neg(bmap->ineq[k][0], lower);
+
+	k = isl_basic_map_alloc_inequality(bmap);
+	if (k < 0)
+		goto error;
+	isl_seq_clr(bmap->ineq[k], 1 + total);
+	isl_int_set_si(bmap->ineq[k][pos], -1);
+	isl_int_set(bmap->ineq[k][0], upper);
+
+	bmap = isl_basic_map_simplify(bmap);
+	return isl_basic_map_finalize(bmap);
+error:
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
+/* Data used during the sweep in sweep_make_disjoint.
+ *
+ * "n" is the number of disjuncts in the input.
+ * "lower" and "upper" contain the bounds of each disjunct
+ * in the sweep dimension.
+ * "rest" contains each disjunct with the constraints
+ * involving the sweep dimension removed.
+ * "class" maps each disjunct to the first disjunct with the same "rest".
+ * "brk" contains the "n_break" distinct break points of the sweep,
+ * in increasing order, and
+ * "active" contains the class that covers each of the elementary
+ * intervals between consecutive break points, or -1 if the interval
+ * is not covered by any disjunct.
+ */
+struct isl_sweep_data {
+	int n;
+	isl_int *lower;
+	isl_int *upper;
+	isl_basic_map **rest;
+	int *class;
+
+	int n_break;
+	isl_int *brk;
+	int *active;
+};
+
+/* Free all memory allocated for "data".
+ */
+static void sweep_data_clear(struct isl_sweep_data *data)
+{
+	int i;
+
+	if (data->lower && data->upper && data->brk) {
+		for (i = 0; i < data->n; ++i) {
+			isl_int_clear(data->lower[i]);
+			isl_int_clear(data->upper[i]);
+		}
+		for (i = 0; i < 2 * data->n; ++i)
+			isl_int_clear(data->brk[i]);
+	}
+	if (data->rest)
+		for (i = 0; i < data->n; ++i)
+			isl_basic_map_free(data->rest[i]);
+	free(data->lower);
+	free(data->upper);
+	free(data->rest);
+	free(data->class);
+	free(data->brk);
+	free(data->active);
+}
+
+/* isl_sort callback for sorting the break points of the sweep.
+ */
+static int cmp_int(const void *a, const void *b, void *user)
+{
+	const isl_int *i1 = a;
+	const isl_int *i2 = b;
+
+	return isl_int_cmp(*i1, *i2);
+}
+
+/* Sort the break points l_i and u_i + 1 of the disjuncts
+ * and remove duplicates.
+ */
+static int sweep_collect_breaks(struct isl_sweep_data *data)
+{
+	int i;
+
+	for (i = 0; i < data->n; ++i) {
+		isl_int_set(data->brk[2 * i], data->lower[i]);
+		isl_int_add_ui(data->brk[2 * i + 1], data->upper[i], 1);
+	}
+	if (isl_sort(data->brk, 2 * data->n, sizeof(isl_int),
+			&cmp_int, NULL) < 0)
+		return -1;
+	data->n_break = 1;
+	for (i = 1; i < 2 * data->n; ++i)
+		if (isl_int_ne(data->brk[i], data->brk[data->n_break - 1]))
+			isl_int_swap(data->brk[data->n_break++], data->brk[i]);
+
+	return 0;
+}
+
+/* Determine the class that covers each elementary interval
+ * and store it in data->active.
+ * Return 1 if each elementary interval is covered by at most one class,
+ * 0 if some elementary interval is covered by disjuncts
+ * from different classes and -1 on error.
+ *
+ * Since the elementary intervals do not contain any break points
+ * in their interior, a disjunct covers an interval if and only if
+ * it contains the start of the interval.
+ */
+static int sweep_assign_classes(struct isl_sweep_data *data)
+{
+	int i, k;
+
+	for (k = 0; k + 1 < data->n_break; ++k) {
+		data->active[k] = -1;
+		for (i = 0; i < data->n; ++i) {
+			if (isl_int_gt(data->lower[i], data->brk[k]) ||
+			    isl_int_lt(data->upper[i], data->brk[k]))
+				continue;
+			if (data->active[k] < 0)
+				data->active[k] = data->class[i];
+			else if (data->active[k] != data->class[i])
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Add "rest" restricted to the interval "lower" <= x <= "upper"
+ * in output dimension "pos" to "res".
+ */
+static __isl_give isl_map *sweep_add_interval(__isl_take isl_map *res,
+	__isl_keep isl_basic_map *rest, unsigned pos,
+	isl_int lower, isl_int upper)
+{
+	isl_basic_map *bmap;
+
+	bmap = isl_basic_map_copy(rest);
+	bmap = basic_map_add_bounds(bmap, pos, lower, upper);
+	return isl_map_union_disjoint(res, isl_map_from_basic_map(bmap));
+}
+
+/* Try and make the disjuncts of "map" disjoint by sweeping
+ * along output dimension "pos".
+ * This is only possible if each disjunct has simple bounds
+ * in this dimension, i.e., if each disjunct is of the form
+ *
+ *	R_i and l_i <= x <= u_i
+ *
+ * with l_i and u_i constants and R_i not involving x.
+ * Disjuncts with the same R_i are grouped into classes.
+ * The break points l_i and u_i + 1 divide the x axis into
+ * elementary intervals.  If each of those is covered by
+ * disjuncts of at most one class, then the result consists
+ * of the maximal runs of consecutive elementary intervals covered
+ * by the same class, each combined with the R_i of that class.
+ * In particular, overlapping or adjacent intervals with the same R_i
+ * result in a single piece, while the generic algorithm
+ * would split them up.
+ * If disjuncts from different classes overlap, then the sweep
+ * would have to split them up at every break point inside the overlap,
+ * typically resulting in more pieces than the generic algorithm,
+ * so we leave those cases to the generic algorithm.
+ *
+ * Return the result if the sweep could be performed and
+ * NULL with *applied set to 0 if it could not.
+ * On error, NULL is returned with *applied set to 1.
+ */
+static __isl_give isl_map *sweep_make_disjoint(__isl_keep isl_map *map,
+	unsigned pos, int *applied)
+{
+	int i, j, k;
+	int r;
+	isl_ctx *ctx;
+	isl_map *res = NULL;
+	struct isl_sweep_data data = { 0 };
+
+	*applied = 0;
+	ctx = isl_map_get_ctx(map);
+	data.n = map->n;
+	data.lower = isl_alloc_array(ctx, isl_int, map->n);
+	data.upper = isl_alloc_array(ctx, isl_int, map->n);
+	data.brk = isl_alloc_array(ctx, isl_int, 2 * map->n);
+	data.rest = isl_calloc_array(ctx, isl_basic_map *, map->n);
+	data.class = isl_alloc_array(ctx, int, map->n);
+	data.active = isl_alloc_array(ctx, int, 2 * map->n);
+	if (!data.lower || !data.upper || !data.brk) {
+		free(data.lower);
+		free(data.upper);
+		data.lower = data.upper = NULL;
+	} else {
+		for (i = 0; i < map->n; ++i) {
+			isl_int_init(data.lower[i]);
+			isl_int_init(data.upper[i]);
+		}
+		for (i = 0; i < 2 * map->n; ++i)
+			isl_int_init(data.brk[i]);
+	}
+	if (!data.lower || !data.rest || !data.class || !data.active)
+		goto error;
+
+	for (i = 0; i < map->n; ++i) {
+		r = basic_map_has_simple_bounds(map->p[i], pos,
+					&data.lower[i], &data.upper[i]);
+		if (r < 0)
+			goto error;
+		if (!r)
+			goto done;
+	}
+
+	for (i = 0; i < map->n; ++i) {
+		data.rest[i] = isl_basic_map_copy(map->p[i]);
+		data.rest[i] = isl_basic_map_drop_constraints_involving_dims(
+				data.rest[i], isl_dim_out, pos, 1);
+		data.rest[i] = isl_basic_map_normalize(data.rest[i]);
+		if (!data.rest[i])
+			goto error;
+		for (j = 0; j < i; ++j) {
+			if (data.class[j] != j)
+				continue;
+			r = isl_basic_map_plain_is_equal(data.rest[i],
+							data.rest[j]);
+			if (r < 0)
+				goto error;
+			if (r)
+				break;
+		}
+		data.class[i] = j;
+	}
+
+	if (sweep_collect_breaks(&data) < 0)
+		goto error;
+	r = sweep_assign_classes(&data);
+	if (r < 0)
+		goto error;
+	if (!r)
+		goto done;
+
+	*applied = 1;
+	res = isl_map_empty(isl_map_get_space(map));
+	for (k = 0, j = 0; k + 1 < data.n_break; ++k) {
+		if (data.active[k] == data.active[j])
+			continue;
+		if (data.active[j] >= 0) {
+			isl_int_sub_ui(data.brk[k], data.brk[k], 1);
+			res = sweep_add_interval(res, data.rest[data.active[j]],
+					    pos, data.brk[j], data.brk[k]);
+			isl_int_add_ui(data.brk[k], data.brk[k], 1);
+		}
+		j = k;
+	}
+	if (data.active[j] >= 0) {
+		isl_int_sub_ui(data.brk[k], data.brk[k], 1);
+		res = sweep_add_interval(res, data.rest[data.active[j]],
+				    pos, data.brk[j], data.brk[k]);
+	}
+
+done:
+	sweep_data_clear(&data);
+	return res;
+error:
+	sweep_data_clear(&data);
+	*applied = 1;
+	return NULL;
+}
+
+/* Does any of the disjuncts of "map" have rational points?
+ */
+static int map_has_rational_disjunct(__isl_keep isl_map *map)
+{
+	int i;
+
+	for (i = 0; i < map->n; ++i)
+		if (ISL_F_ISSET(map->p[i], ISL_BASIC_MAP_RATIONAL))
+			return 1;
+
+	return 0;
+}
+
+/* Make the disjuncts of "map" disjoint.
+ *
+ * If the disjuncts have simple bounds in any of the output dimensions,
+ * then we sweep along the first such dimension (see sweep_make_disjoint).
+ * The sweep joins adjacent intervals at integer break points,
+ * so it is only performed if none of the disjuncts is rational.
+ * Otherwise, we subtract each disjunct from the union
+ * of the previous disjuncts.
+ */
 __isl_give isl_map *isl_map_make_disjoint(__isl_take isl_map *map)
 {
 	int i;
+	unsigned n_out;
 	struct isl_subtract_diff_collector sdc;
 	sdc.dc.add = &basic_map_subtract_add;
 
@@ -860,6 +1248,20 @@ __isl_give isl_map *isl_map_make_disjoint(__isl_take isl_map *map)
 	if (!map || map->n <= 1)
 		return map;
 
+	n_out = isl_map_dim(map, isl_dim_out);
+	if (map_has_rational_disjunct(map))
+		n_out = 0;
+	for (i = 0; i < n_out; ++i) {
+		int applied;
+		isl_map *res;
+
+		res = sweep_make_disjoint(map, i, &applied);
+		if (!applied)
+			continue;
+		isl_map_free(map);
+		return res;
+	}
+
 	sdc.diff = isl_map_from_basic_map(isl_basic_map_copy(map->p[0]));
 
 	for (i = 1; i < map->n; ++i) {
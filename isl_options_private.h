@@ -13,6 +13,7 @@ struct isl_options {
 	#define			ISL_GBR_ALWAYS	2
 	unsigned		gbr;
 	unsigned		gbr_only_first;
+	unsigned		gbr_precondition;
 
 	#define			ISL_CLOSURE_ISL		0
 	#define			ISL_CLOSURE_BOX		1
@@ -28,6 +29,7 @@ struct isl_options {
 	int			bernstein_triangulate;
 
 	int			pip_symmetry;
+	int			pip_prune;
 
 	#define			ISL_CONVEX_HULL_WRAP	0
 	#define			ISL_CONVEX_HULL_FM	1
@@ -50,6 +52,7 @@ struct isl_options {
 
 	char			*ast_iterator_type;
 	int			ast_always_print_block;
+	int			ast_print_openmp;
 
 	int			ast_build_atomic_upper_bound;
 	int			ast_build_prefer_pdiv;
@@ -60,6 +63,10 @@ struct isl_options {
 	int			ast_build_allow_else;
 	int			ast_build_allow_or;
 
+	int			intern_spaces;
+	int			cache_param_alignments;
+	int			compact;
+
 	int			print_stats;
 	unsigned long		max_operations;
 };
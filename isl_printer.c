@@ -230,6 +230,7 @@ __isl_give isl_printer *isl_printer_to_file(isl_ctx *ctx, FILE *file)
 	p->suffix = NULL;
 	p->width = 0;
 	p->yaml_style = ISL_YAML_STYLE_FLOW;
+	p->omp_parallel = 0;
 
 	return p;
 }
@@ -256,6 +257,7 @@ __isl_give isl_printer *isl_printer_to_str(isl_ctx *ctx)
 	p->suffix = NULL;
 	p->width = 0;
 	p->yaml_style = ISL_YAML_STYLE_FLOW;
+	p->omp_parallel = 0;
 
 	return p;
 error:
@@ -12,6 +12,9 @@ struct isl_printer_ops;
  * yaml_size is the size of this arrays, while yaml_depth
  * is the number of elements currently in use.
  * yaml_state may be NULL if no YAML printing is being performed.
+ *
+ * omp_parallel is set while the body of a for loop that was printed
+ * with an OpenMP "parallel for" pragma is being printed.
  */
 struct isl_printer {
 	struct isl_ctx	*ctx;
@@ -31,4 +34,6 @@ struct isl_printer {
 	int			yaml_depth;
 	int			yaml_size;
 	enum isl_yaml_state	*yaml_state;
+
+	int			omp_parallel;
 };
@@ -189,6 +189,38 @@ __isl_null PW *FN(PW,free)(__isl_take PW *pw)
 	return NULL;
 }
 
+/* Compact the cells of "pw" and, if "pw" is not shared,
+ * drop any room for additional pieces.
+ * The number of bytes saved is recorded in the isl_ctx.
+ */
+__isl_give PW *FN(PW,compact)(__isl_take PW *pw)
+{
+	int i;
+	isl_ctx *ctx;
+	PW *shrunk;
+	size_t n;
+
+	if (!pw)
+		return NULL;
+
+	for (i = 0; i < pw->n; ++i)
+		pw->p[i].set = isl_set_compact(pw->p[i].set);
+
+	if (pw->ref != 1 || pw->size <= 1 || pw->n >= pw->size)
+		return pw;
+
+	ctx = isl_space_get_ctx(pw->dim);
+	n = pw->n ? pw->n : 1;
+	shrunk = isl_realloc(ctx, pw, struct PW,
+			sizeof(struct PW) + (n - 1) * sizeof(S(PW,piece)));
+	if (!shrunk)
+		return pw;
+	ctx->compacted += (shrunk->size - n) * sizeof(S(PW,piece));
+	shrunk->size = n;
+
+	return shrunk;
+}
+
 const char *FN(PW,get_dim_name)(__isl_keep PW *pw, enum isl_dim_type type,
 	unsigned pos)
 {
@@ -0,0 +1,947 @@
+/*
+ * Use of this software is governed by the MIT license
+ */
+
+#include <isl_ctx_private.h>
+#include <isl_map_private.h>
+#include <isl_aff_private.h>
+#include <isl_ast_private.h>
+#include <isl_ast_build_expr.h>
+#include <isl_quast_private.h>
+#include <isl_local_space_private.h>
+#include <isl_mat_private.h>
+#include <isl_point_private.h>
+#include <isl_val_private.h>
+#include <isl_vec_private.h>
+#include <isl_seq.h>
+#include <isl/hash.h>
+
+/* A node in the decision diagram of an isl_quast.
+ *
+ * If "type" is isl_quast_type_if, then "cond" is an affine expression
+ * on the domain of the quast and "child[0]" is evaluated for those
+ * elements where "cond" is non-negative, while "child[1]" is
+ * evaluated for the other elements.
+ * If "type" is isl_quast_type_leaf, then "maff" is the value of
+ * the quast.
+ * If "type" is isl_quast_type_empty, then the quast has no value.
+ *
+ * Nodes may be shared, both within a single decision diagram and
+ * among different quasts.  They should therefore not be modified.
+ * "hash" is a hash value of the node that is used to detect
+ * structurally equal nodes during the construction.
+ */
+struct isl_quast_node {
+	int ref;
+
+	enum isl_quast_type type;
+	uint32_t hash;
+
+	isl_aff *cond;
+	struct isl_quast_node *child[2];
+	isl_multi_aff *maff;
+};
+
+static struct isl_quast_node *node_alloc(isl_ctx *ctx,
+	enum isl_quast_type type)
+{
+	struct isl_quast_node *node;
+
+	node = isl_calloc_type(ctx, struct isl_quast_node);
+	if (!node)
+		return NULL;
+	node->ref = 1;
+	node->type = type;
+
+	return node;
+}
+
+static struct isl_quast_node *node_copy(struct isl_quast_node *node)
+{
+	if (!node)
+		return NULL;
+
+	node->ref++;
+	return node;
+}
+
+static struct isl_quast_node *node_free(struct isl_quast_node *node)
+{
+	if (!node)
+		return NULL;
+
+	if (--node->ref > 0)
+		return NULL;
+
+	isl_aff_free(node->cond);
+	isl_multi_aff_free(node->maff);
+	node_free(node->child[0]);
+	node_free(node->child[1]);
+	free(node);
+
+	return NULL;
+}
+
+/* Return a hash value of the affine expression "aff".
+ */
+static uint32_t aff_get_hash(__isl_keep isl_aff *aff)
+{
+	if (!aff)
+		return 0;
+	return isl_seq_get_hash(aff->v->el, aff->v->size);
+}
+
+/* Compute the hash value of "node", based on the hash values
+ * of its children, if any.
+ */
+static struct isl_quast_node *node_set_hash(struct isl_quast_node *node)
+{
+	int i, n;
+	uint32_t hash;
+
+	if (!node)
+		return NULL;
+
+	hash = isl_hash_init();
+	isl_hash_byte(hash, node->type);
+	if (node->type == isl_quast_type_if) {
+		isl_hash_hash(hash, aff_get_hash(node->cond));
+		isl_hash_hash(hash, node->child[0]->hash);
+		isl_hash_hash(hash, node->child[1]->hash);
+	} else if (node->type == isl_quast_type_leaf) {
+		n = isl_multi_aff_dim(node->maff, isl_dim_out);
+		for (i = 0; i < n; ++i) {
+			isl_aff *aff = isl_multi_aff_get_aff(node->maff, i);
+			isl_hash_hash(hash, aff_get_hash(aff));
+			isl_aff_free(aff);
+		}
+	}
+	node->hash = hash;
+
+	return node;
+}
+
+/* Is the node "entry" in the table of unique nodes
+ * structurally equal to "val"?
+ * Since the children of both nodes are unique, it suffices
+ * to compare them by address.
+ */
+static int node_is_equal(const void *entry, const void *val)
+{
+	const struct isl_quast_node *node1 = entry;
+	const struct isl_quast_node *node2 = val;
+
+	if (node1->type != node2->type)
+		return 0;
+	if (node1->type == isl_quast_type_leaf)
+		return isl_multi_aff_plain_is_equal(node1->maff, node2->maff);
+	if (node1->type != isl_quast_type_if)
+		return 1;
+	if (node1->child[0] != node2->child[0] ||
+	    node1->child[1] != node2->child[1])
+		return 0;
+	return isl_aff_plain_is_equal(node1->cond, node2->cond);
+}
+
+/* An entry on the stack of if nodes that are being constructed
+ * by an isl_quast_builder.
+ * "cond" is the condition of the if node.
+ * "child" contains the children that have been constructed so far,
+ * where a NULL child means that the corresponding branch is infeasible.
+ * "branch" is the branch that is currently being constructed.
+ */
+struct isl_quast_builder_entry {
+	isl_aff *cond;
+	struct isl_quast_node *child[2];
+	int branch;
+};
+
+/* Data structure for incrementally constructing an isl_quast
+ * in depth-first order.
+ *
+ * "table" contains a reference to each of the unique nodes
+ * that have been constructed.
+ * "stack" contains the "n_open" if nodes that are currently
+ * being constructed.
+ * "root" is the root of the decision diagram, once it has been constructed.
+ * "has_root" is set when "root" has been set, even if it is NULL
+ * because the entire domain turned out to be infeasible.
+ */
+struct isl_quast_builder {
+	isl_ctx *ctx;
+	isl_space *space;
+	isl_basic_set *dom;
+
+	struct isl_hash_table *table;
+
+	int n_open;
+	int size;
+	struct isl_quast_builder_entry *stack;
+
+	int has_root;
+	struct isl_quast_node *root;
+};
+
+/* Create an isl_quast_builder for constructing an isl_quast
+ * in the given space, with the given domain.
+ */
+struct isl_quast_builder *isl_quast_builder_alloc(__isl_take isl_space *space,
+	__isl_take isl_basic_set *dom)
+{
+	isl_ctx *ctx;
+	struct isl_quast_builder *builder;
+
+	if (!space || !dom)
+		goto error;
+
+	ctx = isl_space_get_ctx(space);
+	builder = isl_calloc_type(ctx, struct isl_quast_builder);
+	if (!builder)
+		goto error;
+
+	builder->ctx = ctx;
+	isl_ctx_ref(ctx);
+	builder->space = space;
+	builder->dom = dom;
+	builder->table = isl_hash_table_alloc(ctx, 16);
+	if (!builder->table) {
+		isl_quast_builder_free(builder);
+		return NULL;
+	}
+
+	return builder;
+error:
+	isl_space_free(space);
+	isl_basic_set_free(dom);
+	return NULL;
+}
+
+static int free_table_entry(void **entry, void *user)
+{
+	node_free(*entry);
+	return 0;
+}
+
+void isl_quast_builder_free(struct isl_quast_builder *builder)
+{
+	int i;
+
+	if (!builder)
+		return;
+
+	for (i = 0; i < builder->n_open; ++i) {
+		isl_aff_free(builder->stack[i].cond);
+		node_free(builder->stack[i].child[0]);
+		node_free(builder->stack[i].child[1]);
+	}
+	free(builder->stack);
+	if (builder->table)
+		isl_hash_table_foreach(builder->ctx, builder->table,
+					&free_table_entry, NULL);
+	isl_hash_table_free(builder->ctx, builder->table);
+	node_free(builder->root);
+	isl_basic_set_free(builder->dom);
+	isl_space_free(builder->space);
+	isl_ctx_deref(builder->ctx);
+	free(builder);
+}
+
+/* Return the unique node that is structurally equal to "node",
+ * adding "node" to the table of unique nodes if there is no such node yet.
+ */
+static struct isl_quast_node *builder_unique(
+	struct isl_quast_builder *builder, struct isl_quast_node *node)
+{
+	struct isl_hash_table_entry *entry;
+
+	node = node_set_hash(node);
+	if (!node)
+		return NULL;
+
+	entry = isl_hash_table_find(builder->ctx, builder->table, node->hash,
+				    &node_is_equal, node, 1);
+	if (!entry)
+		return node_free(node);
+	if (entry->data) {
+		node_free(node);
+		return node_copy(entry->data);
+	}
+	entry->data = node_copy(node);
+
+	return node;
+}
+
+/* Construct a unique if node with condition "cond" and
+ * children "child0" and "child1".
+ * A NULL child represents an infeasible branch.
+ * If either branch is infeasible or if both branches are the same,
+ * then no test is needed and the other child is returned instead.
+ * If both branches are infeasible, then NULL is returned
+ * (and "error" is not set).
+ */
+static struct isl_quast_node *builder_if(struct isl_quast_builder *builder,
+	__isl_take isl_aff *cond, struct isl_quast_node *child0,
+	struct isl_quast_node *child1, int *error)
+{
+	struct isl_quast_node *node;
+
+	if (!cond)
+		goto error;
+	if (!child0 || !child1 || child0 == child1) {
+		isl_aff_free(cond);
+		if (!child0)
+			return child1;
+		node_free(child1);
+		return child0;
+	}
+
+	node = node_alloc(builder->ctx, isl_quast_type_if);
+	if (!node)
+		goto error;
+	node->cond = cond;
+	node->child[0] = child0;
+	node->child[1] = child1;
+
+	node = builder_unique(builder, node);
+	if (!node)
+		*error = 1;
+	return node;
+error:
+	isl_aff_free(cond);
+	node_free(child0);
+	node_free(child1);
+	*error = 1;
+	return NULL;
+}
+
+/* Attach "node" to the branch that is currently being constructed.
+ * A NULL "node" represents an infeasible branch.
+ */
+static int builder_attach(struct isl_quast_builder *builder,
+	struct isl_quast_node *node)
+{
+	struct isl_quast_builder_entry *entry;
+
+	if (builder->n_open == 0) {
+		if (builder->has_root)
+			goto error;
+		builder->root = node;
+		builder->has_root = 1;
+		return 0;
+	}
+
+	entry = &builder->stack[builder->n_open - 1];
+	if (entry->child[entry->branch])
+		goto error;
+	entry->child[entry->branch] = node;
+
+	return 0;
+error:
+	node_free(node);
+	isl_die(builder->ctx, isl_error_internal,
+		"branch of quast already constructed", return -1);
+}
+
+/* Start the construction of an if node with condition "cond".
+ * The construction continues with the branch where "cond" is non-negative.
+ */
+int isl_quast_builder_split(struct isl_quast_builder *builder,
+	__isl_take isl_aff *cond)
+{
+	struct isl_quast_builder_entry *entry;
+
+	if (!builder || !cond)
+		goto error;
+
+	if (builder->n_open >= builder->size) {
+		int size = 3 * (builder->size + 2) / 2;
+		entry = isl_realloc_array(builder->ctx, builder->stack,
+				    struct isl_quast_builder_entry, size);
+		if (!entry)
+			goto error;
+		builder->stack = entry;
+		builder->size = size;
+	}
+
+	entry = &builder->stack[builder->n_open++];
+	entry->cond = isl_aff_normalize(cond);
+	entry->child[0] = NULL;
+	entry->child[1] = NULL;
+	entry->branch = 0;
+	if (!entry->cond)
+		return -1;
+
+	return 0;
+error:
+	isl_aff_free(cond);
+	return -1;
+}
+
+/* Continue the construction of the innermost open if node
+ * with the branch where the condition is negative.
+ */
+int isl_quast_builder_else(struct isl_quast_builder *builder)
+{
+	if (!builder)
+		return -1;
+	if (builder->n_open == 0)
+		isl_die(builder->ctx, isl_error_internal,
+			"no open if node", return -1);
+
+	builder->stack[builder->n_open - 1].branch = 1;
+
+	return 0;
+}
+
+/* Finish the construction of the innermost open if node and
+ * attach it to its parent.
+ */
+int isl_quast_builder_close(struct isl_quast_builder *builder)
+{
+	struct isl_quast_builder_entry *entry;
+	struct isl_quast_node *node;
+	int error = 0;
+
+	if (!builder)
+		return -1;
+	if (builder->n_open == 0)
+		isl_die(builder->ctx, isl_error_internal,
+			"no open if node", return -1);
+
+	entry = &builder->stack[--builder->n_open];
+	node = builder_if(builder, entry->cond,
+			  entry->child[0], entry->child[1], &error);
+	if (error)
+		return -1;
+
+	return builder_attach(builder, node);
+}
+
+/* Attach a leaf with value "maff" to the branch
+ * that is currently being constructed.
+ */
+int isl_quast_builder_leaf(struct isl_quast_builder *builder,
+	__isl_take isl_multi_aff *maff)
+{
+	struct isl_quast_node *node;
+
+	if (!builder || !maff)
+		goto error;
+
+	node = node_alloc(builder->ctx, isl_quast_type_leaf);
+	if (!node)
+		goto error;
+	node->maff = maff;
+	node = builder_unique(builder, node);
+	if (!node)
+		return -1;
+
+	return builder_attach(builder, node);
+error:
+	isl_multi_aff_free(maff);
+	return -1;
+}
+
+/* Return the unique leaf without value.
+ */
+static struct isl_quast_node *builder_empty(struct isl_quast_builder *builder)
+{
+	struct isl_quast_node *node;
+
+	node = node_alloc(builder->ctx, isl_quast_type_empty);
+	return builder_unique(builder, node);
+}
+
+/* Attach a leaf without value to the branch
+ * that is currently being constructed.
+ */
+int isl_quast_builder_empty(struct isl_quast_builder *builder)
+{
+	struct isl_quast_node *node;
+
+	if (!builder)
+		return -1;
+
+	node = builder_empty(builder);
+	if (!node)
+		return -1;
+
+	return builder_attach(builder, node);
+}
+
+static __isl_give isl_quast *isl_quast_alloc(__isl_take isl_space *space,
+	__isl_take isl_basic_set *dom, struct isl_quast_node *root)
+{
+	isl_quast *quast;
+
+	if (!space || !dom || !root)
+		goto error;
+
+	quast = isl_calloc_type(isl_space_get_ctx(space), isl_quast);
+	if (!quast)
+		goto error;
+
+	quast->ref = 1;
+	quast->space = space;
+	quast->dom = dom;
+	quast->root = root;
+
+	return quast;
+error:
+	isl_space_free(space);
+	isl_basic_set_free(dom);
+	node_free(root);
+	return NULL;
+}
+
+/* Finish the construction of the quast, closing any if nodes
+ * that are still open, and return the result.
+ * If the entire domain turned out to be infeasible,
+ * then the result is an empty quast.
+ */
+__isl_give isl_quast *isl_quast_builder_finish(
+	struct isl_quast_builder *builder)
+{
+	struct isl_quast_node *root;
+
+	if (!builder)
+		return NULL;
+
+	while (builder->n_open > 0)
+		if (isl_quast_builder_close(builder) < 0)
+			return NULL;
+
+	if (!builder->root)
+		builder->root = builder_empty(builder);
+	if (!builder->root)
+		return NULL;
+
+	root = node_copy(builder->root);
+	return isl_quast_alloc(isl_space_copy(builder->space),
+				isl_basic_set_copy(builder->dom), root);
+}
+
+isl_ctx *isl_quast_get_ctx(__isl_keep isl_quast *quast)
+{
+	return quast ? isl_space_get_ctx(quast->space) : NULL;
+}
+
+__isl_give isl_space *isl_quast_get_space(__isl_keep isl_quast *quast)
+{
+	return quast ? isl_space_copy(quast->space) : NULL;
+}
+
+/* Return the domain over which "quast" is defined.
+ */
+__isl_give isl_basic_set *isl_quast_get_domain(__isl_keep isl_quast *quast)
+{
+	return quast ? isl_basic_set_copy(quast->dom) : NULL;
+}
+
+__isl_give isl_quast *isl_quast_copy(__isl_keep isl_quast *quast)
+{
+	if (!quast)
+		return NULL;
+
+	quast->ref++;
+	return quast;
+}
+
+__isl_null isl_quast *isl_quast_free(__isl_take isl_quast *quast)
+{
+	if (!quast)
+		return NULL;
+
+	if (--quast->ref > 0)
+		return NULL;
+
+	isl_space_free(quast->space);
+	isl_basic_set_free(quast->dom);
+	node_free(quast->root);
+	free(quast);
+
+	return NULL;
+}
+
+enum isl_quast_type isl_quast_get_type(__isl_keep isl_quast *quast)
+{
+	return quast ? quast->root->type : isl_quast_type_error;
+}
+
+/* Check that the root of "quast" is an if node.
+ */
+static int check_if(__isl_keep isl_quast *quast)
+{
+	if (!quast)
+		return -1;
+	if (quast->root->type != isl_quast_type_if)
+		isl_die(isl_quast_get_ctx(quast), isl_error_invalid,
+			"not an if node", return -1);
+	return 0;
+}
+
+/* Return the condition of the if node at the root of "quast".
+ * The then branch is taken for those elements of the domain
+ * where this condition is non-negative.
+ */
+__isl_give isl_aff *isl_quast_if_get_cond(__isl_keep isl_quast *quast)
+{
+	if (check_if(quast) < 0)
+		return NULL;
+	return isl_aff_copy(quast->root->cond);
+}
+
+/* Return the basic set of elements where "cond" is non-negative
+ * if "branch" is 0 and negative if "branch" is 1.
+ */
+static __isl_give isl_basic_set *cond_branch(__isl_take isl_aff *cond,
+	int branch)
+{
+	if (branch)
+		return isl_aff_neg_basic_set(cond);
+	return isl_aff_nonneg_basic_set(cond);
+}
+
+/* Return the quast that is evaluated in the given branch
+ * of the if node at the root of "quast".
+ * Its domain is the restriction of the domain of "quast"
+ * to the corresponding side of the condition.
+ */
+static __isl_give isl_quast *if_get_child(__isl_keep isl_quast *quast,
+	int branch)
+{
+	isl_basic_set *dom;
+
+	if (check_if(quast) < 0)
+		return NULL;
+
+	dom = cond_branch(isl_aff_copy(quast->root->cond), branch);
+	dom = isl_basic_set_intersect(isl_basic_set_copy(quast->dom), dom);
+	return isl_quast_alloc(isl_space_copy(quast->space), dom,
+				node_copy(quast->root->child[branch]));
+}
+
+__isl_give isl_quast *isl_quast_if_get_then(__isl_keep isl_quast *quast)
+{
+	return if_get_child(quast, 0);
+}
+
+__isl_give isl_quast *isl_quast_if_get_else(__isl_keep isl_quast *quast)
+{
+	return if_get_child(quast, 1);
+}
+
+/* Return the value of the leaf at the root of "quast".
+ */
+__isl_give isl_multi_aff *isl_quast_leaf_get_multi_aff(
+	__isl_keep isl_quast *quast)
+{
+	if (!quast)
+		return NULL;
+	if (quast->root->type != isl_quast_type_leaf)
+		isl_die(isl_quast_get_ctx(quast), isl_error_invalid,
+			"not a leaf", return NULL);
+	return isl_multi_aff_copy(quast->root->maff);
+}
+
+static int has_node(const void *entry, const void *val)
+{
+	return entry == val;
+}
+
+/* Add "node" and all its descendants that do not appear in "table" yet
+ * to "table" and return the number of added nodes.
+ */
+static int count_nodes(isl_ctx *ctx, struct isl_hash_table *table,
+	struct isl_quast_node *node)
+{
+	struct isl_hash_table_entry *entry;
+	uint32_t hash;
+	int n, n1;
+
+	hash = isl_hash_builtin(isl_hash_init(), node);
+	entry = isl_hash_table_find(ctx, table, hash, &has_node, node, 1);
+	if (!entry)
+		return -1;
+	if (entry->data)
+		return 0;
+	entry->data = node;
+	if (node->type != isl_quast_type_if)
+		return 1;
+	n = count_nodes(ctx, table, node->child[0]);
+	if (n < 0)
+		return -1;
+	n1 = count_nodes(ctx, table, node->child[1]);
+	if (n1 < 0)
+		return -1;
+	return 1 + n + n1;
+}
+
+/* Return the number of distinct nodes in the decision diagram of "quast".
+ * Shared subtrees are only counted once.
+ */
+int isl_quast_n_node(__isl_keep isl_quast *quast)
+{
+	isl_ctx *ctx;
+	struct isl_hash_table *table;
+	int n;
+
+	if (!quast)
+		return -1;
+
+	ctx = isl_quast_get_ctx(quast);
+	table = isl_hash_table_alloc(ctx, 16);
+	if (!table)
+		return -1;
+	n = count_nodes(ctx, table, quast->root);
+	isl_hash_table_free(ctx, table);
+
+	return n;
+}
+
+/* Add the pieces of the function represented by "node" on "dom"
+ * to "pma".
+ */
+static __isl_give isl_pw_multi_aff *add_pieces(
+	__isl_take isl_pw_multi_aff *pma, struct isl_quast_node *node,
+	__isl_take isl_basic_set *dom)
+{
+	int i;
+	isl_pw_multi_aff *piece;
+
+	if (!pma || !dom)
+		goto error;
+
+	if (node->type == isl_quast_type_empty) {
+		isl_basic_set_free(dom);
+		return pma;
+	}
+	if (node->type == isl_quast_type_leaf) {
+		dom = isl_basic_set_simplify(dom);
+		dom = isl_basic_set_finalize(dom);
+		piece = isl_pw_multi_aff_alloc(isl_set_from_basic_set(dom),
+					isl_multi_aff_copy(node->maff));
+		return isl_pw_multi_aff_add_disjoint(pma, piece);
+	}
+
+	for (i = 0; i < 2; ++i) {
+		isl_basic_set *dom_i;
+
+		dom_i = cond_branch(isl_aff_copy(node->cond), i);
+		dom_i = isl_basic_set_intersect(isl_basic_set_copy(dom), dom_i);
+		pma = add_pieces(pma, node->child[i], dom_i);
+	}
+
+	isl_basic_set_free(dom);
+	return pma;
+error:
+	isl_pw_multi_aff_free(pma);
+	isl_basic_set_free(dom);
+	return NULL;
+}
+
+/* Convert "quast" to an isl_pw_multi_aff with a cell for each path
+ * from the root of the decision diagram to a leaf with a value.
+ * The cells are disjoint by construction.
+ */
+__isl_give isl_pw_multi_aff *isl_quast_to_pw_multi_aff(
+	__isl_take isl_quast *quast)
+{
+	isl_pw_multi_aff *pma;
+
+	if (!quast)
+		return NULL;
+
+	pma = isl_pw_multi_aff_empty(isl_space_copy(quast->space));
+	pma = add_pieces(pma, quast->root, isl_basic_set_copy(quast->dom));
+	isl_quast_free(quast);
+
+	return pma;
+}
+
+/* Evaluate "aff" in "pnt".
+ * The values of the integer divisions are computed first,
+ * in order, since each of them may depend on the earlier ones.
+ */
+static __isl_give isl_val *eval_aff(__isl_take isl_aff *aff,
+	__isl_keep isl_point *pnt)
+{
+	int i;
+	unsigned dim, n_div;
+	isl_ctx *ctx;
+	isl_mat *div;
+	isl_vec *v;
+	isl_val *val;
+
+	if (!aff || !pnt)
+		goto error;
+
+	ctx = isl_aff_get_ctx(aff);
+	div = aff->ls->div;
+	dim = pnt->vec->size - 1;
+	n_div = div->n_row;
+	v = isl_vec_alloc(ctx, 1 + dim + n_div);
+	if (!v)
+		goto error;
+	isl_seq_cpy(v->el, pnt->vec->el, 1 + dim);
+	for (i = 0; i < n_div; ++i) {
+		if (isl_int_is_zero(div->row[i][0]))
+			isl_die(ctx, isl_error_invalid,
+				"unknown div", goto error_v);
+		isl_seq_inner_product(div->row[i] + 1, v->el, 1 + dim + i,
+					&v->el[1 + dim + i]);
+		isl_int_fdiv_q(v->el[1 + dim + i], v->el[1 + dim + i],
+				div->row[i][0]);
+	}
+	isl_seq_inner_product(aff->v->el + 1, v->el, v->size, &v->el[0]);
+	val = isl_val_rat_from_isl_int(ctx, v->el[0], aff->v->el[0]);
+	val = isl_val_normalize(val);
+
+	isl_vec_free(v);
+	isl_aff_free(aff);
+	return val;
+error_v:
+	isl_vec_free(v);
+error:
+	isl_aff_free(aff);
+	return NULL;
+}
+
+/* Evaluate "quast" in "pnt", returning a NaN value for each output
+ * dimension if "pnt" does not lie in the domain of "quast" or
+ * if "quast" has no value in "pnt".
+ * Only a single path from the root of the decision diagram
+ * is traversed.
+ */
+__isl_give isl_multi_val *isl_quast_eval(__isl_take isl_quast *quast,
+	__isl_take isl_point *pnt)
+{
+	int i, n;
+	int in_dom, equal;
+	isl_ctx *ctx;
+	isl_space *space;
+	isl_multi_val *mv;
+	struct isl_quast_node *node;
+
+	if (!quast || !pnt)
+		goto error;
+
+	ctx = isl_quast_get_ctx(quast);
+	space = isl_point_get_space(pnt);
+	equal = isl_space_is_equal(space, quast->dom->dim);
+	isl_space_free(space);
+	if (equal < 0)
+		goto error;
+	if (!equal)
+		isl_die(ctx, isl_error_invalid,
+			"incompatible spaces", goto error);
+
+	in_dom = !isl_point_is_void(pnt);
+	if (in_dom)
+		in_dom = isl_basic_map_contains_point(
+				(isl_basic_map *) quast->dom, pnt);
+	if (in_dom < 0)
+		goto error;
+
+	node = quast->root;
+	while (in_dom && node->type == isl_quast_type_if) {
+		isl_val *v;
+		int neg;
+
+		v = eval_aff(isl_aff_copy(node->cond), pnt);
+		neg = isl_val_is_neg(v);
+		isl_val_free(v);
+		if (neg < 0)
+			goto error;
+		node = node->child[neg];
+	}
+
+	space = isl_space_range(isl_space_copy(quast->space));
+	mv = isl_multi_val_zero(space);
+	n = isl_multi_val_dim(mv, isl_dim_set);
+	for (i = 0; i < n; ++i) {
+		isl_val *v;
+
+		if (in_dom && node->type == isl_quast_type_leaf)
+			v = eval_aff(isl_multi_aff_get_aff(node->maff, i), pnt);
+		else
+			v = isl_val_nan(ctx);
+		mv = isl_multi_val_set_val(mv, i, v);
+	}
+
+	isl_quast_free(quast);
+	isl_point_free(pnt);
+	return mv;
+error:
+	isl_quast_free(quast);
+	isl_point_free(pnt);
+	return NULL;
+}
+
+/* Construct an AST node that executes the call specified by the leaves
+ * of the decision diagram rooted at "node", guarded by the conditions
+ * on the paths to these leaves.
+ * A leaf without value is represented by an empty block.
+ * If only the second child of an if node has a value, then
+ * the negated condition is used such that no empty then branch
+ * needs to be printed.
+ */
+static __isl_give isl_ast_node *node_from_quast_node(
+	__isl_keep isl_ast_build *build, struct isl_quast_node *node)
+{
+	isl_ctx *ctx;
+	isl_basic_set *bset;
+	isl_pw_multi_aff *pma;
+	isl_ast_expr *expr;
+	isl_ast_node *tree;
+	int branch;
+
+	ctx = isl_ast_build_get_ctx(build);
+	if (node->type == isl_quast_type_empty)
+		return isl_ast_node_alloc_block(isl_ast_node_list_alloc(ctx, 0));
+	if (node->type == isl_quast_type_leaf) {
+		pma = isl_pw_multi_aff_from_multi_aff(
+						isl_multi_aff_copy(node->maff));
+		expr = isl_ast_build_call_from_pw_multi_aff(build, pma);
+		return isl_ast_node_alloc_user(expr);
+	}
+
+	branch = node->child[0]->type == isl_quast_type_empty;
+	if (branch)
+		bset = isl_aff_neg_basic_set(isl_aff_copy(node->cond));
+	else
+		bset = isl_aff_nonneg_basic_set(isl_aff_copy(node->cond));
+	expr = isl_ast_build_expr_from_set(build, isl_set_from_basic_set(bset));
+	tree = isl_ast_node_alloc_if(expr);
+	tree = isl_ast_node_if_set_then(tree,
+			    node_from_quast_node(build, node->child[branch]));
+	if (branch || node->child[1]->type == isl_quast_type_empty)
+		return tree;
+	return isl_ast_node_if_set_else(tree,
+			    node_from_quast_node(build, node->child[1]));
+}
+
+/* Construct an AST that evaluates "quast" for elements
+ * in its domain, which is assumed to live in the schedule space
+ * of "build".
+ * Each leaf with a value is turned into a call, with the name
+ * of the function obtained from the output tuple name of "quast" and
+ * the arguments given by the affine expressions of the leaf.
+ * Leaves that are shared by several paths in the decision diagram
+ * appear in the AST once for each of these paths.
+ */
+__isl_give isl_ast_node *isl_ast_build_node_from_quast(
+	__isl_keep isl_ast_build *build, __isl_take isl_quast *quast)
+{
+	isl_ast_node *node;
+
+	if (!build || !quast)
+		goto error;
+
+	node = node_from_quast_node(build, quast->root);
+	isl_quast_free(quast);
+	return node;
+error:
+	isl_quast_free(quast);
+	return NULL;
+}
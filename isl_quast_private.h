@@ -0,0 +1,39 @@
+#ifndef ISL_QUAST_PRIVATE_H
+#define ISL_QUAST_PRIVATE_H
+
+#include <isl/quast.h>
+
+struct isl_quast_node;
+
+/* A quasi-affine selection tree, represented as a decision diagram
+ * with possibly shared subtrees.
+ *
+ * "space" is the space of the function represented by the quast.
+ * "dom" is the domain over which the decision diagram "root" is defined.
+ * The space of "dom" is equal to the domain of "space".
+ */
+struct isl_quast {
+	int ref;
+
+	isl_space *space;
+	isl_basic_set *dom;
+	struct isl_quast_node *root;
+};
+
+struct isl_quast_builder;
+
+struct isl_quast_builder *isl_quast_builder_alloc(__isl_take isl_space *space,
+	__isl_take isl_basic_set *dom);
+void isl_quast_builder_free(struct isl_quast_builder *builder);
+
+int isl_quast_builder_split(struct isl_quast_builder *builder,
+	__isl_take isl_aff *cond);
+int isl_quast_builder_else(struct isl_quast_builder *builder);
+int isl_quast_builder_close(struct isl_quast_builder *builder);
+int isl_quast_builder_leaf(struct isl_quast_builder *builder,
+	__isl_take isl_multi_aff *maff);
+int isl_quast_builder_empty(struct isl_quast_builder *builder);
+__isl_give isl_quast *isl_quast_builder_finish(
+	struct isl_quast_builder *builder);
+
+#endif
@@ -10,6 +10,7 @@
 
 #include <isl_ctx_private.h>
 #include <isl_space_private.h>
+#include <isl_options_private.h>
 #include <isl_reordering.h>
 
 __isl_give isl_reordering *isl_reordering_alloc(isl_ctx *ctx, int len)
@@ -87,7 +88,7 @@ void *isl_reordering_free(__isl_take isl_reordering *exp)
  * that has the parameters of "aligner" first, followed by
  * any remaining parameters of "alignee" that do not occur in "aligner".
  */
-__isl_give isl_reordering *isl_parameter_alignment_reordering(
+static __isl_give isl_reordering *parameter_alignment_reordering(
 	__isl_keep isl_space *alignee, __isl_keep isl_space *aligner)
 {
 	int i, j;
@@ -136,6 +137,132 @@ error:
 	return NULL;
 }
 
+/* Move the entry at position "pos" of the reordering cache of "ctx"
+ * to the front of the cache.
+ */
+static void move_to_front(isl_ctx *ctx, int pos)
+{
+	struct isl_reordering_cache entry;
+
+	entry = ctx->reordering_cache[pos];
+	for (; pos > 0; --pos)
+		ctx->reordering_cache[pos] = ctx->reordering_cache[pos - 1];
+	ctx->reordering_cache[0] = entry;
+}
+
+/* Look for a reordering in the cache of "ctx" that aligns
+ * parameters identical to those of "alignee" to parameters
+ * identical to those of "aligner".
+ * If one is found, it is moved to the front of the cache and
+ * a copy is returned.
+ */
+static __isl_give isl_reordering *cache_find(isl_ctx *ctx,
+	__isl_keep isl_space *alignee, __isl_keep isl_space *aligner)
+{
+	int i;
+
+	for (i = 0; i < ctx->n_reordering_cached; ++i) {
+		struct isl_reordering_cache *entry = &ctx->reordering_cache[i];
+
+		if (isl_space_match(entry->aligner, isl_dim_param,
+				    aligner, isl_dim_param) <= 0)
+			continue;
+		if (isl_space_match(entry->alignee, isl_dim_param,
+				    alignee, isl_dim_param) <= 0)
+			continue;
+		move_to_front(ctx, i);
+		return isl_reordering_copy(ctx->reordering_cache[0].exp);
+	}
+
+	return NULL;
+}
+
+/* Add "exp", the reordering that aligns the parameters of "alignee"
+ * to those of "aligner", to the front of the cache of "ctx",
+ * evicting the least recently used entry if the cache is full.
+ */
+static void cache_add(isl_ctx *ctx, __isl_keep isl_space *alignee,
+	__isl_keep isl_space *aligner, __isl_keep isl_reordering *exp)
+{
+	int pos;
+	struct isl_reordering_cache *entry;
+
+	if (ctx->n_reordering_cached < ISL_REORDERING_CACHE_SIZE)
+		pos = ctx->n_reordering_cached++;
+	else
+		pos = ISL_REORDERING_CACHE_SIZE - 1;
+	entry = &ctx->reordering_cache[pos];
+	isl_space_free(entry->alignee);
+	isl_space_free(entry->aligner);
+	isl_reordering_free(entry->exp);
+	entry->alignee = isl_space_params(isl_space_copy(alignee));
+	entry->aligner = isl_space_copy(aligner);
+	entry->exp = isl_reordering_copy(exp);
+	move_to_front(ctx, pos);
+}
+
+/* Construct a reordering that maps the parameters of "alignee"
+ * to the corresponding parameters in a new dimension specification
+ * that has the parameters of "aligner" first, followed by
+ * any remaining parameters of "alignee" that do not occur in "aligner".
+ *
+ * The same parameter alignments tend to be computed over and over again,
+ * so if the cache_param_alignments option is set, then recently
+ * constructed reorderings are kept in a cache in the isl_ctx.
+ * Since only the parameters of "alignee" are taken into account,
+ * only reorderings where "aligner" is a parameter space are cached.
+ * Otherwise, the result would depend on more than just
+ * the parameters of "aligner".
+ * The cache holds references to the parameter identifiers, so
+ * it is cleared as soon as a parameter alignment is computed
+ * while the option is not set.
+ */
+__isl_give isl_reordering *isl_parameter_alignment_reordering(
+	__isl_keep isl_space *alignee, __isl_keep isl_space *aligner)
+{
+	isl_ctx *ctx;
+	isl_reordering *exp;
+
+	if (!alignee || !aligner)
+		return NULL;
+
+	ctx = isl_space_get_ctx(alignee);
+	if (!ctx->opt->cache_param_alignments) {
+		isl_reordering_clear_cache(ctx);
+		return parameter_alignment_reordering(alignee, aligner);
+	}
+	if (!isl_space_is_params(aligner))
+		return parameter_alignment_reordering(alignee, aligner);
+
+	exp = cache_find(ctx, alignee, aligner);
+	if (exp)
+		return exp;
+
+	exp = parameter_alignment_reordering(alignee, aligner);
+	if (exp)
+		cache_add(ctx, alignee, aligner, exp);
+	return exp;
+}
+
+/* Free all reorderings in the cache of "ctx".
+ */
+void isl_reordering_clear_cache(isl_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ctx->n_reordering_cached; ++i) {
+		struct isl_reordering_cache *entry = &ctx->reordering_cache[i];
+
+		isl_space_free(entry->alignee);
+		isl_space_free(entry->aligner);
+		isl_reordering_free(entry->exp);
+		entry->alignee = NULL;
+		entry->aligner = NULL;
+		entry->exp = NULL;
+	}
+	ctx->n_reordering_cached = 0;
+}
+
 __isl_give isl_reordering *isl_reordering_extend(__isl_take isl_reordering *exp,
 	unsigned extra)
 {
@@ -23,6 +23,7 @@ __isl_give isl_reordering *isl_parameter_alignment_reordering(
 	__isl_keep isl_space *alignee, __isl_keep isl_space *aligner);
 __isl_give isl_reordering *isl_reordering_copy(__isl_keep isl_reordering *exp);
 void *isl_reordering_free(__isl_take isl_reordering *exp);
+void isl_reordering_clear_cache(isl_ctx *ctx);
 __isl_give isl_reordering *isl_reordering_extend_space(
 	__isl_take isl_reordering *exp, __isl_take isl_space *dim);
 __isl_give isl_reordering *isl_reordering_extend(__isl_take isl_reordering *exp,
@@ -1115,6 +1115,92 @@ error:
 	return NULL;
 }
 
+/* Does variable "pos" of "bset" appear in any of its constraints?
+ */
+static int is_involved(__isl_keep isl_basic_set *bset, int pos)
+{
+	int i;
+
+	for (i = 0; i < bset->n_eq; ++i)
+		if (!isl_int_is_zero(bset->eq[i][1 + pos]))
+			return 1;
+	for (i = 0; i < bset->n_ineq; ++i)
+		if (!isl_int_is_zero(bset->ineq[i][1 + pos]))
+			return 1;
+
+	return 0;
+}
+
+/* Does "bset" have any variables that do not appear in any constraint?
+ */
+static int has_unused(__isl_keep isl_basic_set *bset)
+{
+	int i;
+	unsigned dim;
+
+	dim = isl_basic_set_n_dim(bset);
+	for (i = 0; i < dim; ++i)
+		if (!is_involved(bset, i))
+			return 1;
+
+	return 0;
+}
+
+static struct isl_vec *basic_set_sample(struct isl_basic_set *bset,
+	int bounded);
+
+/* Compute a sample point of "bset", some of the variables of which
+ * do not appear in any constraint.
+ * These variables are dropped before computing a sample point
+ * of the remaining set and are then set to zero in the result.
+ * This avoids having to deal with the corresponding directions
+ * of the recession cone in the main computation.
+ */
+static __isl_give isl_vec *sample_drop_unused(__isl_take isl_basic_set *bset,
+	int bounded)
+{
+	int i, j;
+	unsigned dim;
+	isl_vec *sample, *reduced_sample;
+	isl_basic_set *reduced;
+
+	dim = isl_basic_set_n_dim(bset);
+	reduced = isl_basic_set_copy(bset);
+	for (i = dim - 1; i >= 0; --i)
+		if (!is_involved(bset, i))
+			reduced = isl_basic_set_drop(reduced, isl_dim_set, i, 1);
+	reduced_sample = basic_set_sample(reduced, bounded);
+	if (!reduced_sample || reduced_sample->size == 0) {
+		isl_basic_set_free(bset);
+		return reduced_sample;
+	}
+
+	sample = isl_vec_alloc(bset->ctx, 1 + dim);
+	if (!sample)
+		goto error;
+	isl_int_set(sample->el[0], reduced_sample->el[0]);
+	for (i = 0, j = 0; i < dim; ++i) {
+		if (is_involved(bset, i))
+			isl_int_set(sample->el[1 + i], reduced_sample->el[1 + j++]);
+		else
+			isl_int_set_si(sample->el[1 + i], 0);
+	}
+
+	isl_vec_free(reduced_sample);
+	isl_basic_set_free(bset);
+	return sample;
+error:
+	isl_vec_free(reduced_sample);
+	isl_basic_set_free(bset);
+	return NULL;
+}
+
+/* Compute a sample point of "bset", where "bset" is known to be bounded
+ * if "bounded" is set.
+ *
+ * If some of the variables do not appear in any constraint,
+ * then we drop them in sample_drop_unused.
+ */
 static struct isl_vec *basic_set_sample(struct isl_basic_set *bset, int bounded)
 {
 	struct isl_ctx *ctx;
@@ -1151,6 +1237,9 @@ static struct isl_vec *basic_set_sample(struct isl_basic_set *bset, int bounded)
 	if (dim == 1)
 		return interval_sample(bset);
 
+	if (!bounded && has_unused(bset))
+		return sample_drop_unused(bset, bounded);
+
 	return bounded ? sample_bounded(bset) : gbr_sample(bset);
 error:
 	isl_basic_set_free(bset);
@@ -95,6 +95,19 @@ __isl_give isl_schedule *isl_schedule_copy(__isl_keep isl_schedule *sched)
 	return sched;
 }
 
+/* Compact the sets and functions in the schedule tree of "schedule".
+ * The number of bytes saved is recorded in the isl_ctx.
+ */
+__isl_give isl_schedule *isl_schedule_compact(__isl_take isl_schedule *schedule)
+{
+	if (!schedule)
+		return NULL;
+
+	schedule->root = isl_schedule_tree_compact(schedule->root);
+
+	return schedule;
+}
+
 /* Return an isl_schedule that is equal to "schedule" and that has only
  * a single reference.
  *
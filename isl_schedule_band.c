@@ -11,6 +11,7 @@
  */
 
 #include <isl/schedule_node.h>
+#include <isl_aff_private.h>
 #include <isl_schedule_band.h>
 #include <isl_schedule_private.h>
 
@@ -115,6 +116,26 @@ __isl_give isl_schedule_band *isl_schedule_band_cow(
 	return isl_schedule_band_dup(band);
 }
 
+/* Compact the partial schedule of "band".
+ * Since this does not change the meaning of "band",
+ * the partial schedule is modified in place, even if it is shared.
+ */
+__isl_give isl_schedule_band *isl_schedule_band_compact(
+	__isl_take isl_schedule_band *band)
+{
+	int i;
+	isl_multi_union_pw_aff *mupa;
+
+	if (!band)
+		return NULL;
+
+	mupa = band->mupa;
+	for (i = 0; i < mupa->n; ++i)
+		mupa->p[i] = isl_union_pw_aff_compact(mupa->p[i]);
+
+	return band;
+}
+
 /* Return a new reference to "band".
  */
 __isl_give isl_schedule_band *isl_schedule_band_copy(
@@ -31,6 +31,8 @@ __isl_give isl_schedule_band *isl_schedule_band_copy(
 	__isl_keep isl_schedule_band *band);
 __isl_null isl_schedule_band *isl_schedule_band_free(
 	__isl_take isl_schedule_band *band);
+__isl_give isl_schedule_band *isl_schedule_band_compact(
+	__isl_take isl_schedule_band *band);
 
 isl_ctx *isl_schedule_band_get_ctx(__isl_keep isl_schedule_band *band);
 
@@ -183,6 +183,46 @@ __isl_null isl_schedule_tree *isl_schedule_tree_free(
 	return NULL;
 }
 
+/* Compact the sets and functions in "tree" and its descendants,
+ * as well as the list of children.
+ * Since this does not change the meaning of "tree",
+ * the tree is modified in place, even if it is shared.
+ */
+__isl_give isl_schedule_tree *isl_schedule_tree_compact(
+	__isl_take isl_schedule_tree *tree)
+{
+	int i;
+
+	if (!tree || tree->ref < 0)
+		return tree;
+
+	switch (tree->type) {
+	case isl_schedule_node_band:
+		tree->band = isl_schedule_band_compact(tree->band);
+		break;
+	case isl_schedule_node_domain:
+		tree->domain = isl_union_set_compact(tree->domain);
+		break;
+	case isl_schedule_node_filter:
+		tree->filter = isl_union_set_compact(tree->filter);
+		break;
+	case isl_schedule_node_sequence:
+	case isl_schedule_node_set:
+	case isl_schedule_node_error:
+	case isl_schedule_node_leaf:
+		break;
+	}
+
+	if (!tree->children)
+		return tree;
+	for (i = 0; i < tree->children->n; ++i)
+		tree->children->p[i] =
+			isl_schedule_tree_compact(tree->children->p[i]);
+	tree->children = isl_schedule_tree_list_compact(tree->children);
+
+	return tree;
+}
+
 /* Create and return a new leaf schedule tree.
  */
 __isl_give isl_schedule_tree *isl_schedule_tree_leaf(isl_ctx *ctx)
@@ -4192,6 +4192,116 @@ error:
 	return NULL;
 }
 
+/* Copy the scheduling options of "src" to "dst".
+ */
+static void copy_schedule_options(struct isl_options *dst,
+	struct isl_options *src)
+{
+	dst->schedule_max_coefficient = src->schedule_max_coefficient;
+	dst->schedule_max_constant_term = src->schedule_max_constant_term;
+	dst->schedule_parametric = src->schedule_parametric;
+	dst->schedule_outer_coincidence = src->schedule_outer_coincidence;
+	dst->schedule_maximize_band_depth = src->schedule_maximize_band_depth;
+	dst->schedule_split_scaled = src->schedule_split_scaled;
+	dst->schedule_separate_components = src->schedule_separate_components;
+	dst->schedule_algorithm = src->schedule_algorithm;
+	dst->schedule_fuse = src->schedule_fuse;
+}
+
+/* Compute a schedule for "sc" for each of "n" variants of
+ * the scheduling options and return the one with the highest score.
+ *
+ * Before the schedule for variant "i" is computed, "set_options"
+ * is called on the isl_ctx and "i" to adjust the scheduling options.
+ * The scheduling options are restored after each variant.
+ * If "max_operations" is not zero, then the computation for each variant
+ * is limited to this many operations, on top of any limit
+ * that has been set on the isl_ctx.  A variant that runs out
+ * of operations is abandoned and does not take part in the selection.
+ * The remaining schedules are compared using "score", where higher
+ * values are better.  In case of a tie, the earliest variant wins.
+ *
+ * Since the schedules are computed within the same isl_ctx,
+ * the variants are handled one after the other.
+ */
+__isl_give isl_schedule *isl_schedule_constraints_compute_best_schedule(
+	__isl_take isl_schedule_constraints *sc, int n,
+	int (*set_options)(isl_ctx *ctx, int i, void *user),
+	double (*score)(__isl_keep isl_schedule *schedule, void *user),
+	unsigned long max_operations, void *user)
+{
+	int i;
+	isl_ctx *ctx;
+	struct isl_options saved;
+	unsigned long max;
+	isl_schedule *best = NULL;
+	double best_score = 0;
+
+	if (!sc)
+		return NULL;
+
+	ctx = isl_schedule_constraints_get_ctx(sc);
+	if (n <= 0)
+		isl_die(ctx, isl_error_invalid, "no option variants specified",
+			goto error);
+	if (!set_options || !score)
+		isl_die(ctx, isl_error_invalid, "missing callback",
+			goto error);
+
+	copy_schedule_options(&saved, ctx->opt);
+	max = ctx->max_operations;
+	for (i = 0; i < n; ++i) {
+		isl_schedule *schedule;
+		unsigned long limit = max;
+		int cancelled;
+		double s;
+
+		if (set_options(ctx, i, user) < 0) {
+			copy_schedule_options(ctx->opt, &saved);
+			goto error;
+		}
+		if (max_operations) {
+			limit = ctx->operations + max_operations;
+			if (max && max < limit)
+				limit = max;
+		}
+		ctx->max_operations = limit;
+		schedule = isl_schedule_constraints_compute_schedule(
+					isl_schedule_constraints_copy(sc));
+		ctx->max_operations = max;
+		copy_schedule_options(ctx->opt, &saved);
+		cancelled = limit && limit != max && ctx->operations >= limit;
+		if (cancelled) {
+			isl_schedule_free(schedule);
+			if (isl_ctx_last_error(ctx) == isl_error_quota)
+				isl_ctx_reset_error(ctx);
+			continue;
+		}
+		if (!schedule)
+			goto error;
+
+		s = score(schedule, user);
+		if (best && s <= best_score) {
+			isl_schedule_free(schedule);
+			continue;
+		}
+		isl_schedule_free(best);
+		best = schedule;
+		best_score = s;
+	}
+
+	isl_schedule_constraints_free(sc);
+	if (!best)
+		isl_die(ctx, isl_error_quota,
+			"no variant completed within the operation limit",
+			return NULL);
+	return best;
+error:
+	isl_schedule_free(best);
+	isl_schedule_constraints_free(sc);
+	return NULL;
+}
+
 /* Compute a schedule for the given union of domains that respects
  * all the validity dependences and minimizes
  * the dependence distances over the proximity dependences.
@@ -209,6 +209,18 @@ int isl_seq_last_non_zero(isl_int *p, unsigned len)
 	return -1;
 }
 
+/* Return the number of non-zero elements in "p" of length "len".
+ */
+int isl_seq_n_non_zero(isl_int *p, unsigned len)
+{
+	int i, n = 0;
+
+	for (i = 0; i < len; ++i)
+		if (!isl_int_is_zero(p[i]))
+			++n;
+	return n;
+}
+
 void isl_seq_abs_max(isl_int *p, unsigned len, isl_int *max)
 {
 	int i;
@@ -14,6 +14,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <isl_ctx_private.h>
+#include <isl_options_private.h>
 #include <isl_space_private.h>
 #include <isl_id_private.h>
 #include <isl_reordering.h>
@@ -48,6 +50,13 @@ __isl_give isl_space *isl_space_alloc(isl_ctx *ctx,
 	dim->n_id = 0;
 	dim->ids = NULL;
 
+	dim->interned = 0;
+	dim->reverse = NULL;
+	dim->domain = NULL;
+	dim->range = NULL;
+	dim->join_right = NULL;
+	dim->join = NULL;
+
 	return dim;
 }
 
@@ -364,6 +373,146 @@ __isl_null isl_space *isl_space_free(__isl_take isl_space *space)
 	return NULL;
 }
 
+/* Are "space1" and "space2" identical, i.e., do they have
+ * the same dimensions and the same (pointers to) identifiers,
+ * including those of the input and output dimensions?
+ * This is a stricter test than isl_space_is_equal,
+ * which ignores the identifiers of input and output dimensions.
+ */
+static int space_is_identical(__isl_keep isl_space *space1,
+	__isl_keep isl_space *space2)
+{
+	int i;
+	unsigned total;
+
+	if (space1 == space2)
+		return 1;
+	if (!space1 || !space2)
+		return 0;
+	if (space1->nparam != space2->nparam ||
+	    space1->n_in != space2->n_in || space1->n_out != space2->n_out)
+		return 0;
+	if (space1->tuple_id[0] != space2->tuple_id[0] ||
+	    space1->tuple_id[1] != space2->tuple_id[1])
+		return 0;
+	if (!space_is_identical(space1->nested[0], space2->nested[0]) ||
+	    !space_is_identical(space1->nested[1], space2->nested[1]))
+		return 0;
+	total = space1->nparam + space1->n_in + space1->n_out;
+	for (i = 0; i < total; ++i) {
+		isl_id *id1 = i < space1->n_id ? space1->ids[i] : NULL;
+		isl_id *id2 = i < space2->n_id ? space2->ids[i] : NULL;
+		if (id1 != id2)
+			return 0;
+	}
+
+	return 1;
+}
+
+static int has_identical_space(const void *entry, const void *val)
+{
+	return space_is_identical((isl_space *) entry, (isl_space *) val);
+}
+
+/* Return the interned version of "space", i.e., the unique space
+ * in the space table of the isl_ctx that is identical to "space",
+ * adding "space" itself to the table if there is no such space yet.
+ * The table keeps a reference to each of its spaces such that
+ * an interned space is never modified in place by isl_space_cow.
+ *
+ * Spaces are only interned if the intern_spaces option is set.
+ */
+static __isl_give isl_space *space_intern(__isl_take isl_space *space)
+{
+	isl_ctx *ctx;
+	uint32_t hash;
+	struct isl_hash_table_entry *entry;
+
+	if (!space || space->interned)
+		return space;
+	ctx = space->ctx;
+	if (!ctx->opt->intern_spaces)
+		return space;
+
+	hash = isl_space_get_hash(space);
+	entry = isl_hash_table_find(ctx, &ctx->space_table, hash,
+					&has_identical_space, space, 1);
+	if (!entry)
+		return isl_space_free(space);
+	if (entry->data) {
+		isl_space_free(space);
+		return isl_space_copy(entry->data);
+	}
+	space->interned = 1;
+	entry->data = isl_space_copy(space);
+	return space;
+}
+
+/* Apply "derive" to "space" and intern the result.
+ * If "space" is itself interned, then the result is cached in "*memo"
+ * such that the result can be reused the next time "derive"
+ * is applied to "space".
+ * Since both "space" and the cached result are kept alive
+ * by the space table, the cache does not hold a reference.
+ */
+static __isl_give isl_space *space_derive(__isl_take isl_space *space,
+	isl_space **memo,
+	__isl_give isl_space *(*derive)(__isl_take isl_space *space))
+{
+	isl_space *res;
+
+	if (!space)
+		return NULL;
+	if (!space->interned)
+		return space_intern(derive(space));
+
+	if (*memo) {
+		res = isl_space_copy(*memo);
+	} else {
+		res = space_intern(derive(isl_space_copy(space)));
+		if (res && res->interned)
+			*memo = res;
+	}
+	isl_space_free(space);
+	return res;
+}
+
+/* Drop the reference held by the space table on the space in "entry".
+ * The space may still be referenced elsewhere and may then
+ * get modified in place, so the results cached in the space
+ * are no longer valid.  They do not hold a reference
+ * (see space_derive), so they can simply be forgotten.
+ */
+static int free_interned(void **entry, void *user)
+{
+	isl_space *space = *entry;
+
+	space->interned = 0;
+	space->reverse = NULL;
+	space->domain = NULL;
+	space->range = NULL;
+	space->join_right = NULL;
+	space->join = NULL;
+	isl_space_free(space);
+	*entry = NULL;
+
+	return 0;
+}
+
+/* Release the references held by the space table of "ctx".
+ * The spaces in the table keep a reference to "ctx", so this
+ * needs to be called before "ctx" can be freed.
+ * Since free_interned removes every entry from the table,
+ * the table itself can be kept at its current size.
+ */
+void isl_space_clear_interned(isl_ctx *ctx)
+{
+	if (!ctx || ctx->space_table.n == 0)
+		return;
+	isl_hash_table_foreach(ctx, &ctx->space_table, &free_interned, NULL);
+	ctx->space_table.n = 0;
+}
+
 /* Check if "s" is a valid dimension or tuple name.
  * We currently only forbid names that look like a number.
  *
@@ -1129,7 +1278,7 @@ error:
 	return NULL;
 }
 
-__isl_give isl_space *isl_space_join(__isl_take isl_space *left,
+static __isl_give isl_space *space_join(__isl_take isl_space *left,
 	__isl_take isl_space *right)
 {
 	isl_space *dim;
@@ -1174,6 +1323,35 @@ error:
 	return NULL;
 }
 
+/* Construct the space of the composition of "left" and "right".
+ *
+ * If both arguments are interned, then the (interned) result
+ * is remembered in "left" for the case where "left" is joined
+ * with the same "right" again.  Only the most recent join is kept.
+ */
+__isl_give isl_space *isl_space_join(__isl_take isl_space *left,
+	__isl_take isl_space *right)
+{
+	isl_space *res;
+
+	if (!left || !right || !left->interned || !right->interned)
+		return space_intern(space_join(left, right));
+
+	if (left->join_right == right) {
+		res = isl_space_copy(left->join);
+	} else {
+		res = space_intern(space_join(isl_space_copy(left),
+						isl_space_copy(right)));
+		if (res && res->interned) {
+			left->join_right = right;
+			left->join = res;
+		}
+	}
+	isl_space_free(left);
+	isl_space_free(right);
+	return res;
+}
+
 /* Given two map spaces { A -> C } and { B -> D }, construct the space
  * { [A -> B] -> [C -> D] }.
  * Given two set spaces { A } and { B }, construct the space { [A -> B] }.
@@ -1511,7 +1689,7 @@ static __isl_give isl_space *set_ids(__isl_take isl_space *dim,
 	return dim;
 }
 
-__isl_give isl_space *isl_space_reverse(__isl_take isl_space *dim)
+static __isl_give isl_space *space_reverse(__isl_take isl_space *dim)
 {
 	unsigned t;
 	isl_space *nested;
@@ -1561,6 +1739,13 @@ error:
 	return NULL;
 }
 
+__isl_give isl_space *isl_space_reverse(__isl_take isl_space *space)
+{
+	if (!space)
+		return NULL;
+	return space_derive(space, &space->reverse, &space_reverse);
+}
+
 __isl_give isl_space *isl_space_drop_dims(__isl_take isl_space *dim,
 	enum isl_dim_type type, unsigned first, unsigned num)
 {
@@ -1641,16 +1826,23 @@ __isl_give isl_space *isl_space_drop_outputs(__isl_take isl_space *dim,
 	return isl_space_drop_dims(dim, isl_dim_out, first, n);
 }
 
-__isl_give isl_space *isl_space_domain(__isl_take isl_space *dim)
+static __isl_give isl_space *space_domain(__isl_take isl_space *dim)
 {
 	if (!dim)
 		return NULL;
 	dim = isl_space_drop_outputs(dim, 0, dim->n_out);
-	dim = isl_space_reverse(dim);
+	dim = space_reverse(dim);
 	dim = mark_as_set(dim);
 	return dim;
 }
 
+__isl_give isl_space *isl_space_domain(__isl_take isl_space *space)
+{
+	if (!space)
+		return NULL;
+	return space_derive(space, &space->domain, &space_domain);
+}
+
 __isl_give isl_space *isl_space_from_domain(__isl_take isl_space *dim)
 {
 	if (!dim)
@@ -1666,7 +1858,7 @@ error:
 	return NULL;
 }
 
-__isl_give isl_space *isl_space_range(__isl_take isl_space *dim)
+static __isl_give isl_space *space_range(__isl_take isl_space *dim)
 {
 	if (!dim)
 		return NULL;
@@ -1675,6 +1867,13 @@ __isl_give isl_space *isl_space_range(__isl_take isl_space *dim)
 	return dim;
 }
 
+__isl_give isl_space *isl_space_range(__isl_take isl_space *space)
+{
+	if (!space)
+		return NULL;
+	return space_derive(space, &space->range, &space_range);
+}
+
 __isl_give isl_space *isl_space_from_range(__isl_take isl_space *dim)
 {
 	if (!dim)
@@ -2257,6 +2456,11 @@ __isl_give isl_space *isl_space_align_params(__isl_take isl_space *dim1,
 			"parameter alignment requires named parameters",
 			goto error);
 
+	if (match(dim1, isl_dim_param, dim2, isl_dim_param)) {
+		isl_space_free(dim2);
+		return dim1;
+	}
+
 	dim2 = isl_space_params(dim2);
 	exp = isl_parameter_alignment_reordering(dim1, dim2);
 	exp = isl_reordering_extend_space(exp, dim1);
@@ -6,6 +6,14 @@
 #include <isl/id.h>
 
 struct isl_name;
+
+/* If "interned" is set, then the space is owned (in part) by
+ * the space table of its isl_ctx and it is never modified in place.
+ * "reverse", "domain" and "range" then cache (without holding a reference)
+ * the interned results of applying the corresponding operation,
+ * while "join_right" and "join" cache the interned result of
+ * the most recent join with "join_right" as right argument.
+ */
 struct isl_space {
 	int ref;
 
@@ -20,10 +28,19 @@ struct isl_space {
 
 	unsigned n_id;
 	isl_id **ids;
+
+	int interned;
+	isl_space *reverse;
+	isl_space *domain;
+	isl_space *range;
+	isl_space *join_right;
+	isl_space *join;
 };
 
 __isl_give isl_space *isl_space_cow(__isl_take isl_space *dim);
 
+void isl_space_clear_interned(isl_ctx *ctx);
+
 __isl_give isl_space *isl_space_underlying(__isl_take isl_space *dim,
 	unsigned n_div);
 
@@ -87,6 +87,8 @@ struct isl_tab *isl_tab_alloc(struct isl_ctx *ctx,
 	tab->n_unbounded = 0;
 	tab->basis = NULL;
 
+	ctx->stats->tab_allocs++;
+
 	return tab;
 error:
 	isl_tab_free(tab);
@@ -1118,6 +1120,7 @@ int isl_tab_pivot(struct isl_tab *tab, int row, int col)
 	ctx = isl_tab_get_ctx(tab);
 	if (isl_ctx_next_operation(ctx) < 0)
 		return -1;
+	ctx->stats->tab_pivots++;
 
 	isl_int_swap(mat->row[row][0], mat->row[row][off + col]);
 	sgn = isl_int_sgn(mat->row[row][0]);
@@ -3106,6 +3109,8 @@ enum isl_lp_result isl_tab_min(struct isl_tab *tab,
 	if (tab->empty)
 		return isl_lp_empty;
 
+	isl_tab_get_ctx(tab)->stats->lp_solves++;
+
 	snap = isl_tab_snap(tab);
 	r = isl_tab_add_row(tab, f);
 	if (r < 0)
@@ -19,6 +19,7 @@
 #include <isl_vec_private.h>
 #include <isl_aff_private.h>
 #include <isl_options_private.h>
+#include <isl_quast_private.h>
 #include <isl_config.h>
 
 /*
@@ -157,6 +158,15 @@ struct isl_sol_callback {
  * in an isl_set, and
  * isl_sol_for, which calls a user-defined function for each part of
  * the solution.
+ *
+ * If "direct" is set, then the solutions are passed to "add" or
+ * "add_empty" as soon as they are found, rather than being collected
+ * on the stack of partial solutions first.
+ * If "split" is not NULL, then it is called whenever the context
+ * is split into the part where the given inequality holds and
+ * the part where it does not hold.  The first part is considered
+ * first, after which "split_else" is called, and finally "split_end"
+ * is called when the second part has been handled as well.
  */
 struct isl_sol {
 	int error;
@@ -164,11 +174,15 @@ struct isl_sol {
 	int level;
 	int max;
 	int n_out;
+	int direct;
 	struct isl_context *context;
 	struct isl_partial_sol *partial;
 	void (*add)(struct isl_sol *sol,
 			    struct isl_basic_set *dom, struct isl_mat *M);
 	void (*add_empty)(struct isl_sol *sol, struct isl_basic_set *bset);
+	void (*split)(struct isl_sol *sol, isl_int *ineq);
+	void (*split_else)(struct isl_sol *sol);
+	void (*split_end)(struct isl_sol *sol);
 	void (*free)(struct isl_sol *sol);
 	struct isl_sol_callback	dec_level;
 };
@@ -198,6 +212,14 @@ static void sol_push_sol(struct isl_sol *sol,
 	if (sol->error || !dom)
 		goto error;
 
+	if (sol->direct) {
+		if (M)
+			sol->add(sol, dom, M);
+		else
+			sol->add_empty(sol, dom);
+		return;
+	}
+
 	partial = isl_alloc_type(dom->ctx, struct isl_partial_sol);
 	if (!partial)
 		goto error;
@@ -355,6 +377,9 @@ static void sol_dec_level(struct isl_sol *sol)
 
 	sol->level--;
 
+	if (sol->split_end)
+		sol->split_end(sol);
+
 	sol_pop(sol);
 }
 
@@ -386,6 +411,29 @@ static void sol_inc_level(struct isl_sol *sol)
 		sol->error = 1;
 }
 
+/* Notify "sol" that the context is about to be split
+ * according to the inequality "ineq", with the part
+ * where "ineq" holds being considered first.
+ */
+static void sol_split(struct isl_sol *sol, isl_int *ineq)
+{
+	if (sol->error || !sol->split)
+		return;
+
+	sol->split(sol, ineq);
+}
+
+/* Notify "sol" that the part of the context where the inequality
+ * of the latest split holds has been handled.
+ */
+static void sol_split_else(struct isl_sol *sol)
+{
+	if (sol->error || !sol->split_else)
+		return;
+
+	sol->split_else(sol);
+}
+
 static void scale_rows(struct isl_mat *mat, isl_int m, int n_row)
 {
 	int i;
@@ -3664,6 +3712,7 @@ static void no_sol_in_strict(struct isl_sol *sol,
 
 	isl_int_sub_ui(ineq->el[0], ineq->el[0], 1);
 
+	sol_split(sol, ineq->el);
 	sol->context->op->add_ineq(sol->context, ineq->el, 1, 0);
 	if (!sol->context)
 		goto error;
@@ -3672,6 +3721,7 @@ static void no_sol_in_strict(struct isl_sol *sol,
 	tab->empty = 1;
 	sol_add(sol, tab);
 	tab->empty = empty;
+	sol_split_else(sol);
 
 	isl_int_add_ui(ineq->el[0], ineq->el[0], 1);
 
@@ -3797,6 +3847,8 @@ static void find_solutions(struct isl_sol *sol, struct isl_tab *tab)
 		int split = -1;
 		int n_split = 0;
 
+		if (isl_ctx_check_abort(isl_tab_get_ctx(tab)) < 0)
+			goto error;
 		for (row = tab->n_redundant; row < tab->n_row; ++row) {
 			if (!isl_tab_var_from_row(tab, row)->is_nonneg)
 				continue;
@@ -3831,7 +3883,9 @@ static void find_solutions(struct isl_sol *sol, struct isl_tab *tab)
 			}
 			tab->row_sign[split] = isl_tab_row_pos;
 			sol_inc_level(sol);
+			sol_split(sol, ineq->el);
 			find_in_pos(sol, tab, ineq->el);
+			sol_split_else(sol);
 			tab->row_sign[split] = isl_tab_row_neg;
 			row = split;
 			isl_seq_neg(ineq->el, ineq->el, ineq->size);
@@ -4708,6 +4762,340 @@ error:
 	return NULL;
 }
 
+/* Return the representative of the group containing variable "i",
+ * compressing the path along the way.
+ */
+static int find_group(int *group, int i)
+{
+	while (group[i] != i)
+		i = group[i] = group[group[i]];
+	return i;
+}
+
+/* Merge the groups of all variables with a non-zero coefficient
+ * among the "len" coefficients in "c" with the group of variable "first",
+ * or with each other if "first" is negative.
+ */
+static void merge_groups(int *group, isl_int *c, int len, int first)
+{
+	int j;
+
+	if (first >= 0)
+		first = find_group(group, first);
+	for (j = 0; j < len; ++j) {
+		int g;
+
+		if (isl_int_is_zero(c[j]))
+			continue;
+		g = find_group(group, j);
+		if (first < 0)
+			first = g;
+		else if (g != first)
+			group[g] = first;
+	}
+}
+
+/* Determine which variables of "bmap" are related to its output
+ * variables, in the sense that there is a sequence of constraints
+ * of "bmap" or "dom" or integer division definitions of "bmap"
+ * that connects them.
+ * "dom" is assumed not to have any integer divisions.
+ *
+ * Return an array with an element for each variable of "bmap"
+ * that is set if the variable is related to the output variables.
+ */
+static int *related_to_output(__isl_keep isl_basic_map *bmap,
+	__isl_keep isl_basic_set *dom)
+{
+	int i;
+	int *group, *related;
+	unsigned total, n_in, n_out;
+	isl_ctx *ctx;
+
+	ctx = isl_basic_map_get_ctx(bmap);
+	total = isl_basic_map_total_dim(bmap);
+	n_in = isl_basic_map_dim(bmap, isl_dim_param) +
+	       isl_basic_map_dim(bmap, isl_dim_in);
+	n_out = isl_basic_map_dim(bmap, isl_dim_out);
+	group = isl_alloc_array(ctx, int, total);
+	related = isl_calloc_array(ctx, int, total);
+	if (total && (!group || !related))
+		goto error;
+
+	for (i = 0; i < total; ++i)
+		group[i] = i;
+	for (i = 0; i < bmap->n_eq; ++i)
+		merge_groups(group, bmap->eq[i] + 1, total, -1);
+	for (i = 0; i < bmap->n_ineq; ++i)
+		merge_groups(group, bmap->ineq[i] + 1, total, -1);
+	for (i = 0; i < bmap->n_div; ++i) {
+		if (isl_int_is_zero(bmap->div[i][0]))
+			continue;
+		merge_groups(group, bmap->div[i] + 2, total,
+				n_in + n_out + i);
+	}
+	for (i = 0; i < dom->n_eq; ++i)
+		merge_groups(group, dom->eq[i] + 1, n_in, -1);
+	for (i = 0; i < dom->n_ineq; ++i)
+		merge_groups(group, dom->ineq[i] + 1, n_in, -1);
+
+	for (i = 0; i < n_out; ++i)
+		related[find_group(group, n_in + i)] = 1;
+	for (i = 0; i < total; ++i)
+		related[i] = related[find_group(group, i)];
+
+	free(group);
+	return related;
+error:
+	free(group);
+	free(related);
+	return NULL;
+}
+
+/* Does the (linear part of the) constraint "c" involve any of
+ * the "len" variables that are not marked "related"?
+ */
+static int involves_unrelated(isl_int *c, int len, int *related)
+{
+	int i;
+
+	for (i = 0; i < len; ++i)
+		if (!related[i] && !isl_int_is_zero(c[i]))
+			return 1;
+
+	return 0;
+}
+
+/* Drop the constraints of "bmap" that involve variables not marked
+ * "related" if "unrelated" is not set, or the constraints that do not
+ * involve such variables if "unrelated" is set.
+ * "related" has an element for each of the first "len" variables.
+ */
+static __isl_give isl_basic_map *keep_constraints(
+	__isl_take isl_basic_map *bmap, int len, int *related, int unrelated)
+{
+	int i;
+
+	bmap = isl_basic_map_cow(bmap);
+	if (!bmap)
+		return NULL;
+
+	for (i = bmap->n_eq - 1; i >= 0; --i)
+		if (involves_unrelated(bmap->eq[i] + 1, len, related) !=
+		    unrelated)
+			isl_basic_map_drop_equality(bmap, i);
+	for (i = bmap->n_ineq - 1; i >= 0; --i)
+		if (involves_unrelated(bmap->ineq[i] + 1, len, related) !=
+		    unrelated)
+			isl_basic_map_drop_inequality(bmap, i);
+
+	return isl_basic_map_finalize(bmap);
+}
+
+static __isl_give isl_basic_set *keep_set_constraints(
+	__isl_take isl_basic_set *bset, int len, int *related, int unrelated)
+{
+	return (isl_basic_set *) keep_constraints((isl_basic_map *) bset,
+						len, related, unrelated);
+}
+
+/* Drop the parameters and input variables of "bmap" that are not
+ * marked "related".
+ */
+static __isl_give isl_basic_map *drop_unrelated_inputs(
+	__isl_take isl_basic_map *bmap, int *related)
+{
+	int i;
+	unsigned nparam, n_in;
+
+	nparam = isl_basic_map_dim(bmap, isl_dim_param);
+	n_in = isl_basic_map_dim(bmap, isl_dim_in);
+	for (i = n_in - 1; i >= 0; --i)
+		if (!related[nparam + i])
+			bmap = isl_basic_map_drop(bmap, isl_dim_in, i, 1);
+	for (i = nparam - 1; i >= 0; --i)
+		if (!related[i])
+			bmap = isl_basic_map_drop(bmap, isl_dim_param, i, 1);
+
+	return bmap;
+}
+
+/* Drop the parameters and set variables of "bset" that are not
+ * marked "related".
+ */
+static __isl_give isl_basic_set *drop_unrelated_dims(
+	__isl_take isl_basic_set *bset, int *related)
+{
+	int i;
+	unsigned nparam, dim;
+
+	nparam = isl_basic_set_dim(bset, isl_dim_param);
+	dim = isl_basic_set_dim(bset, isl_dim_set);
+	for (i = dim - 1; i >= 0; --i)
+		if (!related[nparam + i])
+			bset = isl_basic_set_drop(bset, isl_dim_set, i, 1);
+	for (i = nparam - 1; i >= 0; --i)
+		if (!related[i])
+			bset = isl_basic_set_drop(bset, isl_dim_param, i, 1);
+
+	return bset;
+}
+
+/* Reintroduce the parameters and input variables that were
+ * removed by drop_unrelated_inputs in "map" and
+ * reset the space of the result to "space".
+ */
+static __isl_give isl_map *insert_unrelated_inputs(__isl_take isl_map *map,
+	int *related, __isl_take isl_space *space)
+{
+	int i;
+	unsigned nparam, n_in;
+
+	nparam = isl_space_dim(space, isl_dim_param);
+	n_in = isl_space_dim(space, isl_dim_in);
+	for (i = 0; i < nparam; ++i)
+		if (!related[i])
+			map = isl_map_insert_dims(map, isl_dim_param, i, 1);
+	for (i = 0; i < n_in; ++i)
+		if (!related[nparam + i])
+			map = isl_map_insert_dims(map, isl_dim_in, i, 1);
+
+	return isl_map_reset_space(map, space);
+}
+
+/* Reintroduce the parameters and set variables that were
+ * removed by drop_unrelated_dims in "set" and
+ * reset the space of the result to "space".
+ */
+static __isl_give isl_set *insert_unrelated_dims(__isl_take isl_set *set,
+	int *related, __isl_take isl_space *space)
+{
+	int i;
+	unsigned nparam, dim;
+
+	nparam = isl_space_dim(space, isl_dim_param);
+	dim = isl_space_dim(space, isl_dim_set);
+	for (i = 0; i < nparam; ++i)
+		if (!related[i])
+			set = isl_set_insert_dims(set, isl_dim_param, i, 1);
+	for (i = 0; i < dim; ++i)
+		if (!related[nparam + i])
+			set = isl_set_insert_dims(set, isl_dim_set, i, 1);
+
+	return isl_set_reset_space(set, space);
+}
+
+/* Compute the lexicographic optimum of "bmap" over "dom" as in
+ * isl_tab_basic_map_partial_lexopt, after removing the parameters and
+ * input variables that are not related to the output variables.
+ * Since the constraints that involve these variables are
+ * disconnected from the output variables, they do not affect
+ * the optimum, but only the domain where it is defined.
+ * Removing them keeps the context tableau small.
+ *
+ * We split "bmap" and "dom" into a part that only involves related
+ * variables ("bmap" and "dom_rel") and a part that only involves
+ * unrelated variables ("unrel" and "dom_unrel").
+ * The problem without the unrelated variables is solved recursively and
+ * the unrelated variables are then reintroduced in the result,
+ * which is restricted to the domain "unrel" of the unrelated part.
+ * The domain where the reduced problem has no solution is similarly
+ * extended and restricted to "dom_unrel".  To this we add those parts
+ * of "dom" where the unrelated part has no solution.
+ *
+ * If "dom" has any integer divisions or if there are any unrelated integer
+ * divisions in "bmap", then we do not perform this pruning.
+ */
+static __isl_give isl_map *basic_map_partial_lexopt_prune(
+	__isl_take isl_basic_map *bmap, __isl_take isl_basic_set *dom,
+	__isl_give isl_set **empty, int max)
+{
+	int i;
+	int *related;
+	unsigned n_in, n_out, total;
+	isl_space *map_space, *set_space;
+	isl_basic_map *unrel_map;
+	isl_basic_set *dom_rel, *dom_unrel, *unrel;
+	isl_set *empty_rel = NULL;
+	isl_map *res;
+
+	if (!bmap || !dom)
+		goto error;
+	n_in = isl_basic_map_dim(bmap, isl_dim_param) +
+	       isl_basic_map_dim(bmap, isl_dim_in);
+	n_out = isl_basic_map_dim(bmap, isl_dim_out);
+	if (dom->n_div > 0 || n_in == 0 || n_out == 0)
+		return basic_map_partial_lexopt(bmap, dom, empty, max);
+
+	related = related_to_output(bmap, dom);
+	if (!related)
+		goto error;
+	total = isl_basic_map_total_dim(bmap);
+	for (i = n_in + n_out; i < total; ++i)
+		if (!related[i])
+			break;
+	if (i < total) {
+		free(related);
+		return basic_map_partial_lexopt(bmap, dom, empty, max);
+	}
+	for (i = 0; i < n_in; ++i)
+		if (!related[i])
+			break;
+	if (i >= n_in) {
+		free(related);
+		return basic_map_partial_lexopt(bmap, dom, empty, max);
+	}
+
+	map_space = isl_basic_map_get_space(bmap);
+	set_space = isl_basic_set_get_space(dom);
+
+	unrel_map = keep_constraints(isl_basic_map_copy(bmap),
+					total, related, 1);
+	unrel_map = isl_basic_map_drop(unrel_map, isl_dim_div, 0,
+				isl_basic_map_dim(unrel_map, isl_dim_div));
+	unrel = isl_basic_map_domain(unrel_map);
+	bmap = keep_constraints(bmap, total, related, 0);
+	bmap = drop_unrelated_inputs(bmap, related);
+
+	dom_unrel = keep_set_constraints(isl_basic_set_copy(dom),
+					n_in, related, 1);
+	dom_rel = keep_set_constraints(dom, n_in, related, 0);
+	dom = drop_unrelated_dims(isl_basic_set_copy(dom_rel), related);
+
+	res = basic_map_partial_lexopt(bmap, dom,
+					empty ? &empty_rel : NULL, max);
+	res = insert_unrelated_inputs(res, related, map_space);
+	res = isl_map_intersect_domain(res,
+				isl_set_from_basic_set(isl_basic_set_copy(unrel)));
+
+	if (empty) {
+		isl_set *rest;
+
+		empty_rel = insert_unrelated_dims(empty_rel, related,
+						  set_space);
+		*empty = isl_set_intersect(empty_rel,
+			    isl_set_from_basic_set(isl_basic_set_copy(dom_unrel)));
+		rest = isl_set_subtract(isl_set_from_basic_set(dom_unrel),
+					isl_set_from_basic_set(unrel));
+		rest = isl_set_intersect(rest, isl_set_from_basic_set(dom_rel));
+		*empty = isl_set_union(*empty, rest);
+		if (!*empty)
+			res = isl_map_free(res);
+	} else {
+		isl_space_free(set_space);
+		isl_basic_set_free(dom_unrel);
+		isl_basic_set_free(dom_rel);
+		isl_basic_set_free(unrel);
+	}
+
+	free(related);
+	return res;
+error:
+	isl_basic_set_free(dom);
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
 /* Compute the lexicographic minimum (or maximum if "max" is set)
  * of "bmap" over the domain "dom" and return the result as a map.
  * If "empty" is not NULL, then *empty is assigned a set that
@@ -4745,6 +5133,8 @@ struct isl_map *isl_tab_basic_map_partial_lexopt(
 	bmap = isl_basic_map_detect_equalities(bmap);
 	bmap = isl_basic_map_remove_redundancies(bmap);
 
+	if (bmap && bmap->ctx->opt->pip_prune)
+		return basic_map_partial_lexopt_prune(bmap, dom, empty, max);
 	return basic_map_partial_lexopt(bmap, dom, empty, max);
 error:
 	isl_basic_set_free(dom);
@@ -5277,19 +5667,21 @@ error:
 
 /* Given a basic map "dom" that represents the context and an affine
  * matrix "M" that maps the dimensions of the context to the
- * output variables, construct an isl_pw_multi_aff with a single
- * cell corresponding to "dom" and affine expressions copied from "M".
+ * output variables, construct an isl_multi_aff in the space "space"
+ * with affine expressions copied from "M".
  */
-static void sol_pma_add(struct isl_sol_pma *sol,
-	__isl_take isl_basic_set *dom, __isl_take isl_mat *M)
+static __isl_give isl_multi_aff *sol_multi_aff(__isl_take isl_space *space,
+	__isl_keep isl_basic_set *dom, __isl_take isl_mat *M)
 {
 	int i;
 	isl_local_space *ls;
 	isl_aff *aff;
 	isl_multi_aff *maff;
-	isl_pw_multi_aff *pma;
 
-	maff = isl_multi_aff_alloc(isl_pw_multi_aff_get_space(sol->pma));
+	if (!M)
+		goto error;
+
+	maff = isl_multi_aff_alloc(space);
 	ls = isl_basic_set_get_local_space(dom);
 	for (i = 1; i < M->n_row; ++i) {
 		aff = isl_aff_alloc(isl_local_space_copy(ls));
@@ -5302,6 +5694,25 @@ static void sol_pma_add(struct isl_sol_pma *sol,
 	}
 	isl_local_space_free(ls);
 	isl_mat_free(M);
+
+	return maff;
+error:
+	isl_space_free(space);
+	return NULL;
+}
+
+/* Given a basic map "dom" that represents the context and an affine
+ * matrix "M" that maps the dimensions of the context to the
+ * output variables, construct an isl_pw_multi_aff with a single
+ * cell corresponding to "dom" and affine expressions copied from "M".
+ */
+static void sol_pma_add(struct isl_sol_pma *sol,
+	__isl_take isl_basic_set *dom, __isl_take isl_mat *M)
+{
+	isl_multi_aff *maff;
+	isl_pw_multi_aff *pma;
+
+	maff = sol_multi_aff(isl_pw_multi_aff_get_space(sol->pma), dom, M);
 	dom = isl_basic_set_simplify(dom);
 	dom = isl_basic_set_finalize(dom);
 	pma = isl_pw_multi_aff_alloc(isl_set_from_basic_set(dom), maff);
@@ -5679,3 +6090,236 @@ error:
 	isl_basic_map_free(bmap);
 	return NULL;
 }
+
+/* An isl_sol_quast collects the solutions in a decision diagram
+ * that follows the case splits of the parametric integer programming
+ * algorithm.  In particular, every split of the context results
+ * in an if node with the splitting inequality as condition,
+ * such that the constraints on the parameters are only stored once
+ * rather than being repeated for each part of the solution.
+ * The solutions are passed to the builder immediately, in the order
+ * in which they are found.
+ */
+struct isl_sol_quast {
+	struct isl_sol	sol;
+	isl_space *space;
+	struct isl_quast_builder *builder;
+};
+
+static void sol_quast_free(struct isl_sol_quast *sol_quast)
+{
+	if (!sol_quast)
+		return;
+	if (sol_quast->sol.context)
+		sol_quast->sol.context->op->free(sol_quast->sol.context);
+	isl_space_free(sol_quast->space);
+	isl_quast_builder_free(sol_quast->builder);
+	free(sol_quast);
+}
+
+static void sol_quast_free_wrap(struct isl_sol *sol)
+{
+	sol_quast_free((struct isl_sol_quast *)sol);
+}
+
+static void sol_quast_add_empty_wrap(struct isl_sol *sol,
+	__isl_take isl_basic_set *bset)
+{
+	struct isl_sol_quast *sol_quast = (struct isl_sol_quast *)sol;
+
+	isl_basic_set_free(bset);
+	if (isl_quast_builder_empty(sol_quast->builder) < 0)
+		sol->error = 1;
+}
+
+static void sol_quast_add_wrap(struct isl_sol *sol,
+	__isl_take isl_basic_set *dom, __isl_take isl_mat *M)
+{
+	struct isl_sol_quast *sol_quast = (struct isl_sol_quast *)sol;
+	isl_multi_aff *maff;
+
+	maff = sol_multi_aff(isl_space_copy(sol_quast->space), dom, M);
+	isl_basic_set_free(dom);
+	if (isl_quast_builder_leaf(sol_quast->builder, maff) < 0)
+		sol->error = 1;
+}
+
+/* Start an if node with condition "ineq", expressed in terms
+ * of the variables of the current context.
+ */
+static void sol_quast_split_wrap(struct isl_sol *sol, isl_int *ineq)
+{
+	struct isl_sol_quast *sol_quast = (struct isl_sol_quast *)sol;
+	isl_basic_set *bset;
+	isl_aff *cond;
+
+	bset = sol->context->op->peek_basic_set(sol->context);
+	cond = isl_aff_alloc(isl_basic_set_get_local_space(bset));
+	if (cond) {
+		isl_int_set_si(cond->v->el[0], 1);
+		isl_seq_cpy(cond->v->el + 1, ineq, cond->v->size - 1);
+	}
+	if (isl_quast_builder_split(sol_quast->builder, cond) < 0)
+		sol->error = 1;
+}
+
+static void sol_quast_split_else_wrap(struct isl_sol *sol)
+{
+	struct isl_sol_quast *sol_quast = (struct isl_sol_quast *)sol;
+
+	if (isl_quast_builder_else(sol_quast->builder) < 0)
+		sol->error = 1;
+}
+
+static void sol_quast_split_end_wrap(struct isl_sol *sol)
+{
+	struct isl_sol_quast *sol_quast = (struct isl_sol_quast *)sol;
+
+	if (isl_quast_builder_close(sol_quast->builder) < 0)
+		sol->error = 1;
+}
+
+/* Construct an isl_sol_quast structure for accumulating the solution.
+ * The parts of the context where there is no solution are always
+ * tracked, as empty leaves of the decision diagram,
+ * irrespective of "track_empty".
+ * If max is set, then we are solving a maximization, rather than
+ * a minimization problem, which means that the variables in the
+ * tableau have value "M - x" rather than "M + x".
+ */
+static struct isl_sol *sol_quast_init(__isl_keep isl_basic_map *bmap,
+	__isl_take isl_basic_set *dom, int track_empty, int max)
+{
+	struct isl_sol_quast *sol_quast = NULL;
+
+	if (!bmap)
+		goto error;
+
+	sol_quast = isl_calloc_type(bmap->ctx, struct isl_sol_quast);
+	if (!sol_quast)
+		goto error;
+
+	sol_quast->sol.rational = ISL_F_ISSET(bmap, ISL_BASIC_MAP_RATIONAL);
+	sol_quast->sol.dec_level.callback.run = &sol_dec_level_wrap;
+	sol_quast->sol.dec_level.sol = &sol_quast->sol;
+	sol_quast->sol.max = max;
+	sol_quast->sol.n_out = isl_basic_map_dim(bmap, isl_dim_out);
+	sol_quast->sol.direct = 1;
+	sol_quast->sol.add = &sol_quast_add_wrap;
+	sol_quast->sol.add_empty = &sol_quast_add_empty_wrap;
+	sol_quast->sol.split = &sol_quast_split_wrap;
+	sol_quast->sol.split_else = &sol_quast_split_else_wrap;
+	sol_quast->sol.split_end = &sol_quast_split_end_wrap;
+	sol_quast->sol.free = &sol_quast_free_wrap;
+	sol_quast->space = isl_basic_map_get_space(bmap);
+	sol_quast->builder = isl_quast_builder_alloc(
+					isl_basic_map_get_space(bmap),
+					isl_basic_set_copy(dom));
+	if (!sol_quast->builder)
+		goto error;
+
+	sol_quast->sol.context = isl_context_alloc(dom);
+	if (!sol_quast->sol.context)
+		goto error;
+
+	isl_basic_set_free(dom);
+	return &sol_quast->sol;
+error:
+	isl_basic_set_free(dom);
+	sol_quast_free(sol_quast);
+	return NULL;
+}
+
+/* Compute the lexicographic minimum (or maximum if "max" is set)
+ * of "bmap" over the domain "dom" and return the result as an isl_quast.
+ * The parts of "dom" where there is no solution are represented
+ * by empty leaves.
+ *
+ * We perform the same preprocessing as
+ * isl_basic_map_partial_lexopt_pw_multi_aff, except that we do not
+ * look for simple symmetries, since exploiting them would require
+ * plugging in the expression of a minimum into the decision diagram.
+ */
+static __isl_give isl_quast *basic_map_partial_lexopt_quast(
+	__isl_take isl_basic_map *bmap, __isl_take isl_basic_set *dom, int max)
+{
+	isl_quast *quast;
+	struct isl_sol *sol;
+	struct isl_sol_quast *sol_quast;
+
+	if (!bmap || !dom)
+		goto error;
+
+	isl_assert(bmap->ctx,
+	    isl_basic_map_compatible_domain(bmap, dom), goto error);
+
+	if (isl_basic_set_dim(dom, isl_dim_all) != 0) {
+		bmap = isl_basic_map_intersect_domain(bmap,
+						    isl_basic_set_copy(dom));
+		bmap = isl_basic_map_detect_equalities(bmap);
+		bmap = isl_basic_map_remove_redundancies(bmap);
+	}
+
+	sol = basic_map_partial_lexopt_base(bmap, dom, NULL, max,
+					    &sol_quast_init);
+	if (!sol)
+		return NULL;
+	sol_quast = (struct isl_sol_quast *) sol;
+
+	quast = isl_quast_builder_finish(sol_quast->builder);
+	sol_free(sol);
+	return quast;
+error:
+	isl_basic_set_free(dom);
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
+__isl_give isl_quast *isl_basic_map_partial_lexmin_quast(
+	__isl_take isl_basic_map *bmap, __isl_take isl_basic_set *dom)
+{
+	return basic_map_partial_lexopt_quast(bmap, dom, 0);
+}
+
+__isl_give isl_quast *isl_basic_map_partial_lexmax_quast(
+	__isl_take isl_basic_map *bmap, __isl_take isl_basic_set *dom)
+{
+	return basic_map_partial_lexopt_quast(bmap, dom, 1);
+}
+
+/* Compute the lexicographic minimum (or maximum if "max" is set)
+ * of "bmap" over its domain and return the result as an isl_quast.
+ * As in isl_basic_map_lexopt, the domain over which the optimum
+ * is computed is formed by the constraints of "bmap" that do not
+ * involve any output dimensions or existentially quantified variables.
+ */
+static __isl_give isl_quast *basic_map_lexopt_quast(
+	__isl_take isl_basic_map *bmap, int max)
+{
+	int n_div;
+	int n_out;
+	isl_basic_map *copy;
+	isl_basic_set *dom;
+
+	n_div = isl_basic_map_dim(bmap, isl_dim_div);
+	n_out = isl_basic_map_dim(bmap, isl_dim_out);
+	copy = isl_basic_map_copy(bmap);
+	copy = isl_basic_map_drop_constraints_involving_dims(copy,
+							isl_dim_div, 0, n_div);
+	copy = isl_basic_map_drop_constraints_involving_dims(copy,
+							isl_dim_out, 0, n_out);
+	dom = isl_basic_map_domain(copy);
+	return basic_map_partial_lexopt_quast(bmap, dom, max);
+}
+
+__isl_give isl_quast *isl_basic_map_lexmin_quast(
+	__isl_take isl_basic_map *bmap)
+{
+	return basic_map_lexopt_quast(bmap, 0);
+}
+
+__isl_give isl_quast *isl_basic_map_lexmax_quast(
+	__isl_take isl_basic_map *bmap)
+{
+	return basic_map_lexopt_quast(bmap, 1);
+}
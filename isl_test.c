@@ -20,8 +20,10 @@
 #include <limits.h>
 #include <isl_ctx_private.h>
 #include <isl_map_private.h>
+#include <isl_space_private.h>
 #include <isl_aff_private.h>
 #include <isl/set.h>
+#include <isl/mat.h>
 #include <isl/flow.h>
 #include <isl_constraint_private.h>
 #include <isl/polynomial.h>
@@ -36,6 +38,7 @@
 #include <isl/ilp.h>
 #include <isl_ast_build_expr.h>
 #include <isl/options.h>
+#include <isl/quast.h>
 
 #define ARRAY_SIZE(array) (sizeof(array)/sizeof(*array))
 
@@ -610,6 +613,107 @@ static int test_val(isl_ctx *ctx)
 	return 0;
 }
 
+/* Check that projecting out the last set dimension of "str"
+ * removes the corresponding existentially quantified variable
+ * without solving any LP problem.
+ * In every pair of lower and upper bounds on the variable,
+ * it has a unit coefficient in at least one of the two bounds,
+ * so the pair is known to allow an integer value.
+ */
+static int test_drop_unit_div(isl_ctx *ctx, const char *str)
+{
+	isl_basic_set *bset;
+	unsigned pos;
+	long lp_solves;
+	int n;
+
+	bset = isl_basic_set_read_from_str(ctx, str);
+	pos = isl_basic_set_dim(bset, isl_dim_set) - 1;
+	isl_ctx_reset_stats(ctx);
+	bset = isl_basic_set_project_out(bset, isl_dim_set, pos, 1);
+	lp_solves = isl_ctx_get_stats(ctx)->lp_solves;
+	n = isl_basic_set_dim(bset, isl_dim_div);
+	isl_basic_set_free(bset);
+	if (!bset)
+		return -1;
+	if (n != 0)
+		isl_die(ctx, isl_error_unknown,
+			"expecting no existentials", return -1);
+	if (lp_solves != 0)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected LP", return -1);
+
+	return 0;
+}
+
+/* Check that the failure to drop any existentially quantified variable
+ * is remembered, such that simplifying the result a second time
+ * returns immediately without performing any tableau operation.
+ */
+static int test_drop_redundant_divs_cached(isl_ctx *ctx)
+{
+	const char *str;
+	isl_basic_set *bset;
+	const struct isl_stats *stats;
+	int n, cached, ok;
+
+	str = "{ [i, j, a] : 2a >= i and 2a <= j }";
+	bset = isl_basic_set_read_from_str(ctx, str);
+	bset = isl_basic_set_project_out(bset, isl_dim_set, 2, 1);
+	n = isl_basic_set_dim(bset, isl_dim_div);
+	cached = bset && ISL_F_ISSET(bset, ISL_BASIC_MAP_NO_REDUNDANT_DIVS);
+	isl_ctx_reset_stats(ctx);
+	bset = isl_basic_set_drop_redundant_divs(bset);
+	stats = isl_ctx_get_stats(ctx);
+	ok = stats->lp_solves == 0 && stats->tab_allocs == 0 &&
+		stats->tab_pivots == 0;
+	isl_basic_set_free(bset);
+	if (!bset)
+		return -1;
+	if (n != 1)
+		isl_die(ctx, isl_error_unknown,
+			"expecting one existential", return -1);
+	if (!cached || !ok)
+		isl_die(ctx, isl_error_unknown,
+			"second simplification not short-circuited",
+			return -1);
+
+	return 0;
+}
+
+/* Check that dropping an equality invalidates the recorded failure
+ * to drop any existentially quantified variable.
+ * The existentially quantified variable is only needed
+ * because of the equality, so it can be dropped
+ * once the equality has been removed.
+ */
+static int test_drop_redundant_divs_after_drop_eq(isl_ctx *ctx)
+{
+	const char *str;
+	isl_basic_set *bset;
+	int n_before, n_after;
+
+	str = "{ [i] : exists a : 2a = i and 0 <= i <= 10 }";
+	bset = isl_basic_set_read_from_str(ctx, str);
+	bset = isl_basic_set_drop_redundant_divs(bset);
+	n_before = isl_basic_set_dim(bset, isl_dim_div);
+	if (bset && isl_basic_set_drop_equality(bset, 0) < 0)
+		bset = isl_basic_set_free(bset);
+	bset = isl_basic_set_drop_redundant_divs(bset);
+	n_after = isl_basic_set_dim(bset, isl_dim_div);
+	isl_basic_set_free(bset);
+	if (!bset)
+		return -1;
+	if (n_before != 1)
+		isl_die(ctx, isl_error_unknown,
+			"expecting one existential", return -1);
+	if (n_after != 0)
+		isl_die(ctx, isl_error_unknown,
+			"expecting no existentials", return -1);
+
+	return 0;
+}
+
 static int test_div(isl_ctx *ctx)
 {
 	unsigned n;
@@ -929,6 +1033,28 @@ static int test_div(isl_ctx *ctx)
 		isl_die(ctx, isl_error_unknown,
 			"expecting no existentials", return -1);
 
+	str = "{ [i,a] : 3a >= i and 3a <= i + 2 and 0 <= a <= 10 }";
+	bset = isl_basic_set_read_from_str(ctx, str);
+	bset = isl_basic_set_project_out(bset, isl_dim_set, 1, 1);
+	n = isl_basic_set_dim(bset, isl_dim_div);
+	isl_basic_set_free(bset);
+	if (!bset)
+		return -1;
+	if (n != 0)
+		isl_die(ctx, isl_error_unknown,
+			"expecting no existentials", return -1);
+
+	str = "{ [i,j,a] : a >= i and 3a <= j and 2a <= j + 5 }";
+	if (test_drop_unit_div(ctx, str) < 0)
+		return -1;
+	str = "{ [i,j,a] : a >= i and a >= j and 3a <= i + j + 10 }";
+	if (test_drop_unit_div(ctx, str) < 0)
+		return -1;
+	if (test_drop_redundant_divs_cached(ctx) < 0)
+		return -1;
+	if (test_drop_redundant_divs_after_drop_eq(ctx) < 0)
+		return -1;
+
 	str = "{ [i,j,k] : 3 + i + 2j >= 0 and 2 * [(i+2j)/4] <= k }";
 	set = isl_set_read_from_str(ctx, str);
 	set = isl_set_remove_divs_involving_dims(set, isl_dim_set, 0, 2);
@@ -1833,15 +1959,51 @@ void test_closure(struct isl_ctx *ctx)
 	isl_map_free(map);
 }
 
+/* Check that the functions that intersect with a lexicographic order
+ * without constructing it explicitly produce the same results
+ * as the ones that do construct it.
+ */
 void test_lex(struct isl_ctx *ctx)
 {
+	const char *str;
 	isl_space *dim;
-	isl_map *map;
+	isl_map *map, *map2;
+	isl_set *set1, *set2;
 
 	dim = isl_space_set_alloc(ctx, 0, 0);
 	map = isl_map_lex_le(dim);
 	assert(!isl_map_is_empty(map));
 	isl_map_free(map);
+
+	str = "[N] -> { [i, j, k] : 0 <= i, j, k <= N; [i, i, i] : i >= 5 }";
+	set1 = isl_set_read_from_str(ctx, str);
+	str = "[N] -> { [i, j, 0] : 0 <= i, j <= N; [3, 2, k] : k <= N }";
+	set2 = isl_set_read_from_str(ctx, str);
+	map = isl_set_lex_lt_set(isl_set_copy(set1), isl_set_copy(set2));
+	map2 = isl_map_lex_lt(isl_set_get_space(set1));
+	map2 = isl_map_intersect_domain(map2, isl_set_copy(set1));
+	map2 = isl_map_intersect_range(map2, isl_set_copy(set2));
+	assert(isl_map_is_equal(map, map2));
+	isl_map_free(map);
+	isl_map_free(map2);
+
+	map = isl_map_from_domain_and_range(set1, set2);
+	map2 = isl_map_lex_ge_first(isl_map_get_space(map), 2);
+	map2 = isl_map_intersect(isl_map_copy(map), map2);
+	map = isl_map_intersect_lex_ge_first(map, 2);
+	assert(isl_map_is_equal(map, map2));
+	isl_map_free(map);
+	isl_map_free(map2);
+
+	str = "{ [i, j] -> [i + j, j] }";
+	map = isl_map_read_from_str(ctx, str);
+	map = isl_map_lex_lt_map(isl_map_copy(map), map);
+	str = "{ [i, j] -> [i', j'] : i' + j' > i + j or "
+				"(i' + j' = i + j and j' > j) }";
+	map2 = isl_map_read_from_str(ctx, str);
+	assert(isl_map_is_equal(map, map2));
+	isl_map_free(map);
+	isl_map_free(map2);
 }
 
 static int test_lexmin(struct isl_ctx *ctx)
@@ -1958,6 +2120,224 @@ static int test_lexmin(struct isl_ctx *ctx)
 			"unexpected difference between set and "
 			"piecewise affine expression", return -1);
 
+	/* Check parameters that are not related to the optimized variables. */
+	str = "[N, M, P] -> { [i] -> [a] : a >= i and a >= N and 0 <= P <= M }";
+	map = isl_map_read_from_str(ctx, str);
+	str = "[N, M, P] -> { [i] : 0 <= i <= 10 and M <= 5 }";
+	set = isl_set_read_from_str(ctx, str);
+	map = isl_map_partial_lexmin(map, set, &set2);
+	str = "[N, M, P] -> { [i] -> [i] : N <= i <= 10 and i >= 0 and "
+			"0 <= P <= M <= 5; "
+		"[i] -> [N] : 0 <= i < N and i <= 10 and 0 <= P <= M <= 5 }";
+	map2 = isl_map_read_from_str(ctx, str);
+	equal = isl_map_is_equal(map, map2);
+	isl_map_free(map);
+	isl_map_free(map2);
+	str = "[N, M, P] -> { [i] : 0 <= i <= 10 and M <= 5 and "
+		"(P < 0 or P > M) }";
+	set = isl_set_read_from_str(ctx, str);
+	if (equal >= 0 && equal)
+		equal = isl_set_is_equal(set, set2);
+	isl_set_free(set);
+	isl_set_free(set2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected partial lexmin", return -1);
+
+	return 0;
+}
+
+/* Inputs for testing the construction of lexicographic optima
+ * in the form of an isl_quast.
+ * If "bounded" is set, then the lexicographic maximum is also tested.
+ */
+struct {
+	int bounded;
+	const char *str;
+} quast_tests[] = {
+	{ 0, "[n, m] -> { [] -> S[i, j] : i >= 0 and i >= n - 5 and i >= m and "
+		"j >= i + n and j >= 2m and j >= 0 }" },
+	{ 1, "[n] -> { [k] -> [i] : 2i >= k and i >= n and i <= 100 }" },
+	{ 1, "{ [i] -> [j] : exists a : j = 3a and j >= i and j <= i + 10 }" },
+	{ 1, "[n] -> { [] -> S[i] : 0 <= i <= n and i >= 5 }" },
+	{ 1, "[N, M] -> { [i, j] -> [k] : i <= k <= N and j <= k <= M }" },
+	{ 0, "[n, m, p] -> { [] -> [j] : j >= 0 and j >= n and j >= m and "
+		"j >= p }" },
+};
+
+/* Return the number of nodes in the decision diagram of "quast"
+ * when it is expanded into a tree, i.e., when shared subtrees
+ * are counted once for every path leading to them.
+ */
+static int quast_tree_size(__isl_keep isl_quast *quast)
+{
+	int n_then, n_else;
+	isl_quast *child;
+
+	if (isl_quast_get_type(quast) != isl_quast_type_if)
+		return quast ? 1 : -1;
+	child = isl_quast_if_get_then(quast);
+	n_then = quast_tree_size(child);
+	isl_quast_free(child);
+	child = isl_quast_if_get_else(quast);
+	n_else = quast_tree_size(child);
+	isl_quast_free(child);
+	if (n_then < 0 || n_else < 0)
+		return -1;
+	return 1 + n_then + n_else;
+}
+
+/* Check that the isl_quast computed by isl_basic_map_lexmin_quast
+ * (or isl_basic_map_lexmax_quast if "max" is set) represents
+ * the same function as the result of isl_basic_map_lexmin
+ * (or isl_basic_map_lexmax).
+ */
+static int test_quast_lexopt(isl_ctx *ctx, const char *str, int max)
+{
+	isl_basic_map *bmap;
+	isl_quast *quast;
+	isl_map *map1, *map2;
+	int equal;
+
+	bmap = isl_basic_map_read_from_str(ctx, str);
+	if (max) {
+		quast = isl_basic_map_lexmax_quast(isl_basic_map_copy(bmap));
+		map2 = isl_basic_map_lexmax(bmap);
+	} else {
+		quast = isl_basic_map_lexmin_quast(isl_basic_map_copy(bmap));
+		map2 = isl_basic_map_lexmin(bmap);
+	}
+	map1 = isl_map_from_pw_multi_aff(isl_quast_to_pw_multi_aff(quast));
+	equal = isl_map_is_equal(map1, map2);
+	isl_map_free(map1);
+	isl_map_free(map2);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"quast does not represent lexicographic optimum",
+			return -1);
+
+	return 0;
+}
+
+/* Check that evaluating the isl_quast of the lexicographic minimum
+ * of "str", which is assumed to have a single output dimension,
+ * in the parameter value "n" produces "res".
+ */
+static int test_quast_eval(isl_ctx *ctx, const char *str, int n,
+	const char *res)
+{
+	isl_quast *quast;
+	isl_space *space;
+	isl_point *pnt;
+	isl_multi_val *mv;
+	isl_val *v, *v_res;
+	int equal;
+
+	quast = isl_basic_map_lexmin_quast(isl_basic_map_read_from_str(ctx,
+									str));
+	space = isl_space_domain(isl_quast_get_space(quast));
+	pnt = isl_point_zero(space);
+	pnt = isl_point_set_coordinate_val(pnt, isl_dim_param, 0,
+					    isl_val_int_from_si(ctx, n));
+	mv = isl_quast_eval(quast, pnt);
+	v = isl_multi_val_get_val(mv, 0);
+	v_res = isl_val_read_from_str(ctx, res);
+	if (isl_val_is_nan(v_res))
+		equal = isl_val_is_nan(v);
+	else
+		equal = isl_val_eq(v, v_res);
+	isl_multi_val_free(mv);
+	isl_val_free(v);
+	isl_val_free(v_res);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected value", return -1);
+
+	return 0;
+}
+
+static int test_quast(isl_ctx *ctx)
+{
+	int i;
+	const char *str;
+	isl_quast *quast;
+	isl_space *space;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	isl_printer *p;
+	char *s;
+	int n, n_tree, equal;
+
+	for (i = 0; i < ARRAY_SIZE(quast_tests); ++i) {
+		str = quast_tests[i].str;
+		if (test_quast_lexopt(ctx, str, 0) < 0)
+			return -1;
+		if (quast_tests[i].bounded &&
+		    test_quast_lexopt(ctx, str, 1) < 0)
+			return -1;
+	}
+
+	str = quast_tests[3].str;
+	if (test_quast_eval(ctx, str, 7, "5") < 0)
+		return -1;
+	if (test_quast_eval(ctx, str, 3, "NaN") < 0)
+		return -1;
+	str = "[n] -> { [] -> [j] : exists (a, b : j = 3a and 5b >= n and "
+		"j >= 2b) }";
+	if (test_quast_eval(ctx, str, 7, "6") < 0)
+		return -1;
+
+	str = quast_tests[0].str;
+	quast = isl_basic_map_lexmin_quast(isl_basic_map_read_from_str(ctx,
+									str));
+	n = isl_quast_n_node(quast);
+	isl_quast_free(quast);
+	if (n < 0)
+		return -1;
+	if (n != 10)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected number of nodes", return -1);
+
+	str = quast_tests[5].str;
+	quast = isl_basic_map_lexmin_quast(isl_basic_map_read_from_str(ctx,
+									str));
+	n = isl_quast_n_node(quast);
+	n_tree = quast_tree_size(quast);
+	isl_quast_free(quast);
+	if (n < 0 || n_tree < 0)
+		return -1;
+	if (n >= n_tree)
+		isl_die(ctx, isl_error_unknown,
+			"expecting shared subtrees", return -1);
+
+	str = quast_tests[3].str;
+	quast = isl_basic_map_lexmin_quast(isl_basic_map_read_from_str(ctx,
+									str));
+	space = isl_space_domain(isl_quast_get_space(quast));
+	build = isl_ast_build_from_context(isl_set_universe(space));
+	tree = isl_ast_build_node_from_quast(build, quast);
+	isl_ast_build_free(build);
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+	p = isl_printer_print_ast_node(p, tree);
+	s = isl_printer_get_str(p);
+	isl_printer_free(p);
+	isl_ast_node_free(tree);
+	if (!s)
+		return -1;
+	equal = !strcmp(s, "if (n >= 5)\n  S(5);\n");
+	free(s);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected AST", return -1);
+
 	return 0;
 }
 
@@ -2641,6 +3021,56 @@ static int test_subtract(isl_ctx *ctx)
 	return 0;
 }
 
+/* Inputs for isl_set_make_disjoint tests.
+ * "n" is the expected number of disjuncts in the result.
+ */
+struct {
+	const char *set;
+	int n;
+} make_disjoint_tests[] = {
+	{ "{ [i, j] : 0 <= i <= 10 and 0 <= j <= 5; "
+	    "[i, j] : 5 <= i <= 20 and 0 <= j <= 5 }", 1 },
+	{ "{ [i] : 0 <= i <= 10; [i] : 11 <= i <= 20; [i] : 30 <= i <= 40 }",
+	  2 },
+	{ "{ [i, j] : 0 <= i <= 10 and 0 <= j <= 5; "
+	    "[i, j] : 0 <= i <= 10 and 3 <= j <= 9; "
+	    "[i, j] : 0 <= i <= 10 and 10 <= j <= 12 }", 1 },
+	{ "{ [i, j] : 0 <= i <= 10 and 0 <= j <= 5; "
+	    "[i, j] : 5 <= i <= 20 and 3 <= j <= 8 }", 3 },
+	{ "{ rat: [i] : 0 <= i <= 10 or 11 <= i <= 20 }", 2 },
+};
+
+/* Check that isl_set_make_disjoint produces a disjoint union
+ * that is equal to the input, with the expected number of disjuncts.
+ */
+static int test_make_disjoint(isl_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(make_disjoint_tests); ++i) {
+		isl_set *set, *res;
+		int equal, n;
+
+		set = isl_set_read_from_str(ctx, make_disjoint_tests[i].set);
+		res = isl_set_make_disjoint(isl_set_copy(set));
+		equal = isl_set_is_equal(set, res);
+		n = isl_set_n_basic_set(res);
+		isl_set_free(set);
+		isl_set_free(res);
+		if (equal < 0 || n < 0)
+			return -1;
+		if (!equal)
+			isl_die(ctx, isl_error_unknown,
+				"incorrect result of isl_set_make_disjoint",
+				return -1);
+		if (n != make_disjoint_tests[i].n)
+			isl_die(ctx, isl_error_unknown,
+				"unexpected number of disjuncts", return -1);
+	}
+
+	return 0;
+}
+
 int test_factorize(isl_ctx *ctx)
 {
 	const char *str;
@@ -3062,6 +3492,85 @@ static int test_conditional_schedule_constraints(isl_ctx *ctx)
 	return 0;
 }
 
+/* Set the schedule_fuse option for the variant "i"
+ * of test_best_schedule.
+ */
+static int set_fuse_variant(isl_ctx *ctx, int i, void *user)
+{
+	int *fuse = user;
+
+	return isl_options_set_schedule_fuse(ctx, fuse[i]);
+}
+
+/* Prefer schedules with a band at the outermost level.
+ */
+static double outer_band_score(__isl_keep isl_schedule *schedule, void *user)
+{
+	isl_schedule_node *node;
+	double score;
+
+	node = isl_schedule_get_root(schedule);
+	node = isl_schedule_node_child(node, 0);
+	score = isl_schedule_node_get_type(node) == isl_schedule_node_band;
+	isl_schedule_node_free(node);
+
+	return score;
+}
+
+/* Check that isl_schedule_constraints_compute_best_schedule
+ * selects the variant with the best score, that it restores
+ * the scheduling options and that it abandons variants
+ * that run out of operations.
+ */
+static int test_best_schedule(isl_ctx *ctx)
+{
+	int fuse[] = { ISL_SCHEDULE_FUSE_MIN, ISL_SCHEDULE_FUSE_MAX };
+	int on_error, best;
+	const char *str;
+	isl_union_set *domain;
+	isl_union_map *dep;
+	isl_schedule_constraints *sc;
+	isl_schedule *schedule;
+
+	str = "{ A[i] : 0 <= i < 10; B[i] : 0 <= i < 10 }";
+	domain = isl_union_set_read_from_str(ctx, str);
+	dep = isl_union_map_read_from_str(ctx, "{ A[i] -> B[i] }");
+	sc = isl_schedule_constraints_on_domain(domain);
+	sc = isl_schedule_constraints_set_validity(sc, isl_union_map_copy(dep));
+	sc = isl_schedule_constraints_set_proximity(sc, dep);
+
+	isl_options_set_schedule_fuse(ctx, ISL_SCHEDULE_FUSE_MIN);
+	schedule = isl_schedule_constraints_compute_best_schedule(
+		    isl_schedule_constraints_copy(sc), 2, &set_fuse_variant,
+		    &outer_band_score, 0, fuse);
+	best = schedule ? outer_band_score(schedule, NULL) : -1;
+	isl_schedule_free(schedule);
+	if (best < 0) {
+		isl_schedule_constraints_free(sc);
+		return -1;
+	}
+	if (!best ||
+	    isl_options_get_schedule_fuse(ctx) != ISL_SCHEDULE_FUSE_MIN) {
+		isl_schedule_constraints_free(sc);
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of best schedule", return -1);
+	}
+
+	on_error = isl_options_get_on_error(ctx);
+	isl_options_set_on_error(ctx, ISL_ON_ERROR_CONTINUE);
+	schedule = isl_schedule_constraints_compute_best_schedule(sc, 2,
+			    &set_fuse_variant, &outer_band_score, 1, fuse);
+	isl_options_set_on_error(ctx, on_error);
+	isl_ctx_reset_error(ctx);
+	if (schedule) {
+		isl_schedule_free(schedule);
+		isl_die(ctx, isl_error_unknown,
+			"variants should have been abandoned", return -1);
+	}
+
+	return 0;
+}
+
 int test_schedule(isl_ctx *ctx)
 {
 	const char *D, *W, *R, *V, *P, *S;
@@ -3354,6 +3863,9 @@ int test_schedule(isl_ctx *ctx)
 	if (test_conditional_schedule_constraints(ctx) < 0)
 		return -1;
 
+	if (test_best_schedule(ctx) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -3734,19 +4246,82 @@ int test_dim_max(isl_ctx *ctx)
 	return 0;
 }
 
-/* Is "pma" obviously equal to the isl_pw_multi_aff represented by "str"?
+/* Inputs for isl_set_box_hull tests.
+ * "set" is the input set, while "lower" and "upper" are
+ * the expected lower and upper bounds.
  */
-static int pw_multi_aff_plain_is_equal(__isl_keep isl_pw_multi_aff *pma,
-	const char *str)
+struct {
+	const char *set;
+	const char *lower;
+	const char *upper;
+} box_hull_tests[] = {
+	{ "{ S[i, j] : 2i >= 1 and 2i <= 7 and 3j = i + 1 or "
+		"i = 10 and j = -4 }",
+	  "{ [] -> S[(2), (-4)] }", "{ [] -> S[(10), (1)] }" },
+	{ "{ [i, j] : exists a : 2i = 4a + 1 + j and 0 <= i <= 10 and "
+		"3j <= i + 2 and j >= 1 }",
+	  "{ [] -> [(1), (1)] }", "{ [] -> [(10), (3)] }" },
+	{ "{ [i] : 1 = 0 }",
+	  "{ [] -> [(0 : 1 = 0)] }", "{ [] -> [(0 : 1 = 0)] }" },
+	{ "[N] -> { [i] : 0 <= i <= 2N or 0 <= i <= N + 6 }",
+	  "[N] -> { [] -> [(0 : N >= -6)] }",
+	  "[N] -> { [] -> [(6 + N : -6 <= N <= 5; 2N : N >= 6)] }" },
+};
+
+static int test_box_hull(isl_ctx *ctx)
 {
-	isl_ctx *ctx;
-	isl_pw_multi_aff *pma2;
-	int equal;
+	int i;
 
-	if (!pma)
-		return -1;
+	for (i = 0; i < ARRAY_SIZE(box_hull_tests); ++i) {
+		isl_set *set;
+		isl_multi_pw_aff *lower, *upper, *mpa;
+		int equal;
 
-	ctx = isl_pw_multi_aff_get_ctx(pma);
+		set = isl_set_read_from_str(ctx, box_hull_tests[i].set);
+		if (isl_set_box_hull(set, &lower, &upper) < 0)
+			equal = -1;
+		else {
+			mpa = isl_multi_pw_aff_read_from_str(ctx,
+						box_hull_tests[i].lower);
+			equal = isl_multi_pw_aff_is_equal(lower, mpa);
+			isl_multi_pw_aff_free(mpa);
+		}
+		if (equal > 0) {
+			mpa = isl_multi_pw_aff_read_from_str(ctx,
+						box_hull_tests[i].upper);
+			equal = isl_multi_pw_aff_is_equal(upper, mpa);
+			isl_multi_pw_aff_free(mpa);
+		}
+		isl_multi_pw_aff_free(lower);
+		isl_multi_pw_aff_free(upper);
+		isl_set_free(set);
+		if (equal < 0)
+			return -1;
+		if (!equal)
+			isl_die(ctx, isl_error_unknown,
+				"unexpected box hull", return -1);
+	}
+
+	if (isl_set_box_hull(NULL, NULL, NULL) >= 0)
+		isl_die(ctx, isl_error_unknown,
+			"expecting error on NULL input", return -1);
+
+	return 0;
+}
+
+/* Is "pma" obviously equal to the isl_pw_multi_aff represented by "str"?
+ */
+static int pw_multi_aff_plain_is_equal(__isl_keep isl_pw_multi_aff *pma,
+	const char *str)
+{
+	isl_ctx *ctx;
+	isl_pw_multi_aff *pma2;
+	int equal;
+
+	if (!pma)
+		return -1;
+
+	ctx = isl_pw_multi_aff_get_ctx(pma);
 	pma2 = isl_pw_multi_aff_read_from_str(ctx, str);
 	equal = isl_pw_multi_aff_plain_is_equal(pma, pma2);
 	isl_pw_multi_aff_free(pma2);
@@ -3832,26 +4407,46 @@ int test_product(isl_ctx *ctx)
 	return 0;
 }
 
-/* Check that two sets are not considered disjoint just because
- * they have a different set of (named) parameters.
+/* Pairs of sets, along with whether they are disjoint.
+ */
+struct {
+	const char *set1;
+	const char *set2;
+	int disjoint;
+} disjoint_tests[] = {
+	{ "[n] -> { [[]->[]] }", "{ [[]->[]] }", 0 },
+	{ "{ [i] : 0 <= i <= 10 or 20 <= i <= 30 }",
+	  "{ [i] : 11 <= i <= 19 or 31 <= i <= 40 }", 1 },
+	{ "{ [i, j] : 0 <= i <= 10 and j = 2i; [i, j] : 20 <= i <= 30 }",
+	  "{ [i, j] : j = 2i + 1; [i, j] : 25 <= i <= 26 and j = 0 }", 0 },
+	{ "{ [i] : exists (a : i = 2a) and 0 <= i <= 10; [i] : i >= 20 }",
+	  "{ [i] : exists (a : i = 2a + 1) and i <= 15 }", 1 },
+};
+
+/* Check that isl_set_is_disjoint produces the expected result
+ * on the pairs of sets in disjoint_tests.
+ * In particular, check that two sets are not considered disjoint
+ * just because they have a different set of (named) parameters.
  */
 static int test_disjoint(isl_ctx *ctx)
 {
-	const char *str;
-	isl_set *set, *set2;
-	int disjoint;
+	int i;
 
-	str = "[n] -> { [[]->[]] }";
-	set = isl_set_read_from_str(ctx, str);
-	str = "{ [[]->[]] }";
-	set2 = isl_set_read_from_str(ctx, str);
-	disjoint = isl_set_is_disjoint(set, set2);
-	isl_set_free(set);
-	isl_set_free(set2);
-	if (disjoint < 0)
-		return -1;
-	if (disjoint)
-		isl_die(ctx, isl_error_unknown, "unexpected result", return -1);
+	for (i = 0; i < ARRAY_SIZE(disjoint_tests); ++i) {
+		isl_set *set1, *set2;
+		int disjoint;
+
+		set1 = isl_set_read_from_str(ctx, disjoint_tests[i].set1);
+		set2 = isl_set_read_from_str(ctx, disjoint_tests[i].set2);
+		disjoint = isl_set_is_disjoint(set1, set2);
+		isl_set_free(set1);
+		isl_set_free(set2);
+		if (disjoint < 0)
+			return -1;
+		if (disjoint != disjoint_tests[i].disjoint)
+			isl_die(ctx, isl_error_unknown, "unexpected result",
+				return -1);
+	}
 
 	return 0;
 }
@@ -4054,6 +4649,140 @@ int test_output(isl_ctx *ctx)
 	return 0;
 }
 
+/* Check that isl_basic_set_sample finds a point in the basic set
+ * described by "str", which is assumed to be non-empty.
+ */
+static int test_sample_set(isl_ctx *ctx, const char *str)
+{
+	isl_basic_set *bset1, *bset2;
+	int empty, subset;
+
+	bset1 = isl_basic_set_read_from_str(ctx, str);
+	bset2 = isl_basic_set_sample(isl_basic_set_copy(bset1));
+	empty = isl_basic_set_is_empty(bset2);
+	subset = isl_basic_set_is_subset(bset2, bset1);
+	isl_basic_set_free(bset1);
+	isl_basic_set_free(bset2);
+	if (empty < 0 || subset < 0)
+		return -1;
+	if (empty)
+		isl_die(ctx, isl_error_unknown, "point not found", return -1);
+	if (!subset)
+		isl_die(ctx, isl_error_unknown, "bad point found", return -1);
+
+	return 0;
+}
+
+/* Sets that contain integer points, but for which the initial basis
+ * is far from reduced.
+ */
+static const char *sample_skewed_tests[] = {
+	"{ [x, y] : 0 <= 1000x - 999y <= 3 and 0 <= y <= 10000 and "
+	    "2 <= 1001x - 1000y }",
+	"{ [x, y, z] : 0 <= 97x - 89y + 7z <= 2 and "
+	    "0 <= 11x + 13y - 101z <= 2 and 1 <= x + y + z <= 1000 }",
+	"{ [a, b, c, d] : 0 <= 31a - 29b <= 1 and 0 <= 37c - 41d <= 1 and "
+	    "0 <= a + c <= 1000 and 3 <= b + d <= 2000 }",
+};
+
+/* Compute a reduced basis of "bset" and return the width of "bset"
+ * along the first direction of this basis.
+ * The total number of LPs solved while computing the reduced basis,
+ * including those solved by the preconditioning (if any),
+ * is stored in "n_lp".
+ */
+static __isl_give isl_val *reduced_basis_width(__isl_keep isl_basic_set *bset,
+	long *n_lp)
+{
+	int i, n;
+	isl_ctx *ctx;
+	isl_mat *basis;
+	isl_aff *aff;
+	isl_val *v, *min, *max;
+
+	ctx = isl_basic_set_get_ctx(bset);
+	isl_ctx_reset_stats(ctx);
+	basis = isl_basic_set_reduced_basis(bset);
+	*n_lp = isl_ctx_get_stats(ctx)->lp_solves;
+	if (!basis)
+		return NULL;
+
+	aff = isl_aff_zero_on_domain(
+		isl_local_space_from_space(isl_basic_set_get_space(bset)));
+	n = isl_basic_set_dim(bset, isl_dim_set);
+	for (i = 0; i < n; ++i) {
+		v = isl_mat_get_element_val(basis, 1, 1 + i);
+		aff = isl_aff_set_coefficient_val(aff, isl_dim_in, i, v);
+	}
+	isl_mat_free(basis);
+
+	max = isl_basic_set_max_val(bset, aff);
+	aff = isl_aff_neg(aff);
+	min = isl_basic_set_max_val(bset, aff);
+	isl_aff_free(aff);
+
+	return isl_val_add(max, min);
+}
+
+/* Check that the preconditioning of the generalized basis reduction
+ * has an effect on the sets in sample_skewed_tests, without
+ * changing the results.
+ * In particular, check that sampling these sets produces valid results
+ * both with and without preconditioning, that the first direction
+ * of the reduced basis has the same width in both cases and
+ * that the total number of LPs is smaller after preconditioning
+ * for at least one of the sets.
+ * The preconditioning itself solves two LPs per direction,
+ * so for sets where the initial basis is already close to reduced,
+ * the total number of LPs may also increase.
+ */
+static int test_sample_precondition(isl_ctx *ctx)
+{
+	int i, j;
+	int precondition;
+	int equal = 1, fewer = 0;
+	long n_lp[2];
+	isl_basic_set *bset;
+	isl_val *width[2];
+
+	precondition = isl_options_get_gbr_precondition(ctx);
+	for (i = 0; i < ARRAY_SIZE(sample_skewed_tests); ++i) {
+		const char *str = sample_skewed_tests[i];
+
+		bset = isl_basic_set_read_from_str(ctx, str);
+		for (j = 0; j < 2; ++j) {
+			isl_options_set_gbr_precondition(ctx, j);
+			width[j] = reduced_basis_width(bset, &n_lp[j]);
+			if (test_sample_set(ctx, str) < 0)
+				width[j] = isl_val_free(width[j]);
+		}
+		isl_basic_set_free(bset);
+		if (width[0] && width[1] && !isl_val_eq(width[0], width[1]))
+			equal = 0;
+		if (!width[0] || !width[1])
+			equal = -1;
+		isl_val_free(width[0]);
+		isl_val_free(width[1]);
+		if (equal <= 0)
+			break;
+		if (n_lp[1] < n_lp[0])
+			fewer = 1;
+	}
+	isl_options_set_gbr_precondition(ctx, precondition);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"preconditioning changes reduced width", return -1);
+	if (!fewer)
+		isl_die(ctx, isl_error_unknown,
+			"preconditioning does not reduce number of LPs",
+			return -1);
+
+	return 0;
+}
+
 int test_sample(isl_ctx *ctx)
 {
 	const char *str;
@@ -4099,6 +4828,13 @@ int test_sample(isl_ctx *ctx)
 	if (!subset)
 		isl_die(ctx, isl_error_unknown, "bad point found", return -1);
 
+	if (test_sample_precondition(ctx) < 0)
+		return -1;
+
+	str = "{ [a, b, c, d] : 0 <= 3a - 2c <= 1 and c >= 5 }";
+	if (test_sample_set(ctx, str) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -4225,6 +4961,119 @@ static int test_residue_class(isl_ctx *ctx)
 	return res;
 }
 
+/* Models for the parameter alignment in test_align_parameters_repeated,
+ * together with the expected result of aligning
+ * "[a, b, c] -> { [i] : i >= a + 2b + 3c }" to the model.
+ * There are more models than the number of parameter alignments
+ * that are kept in the cache of the isl_ctx.
+ */
+struct {
+	const char *model;
+	const char *res;
+} align_parameters_tests[] = {
+	{ "[c, b, a] -> { : }", "[c, b, a] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[b] -> { : }", "[b, a, c] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[x, a] -> { : }", "[x, a, b, c] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[x] -> { : }", "[x, a, b, c] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[c] -> { : }", "[c, a, b] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[b, a] -> { : }", "[b, a, c] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[y, x, c] -> { : }", "[y, x, c, a, b] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[a, c] -> { : }", "[a, c, b] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[c, x, a] -> { : }", "[c, x, a, b] -> { [i] : i >= a + 2b + 3c }" },
+	{ "[b, c] -> { : }", "[b, c, a] -> { [i] : i >= a + 2b + 3c }" },
+};
+
+/* Align the same set to each of the models in align_parameters_tests
+ * a couple of times, with the cache of parameter alignments enabled,
+ * and check that the results have the expected parameters
+ * in the expected order.
+ */
+static int test_align_parameters_repeated(isl_ctx *ctx)
+{
+	int i, j;
+	int cache;
+	isl_set *set;
+
+	cache = isl_options_get_cache_param_alignments(ctx);
+	isl_options_set_cache_param_alignments(ctx, 1);
+	set = isl_set_read_from_str(ctx,
+				"[a, b, c] -> { [i] : i >= a + 2b + 3c }");
+	for (j = 0; j < 2; ++j) {
+		for (i = 0; i < ARRAY_SIZE(align_parameters_tests); ++i) {
+			isl_set *model, *res, *aligned;
+			int equal;
+
+			model = isl_set_read_from_str(ctx,
+					align_parameters_tests[i].model);
+			res = isl_set_read_from_str(ctx,
+					align_parameters_tests[i].res);
+			aligned = isl_set_align_params(isl_set_copy(set),
+							isl_set_get_space(model));
+			equal = isl_set_has_equal_space(aligned, res);
+			if (equal > 0)
+				equal = isl_set_is_equal(aligned, res);
+			isl_set_free(model);
+			isl_set_free(res);
+			isl_set_free(aligned);
+			if (equal < 0)
+				goto error;
+			if (!equal)
+				isl_die(ctx, isl_error_unknown,
+					"unexpected parameter alignment",
+					goto error);
+		}
+	}
+	isl_set_free(set);
+	isl_options_set_cache_param_alignments(ctx, cache);
+
+	return 0;
+error:
+	isl_set_free(set);
+	isl_options_set_cache_param_alignments(ctx, cache);
+	return -1;
+}
+
+/* Free user pointer of a parameter identifier
+ * in test_align_parameters_free_user.
+ */
+static void free_param_user(void *user)
+{
+	int *freed = user;
+
+	*freed = 1;
+}
+
+/* Check that the user pointer of a parameter identifier is freed
+ * as soon as the last object referring to the identifier is freed,
+ * even if the parameter has been aligned, at least if
+ * the cache of parameter alignments is not enabled.
+ */
+static int test_align_parameters_free_user(isl_ctx *ctx)
+{
+	int freed = 0;
+	int cache;
+	isl_id *id;
+	isl_space *space;
+	isl_set *set;
+
+	cache = isl_options_get_cache_param_alignments(ctx);
+	isl_options_set_cache_param_alignments(ctx, 0);
+	id = isl_id_alloc(ctx, "N", &freed);
+	id = isl_id_set_free_user(id, &free_param_user);
+	space = isl_space_params_alloc(ctx, 1);
+	space = isl_space_set_dim_id(space, isl_dim_param, 0, id);
+	set = isl_set_read_from_str(ctx, "[M] -> { [i] : 0 <= i <= M }");
+	set = isl_set_align_params(set, space);
+	isl_set_free(set);
+	isl_options_set_cache_param_alignments(ctx, cache);
+
+	if (!freed)
+		isl_die(ctx, isl_error_unknown,
+			"user pointer of parameter not freed", return -1);
+
+	return 0;
+}
+
 int test_align_parameters(isl_ctx *ctx)
 {
 	const char *str;
@@ -4253,6 +5102,11 @@ int test_align_parameters(isl_ctx *ctx)
 		isl_die(ctx, isl_error_unknown,
 			"result not as expected", return -1);
 
+	if (test_align_parameters_repeated(ctx) < 0)
+		return -1;
+	if (test_align_parameters_free_user(ctx) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -5008,6 +5862,265 @@ static int test_ast_gen5(isl_ctx *ctx)
 	return 0;
 }
 
+/* Construct an AST for the schedule "schedule_str"
+ * with dependences "deps_str".
+ */
+static __isl_give isl_ast_node *ast_with_dependences(isl_ctx *ctx,
+	const char *schedule_str, const char *deps_str)
+{
+	isl_set *set;
+	isl_union_map *schedule, *deps;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+
+	schedule = isl_union_map_read_from_str(ctx, schedule_str);
+	deps = isl_union_map_read_from_str(ctx, deps_str);
+	set = isl_set_universe(isl_space_params_alloc(ctx, 0));
+	build = isl_ast_build_from_context(set);
+	build = isl_ast_build_set_dependences(build, deps);
+	tree = isl_ast_build_ast_from_schedule(build, schedule);
+	isl_ast_build_free(build);
+
+	return tree;
+}
+
+/* Check that the for loops in the AST generated for the schedule
+ * "schedule_str" with dependences "deps_str" are marked parallel
+ * according to "outer" and "inner" and that the AST is printed as
+ * "printed" when OpenMP pragmas are requested.
+ */
+static int test_ast_gen_parallel(isl_ctx *ctx, const char *schedule_str,
+	const char *deps_str, int outer, int inner, const char *printed)
+{
+	isl_ast_node *tree, *body;
+	isl_printer *p;
+	char *s;
+	int omp;
+	int par_outer, par_inner, equal;
+
+	tree = ast_with_dependences(ctx, schedule_str, deps_str);
+	if (!tree)
+		return -1;
+
+	body = isl_ast_node_for_get_body(tree);
+	par_outer = isl_ast_node_for_is_parallel(tree);
+	par_inner = isl_ast_node_for_is_parallel(body);
+	isl_ast_node_free(body);
+
+	omp = isl_options_get_ast_print_openmp(ctx);
+	isl_options_set_ast_print_openmp(ctx, 1);
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+	p = isl_printer_print_ast_node(p, tree);
+	s = isl_printer_get_str(p);
+	isl_printer_free(p);
+	isl_options_set_ast_print_openmp(ctx, omp);
+	isl_ast_node_free(tree);
+
+	if (par_outer < 0 || par_inner < 0 || !s)
+		goto error;
+	equal = !strcmp(s, printed);
+	free(s);
+	if (par_outer != outer || par_inner != inner)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected parallel loops", return -1);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected OpenMP output", return -1);
+
+	return 0;
+error:
+	free(s);
+	return -1;
+}
+
+/* Data used in print_nested_ast.
+ *
+ * "tree" is the AST that is printed from within the user nodes
+ * of another AST.
+ * "printed" is the result of the last such printing.
+ */
+struct nested_ast_data {
+	isl_ast_node *tree;
+	char *printed;
+};
+
+/* Print a user node of the outer AST by printing data->tree
+ * to a separate printer, using the same print options.
+ * While data->tree is being printed, data->tree is reset
+ * such that its own user nodes are printed as usual.
+ */
+static __isl_give isl_printer *print_nested_ast(__isl_take isl_printer *p,
+	__isl_take isl_ast_print_options *options,
+	__isl_keep isl_ast_node *node, void *user)
+{
+	struct nested_ast_data *data = user;
+	isl_ast_node *tree = data->tree;
+	isl_ast_expr *expr;
+	isl_printer *p2;
+
+	if (!tree) {
+		isl_ast_print_options_free(options);
+		expr = isl_ast_node_user_get_expr(node);
+		p = isl_printer_start_line(p);
+		p = isl_printer_print_ast_expr(p, expr);
+		p = isl_printer_print_str(p, ";");
+		p = isl_printer_end_line(p);
+		isl_ast_expr_free(expr);
+		return p;
+	}
+
+	data->tree = NULL;
+	p2 = isl_printer_to_str(isl_printer_get_ctx(p));
+	p2 = isl_printer_set_output_format(p2, ISL_FORMAT_C);
+	p2 = isl_ast_node_print(tree, p2, options);
+	free(data->printed);
+	data->printed = isl_printer_get_str(p2);
+	isl_printer_free(p2);
+	data->tree = tree;
+
+	p = isl_printer_start_line(p);
+	p = isl_printer_print_str(p, "nested();");
+	p = isl_printer_end_line(p);
+
+	return p;
+}
+
+/* Check that the OpenMP pragmas printed for an AST do not depend
+ * on the printing of another AST that shares the same print options.
+ * In particular, an AST that is printed from within the body
+ * of a loop with a "parallel for" pragma should still get
+ * its own "parallel for" pragma.
+ */
+static int test_ast_gen_parallel_shared_options(isl_ctx *ctx)
+{
+	const char *schedule;
+	struct nested_ast_data data = { NULL, NULL };
+	isl_ast_node *tree;
+	isl_ast_print_options *options;
+	isl_printer *p;
+	int omp, equal;
+
+	schedule = "{ S[i] -> [i] : 0 <= i < 100 }";
+	tree = ast_with_dependences(ctx, schedule, "{ }");
+	schedule = "{ T[i] -> [i] : 0 <= i < 10 }";
+	data.tree = ast_with_dependences(ctx, schedule, "{ }");
+
+	omp = isl_options_get_ast_print_openmp(ctx);
+	isl_options_set_ast_print_openmp(ctx, 1);
+	options = isl_ast_print_options_alloc(ctx);
+	options = isl_ast_print_options_set_print_user(options,
+						&print_nested_ast, &data);
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+	p = isl_ast_node_print(tree, p, options);
+	isl_printer_free(p);
+	isl_options_set_ast_print_openmp(ctx, omp);
+	isl_ast_node_free(tree);
+	isl_ast_node_free(data.tree);
+
+	if (!data.printed)
+		return -1;
+	equal = !strcmp(data.printed,
+		"#pragma omp parallel for simd\n"
+		"for (int c0 = 0; c0 <= 9; c0 += 1)\n"
+		"  T(c0);\n");
+	free(data.printed);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected OpenMP output", return -1);
+
+	return 0;
+}
+
+/* Check that loops that do not carry any dependences are marked parallel
+ * and printed with the appropriate OpenMP pragmas.
+ */
+static int test_ast_gen6(isl_ctx *ctx)
+{
+	const char *schedule;
+
+	schedule = "{ S[i,j] -> [i,j] : 0 <= i,j < 100 }";
+	if (test_ast_gen_parallel(ctx, schedule,
+	    "{ S[i,j] -> S[i + 1,j] : 0 <= i < 99 and 0 <= j < 100 }", 0, 1,
+	    "for (int c0 = 0; c0 <= 99; c0 += 1)\n"
+	    "  #pragma omp parallel for simd\n"
+	    "  for (int c1 = 0; c1 <= 99; c1 += 1)\n"
+	    "    S(c0, c1);\n") < 0)
+		return -1;
+	if (test_ast_gen_parallel(ctx, schedule,
+	    "{ S[i,j] -> S[i,j + 1] : 0 <= i < 100 and 0 <= j < 99 }", 1, 0,
+	    "#pragma omp parallel for\n"
+	    "for (int c0 = 0; c0 <= 99; c0 += 1)\n"
+	    "  for (int c1 = 0; c1 <= 99; c1 += 1)\n"
+	    "    S(c0, c1);\n") < 0)
+		return -1;
+	if (test_ast_gen_parallel(ctx, schedule, "{ }", 1, 1,
+	    "#pragma omp parallel for\n"
+	    "for (int c0 = 0; c0 <= 99; c0 += 1)\n"
+	    "  #pragma omp simd\n"
+	    "  for (int c1 = 0; c1 <= 99; c1 += 1)\n"
+	    "    S(c0, c1);\n") < 0)
+		return -1;
+
+	return 0;
+}
+
+/* Check that isl_ast_build_ast_from_schedule_specialized generates
+ * an AST with a specialized version for each of the parameter domains
+ * that may hold, in order, followed by the generic version.
+ */
+static int test_ast_gen7(isl_ctx *ctx)
+{
+	const char *str;
+	isl_set *set;
+	isl_set_list *contexts;
+	isl_union_map *schedule;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	isl_printer *p;
+	char *s;
+	int equal;
+
+	str = "[N, M] -> { S[i] -> [i] : 0 <= i < N and i < M }";
+	schedule = isl_union_map_read_from_str(ctx, str);
+	contexts = isl_set_list_alloc(ctx, 3);
+	set = isl_set_read_from_str(ctx, "[N, M] -> { : N < 0 }");
+	contexts = isl_set_list_add(contexts, set);
+	set = isl_set_read_from_str(ctx, "[N, M] -> { : N <= M }");
+	contexts = isl_set_list_add(contexts, set);
+	set = isl_set_read_from_str(ctx, "[N, M] -> { : N > M }");
+	contexts = isl_set_list_add(contexts, set);
+	set = isl_set_read_from_str(ctx, "[N, M] -> { : N >= 0 }");
+	build = isl_ast_build_from_context(set);
+	tree = isl_ast_build_ast_from_schedule_specialized(build,
+							schedule, contexts);
+	isl_ast_build_free(build);
+
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+	p = isl_printer_print_ast_node(p, tree);
+	s = isl_printer_get_str(p);
+	isl_printer_free(p);
+	isl_ast_node_free(tree);
+	if (!s)
+		return -1;
+
+	str = "if (M >= N) {\n"
+		"  for (int c0 = 0; c0 < N; c0 += 1)\n"
+		"    S(c0);\n"
+		"} else\n"
+		"  for (int c0 = 0; c0 < M; c0 += 1)\n"
+		"    S(c0);\n";
+	equal = !strcmp(s, str);
+	free(s);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected specialized AST", return -1);
+
+	return 0;
+}
+
 static int test_ast_gen(isl_ctx *ctx)
 {
 	if (test_ast_gen1(ctx) < 0)
@@ -5020,6 +6133,12 @@ static int test_ast_gen(isl_ctx *ctx)
 		return -1;
 	if (test_ast_gen5(ctx) < 0)
 		return -1;
+	if (test_ast_gen6(ctx) < 0)
+		return -1;
+	if (test_ast_gen_parallel_shared_options(ctx) < 0)
+		return -1;
+	if (test_ast_gen7(ctx) < 0)
+		return -1;
 	return 0;
 }
 
@@ -5160,12 +6279,16 @@ static int test_partial_lexmin(isl_ctx *ctx)
 /* Check that the variable compression performed on the existentially
  * quantified variables inside isl_basic_set_compute_divs is not confused
  * by the implicit equalities among the parameters.
+ * Also check that existentially quantified variables that are fixed
+ * by a pair of inequalities and an equality are turned
+ * into a single basic set.
  */
 static int test_compute_divs(isl_ctx *ctx)
 {
 	const char *str;
+	int n, equal;
 	isl_basic_set *bset;
-	isl_set *set;
+	isl_set *set, *set2;
 
 	str = "[a, b, c, d, e] -> { [] : exists (e0: 2d = b and a <= 124 and "
 		"b <= 2046 and b >= 0 and b <= 60 + 64a and 2e >= b + 2c and "
@@ -5177,6 +6300,22 @@ static int test_compute_divs(isl_ctx *ctx)
 	if (!set)
 		return -1;
 
+	str = "{ [i, j] : exists (a, b : 3a = i + 2b and 2b <= j + 1 and "
+		"2b >= j and 0 <= i <= 10) }";
+	bset = isl_basic_set_read_from_str(ctx, str);
+	set = isl_basic_set_compute_divs(isl_basic_set_copy(bset));
+	set2 = isl_set_from_basic_set(bset);
+	n = isl_set_n_basic_set(set);
+	equal = isl_set_is_equal(set, set2);
+	isl_set_free(set);
+	isl_set_free(set2);
+	if (n < 0 || equal < 0)
+		return -1;
+	if (n != 1 || !equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of isl_basic_set_compute_divs",
+			return -1);
+
 	return 0;
 }
 
@@ -5354,6 +6493,641 @@ static int test_tile(isl_ctx *ctx)
 	return 0;
 }
 
+/* Check that compacting objects does not change their meaning.
+ * For the intersection, the room left for the constraints that
+ * got removed during simplification should be reclaimed.
+ * In particular, the old blocks should not be kept
+ * in the block cache of the isl_ctx.
+ */
+static int test_compact_explicit(isl_ctx *ctx)
+{
+	int equal;
+	int n_cached;
+	size_t before;
+	const char *str;
+	isl_set *set, *set2;
+	isl_union_map *umap, *umap2;
+	isl_union_set *dom;
+	isl_schedule_constraints *sc;
+	isl_schedule *schedule;
+
+	set = isl_set_read_from_str(ctx, "{ [i, j] : 0 <= i <= 10 }");
+	set2 = isl_set_read_from_str(ctx, "{ [i, j] : 0 <= i <= 20 and j >= 0 }");
+	set = isl_set_intersect(set, set2);
+	set2 = isl_set_copy(set);
+	before = isl_ctx_get_compacted_bytes(ctx);
+	isl_blk_clear_cache(ctx);
+	set = isl_set_compact(set);
+	n_cached = ctx->n_cached;
+	equal = isl_set_is_equal(set, set2);
+	isl_set_free(set);
+	isl_set_free(set2);
+	if (equal < 0)
+		return -1;
+	if (!equal || isl_ctx_get_compacted_bytes(ctx) <= before ||
+	    n_cached != 0)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of set compaction", return -1);
+
+	str = "{ S[i] -> T[i + 1] : 0 <= i <= 10; T[i] -> S[i] : i >= 0 }";
+	umap = isl_union_map_read_from_str(ctx, str);
+	str = "{ S[i] -> S[i]; T[i] -> T[i] }";
+	umap = isl_union_map_apply_range(umap,
+				isl_union_map_read_from_str(ctx, str));
+	umap2 = isl_union_map_copy(umap);
+	umap = isl_union_map_compact(umap);
+	equal = isl_union_map_is_equal(umap, umap2);
+	isl_union_map_free(umap2);
+	if (equal < 0 || !equal) {
+		isl_union_map_free(umap);
+		if (equal < 0)
+			return -1;
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of union map compaction", return -1);
+	}
+
+	dom = isl_union_map_domain(isl_union_map_copy(umap));
+	sc = isl_schedule_constraints_on_domain(dom);
+	sc = isl_schedule_constraints_set_validity(sc, umap);
+	schedule = isl_schedule_constraints_compute_schedule(sc);
+	umap = isl_schedule_get_map(schedule);
+	schedule = isl_schedule_compact(schedule);
+	umap2 = isl_schedule_get_map(schedule);
+	isl_schedule_free(schedule);
+	equal = isl_union_map_is_equal(umap, umap2);
+	isl_union_map_free(umap);
+	isl_union_map_free(umap2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of schedule compaction", return -1);
+
+	return 0;
+}
+
+/* Progress callback for test_cancel that cancels the computation
+ * through the cancellation token attached to "ctx" after a few calls.
+ */
+static int cancel_after_progress(isl_ctx *ctx, unsigned long operations,
+	void *user)
+{
+	int *n = user;
+
+	if (++*n == 3)
+		isl_cancel_token_cancel(isl_ctx_get_cancel_token(ctx));
+	return 0;
+}
+
+/* Progress callback for test_cancel that stops the computation
+ * by returning an error.
+ */
+static int stop_progress(isl_ctx *ctx, unsigned long operations, void *user)
+{
+	return -1;
+}
+
+/* Check that a computation is aborted when the cancellation token
+ * attached to "ctx" is cancelled or when the progress callback
+ * returns an error, and that it proceeds normally afterwards.
+ */
+static int test_cancel(isl_ctx *ctx)
+{
+	int n = 0;
+	int on_error, equal;
+	const char *str;
+	isl_cancel_token *token;
+	isl_map *map1, *map2, *res;
+
+	str = "{ [i, j] -> [a, b] : 0 <= a <= 100 and 0 <= b <= 100 and "
+		"i + j <= a + b <= 2i + 3j }";
+	map1 = isl_map_read_from_str(ctx, str);
+	str = "{ [i, j] -> [a, b] : 0 <= a <= 50 and b = 2a - i }";
+	map2 = isl_map_read_from_str(ctx, str);
+
+	token = isl_cancel_token_alloc();
+	if (!token)
+		goto error;
+	on_error = isl_options_get_on_error(ctx);
+	isl_options_set_on_error(ctx, ISL_ON_ERROR_CONTINUE);
+	isl_ctx_set_cancel_token(ctx, token);
+	isl_ctx_set_progress_callback(ctx, 10, &cancel_after_progress, &n);
+	res = isl_map_subtract(isl_map_copy(map1), isl_map_copy(map2));
+	res = isl_map_lexmin(res);
+	isl_map_free(res);
+	if (res || isl_ctx_last_error(ctx) != isl_error_abort ||
+	    isl_cancel_token_is_cancelled(token) != 1 || n != 3) {
+		isl_ctx_set_cancel_token(ctx, NULL);
+		isl_ctx_set_progress_callback(ctx, 0, NULL, NULL);
+		isl_options_set_on_error(ctx, on_error);
+		isl_cancel_token_free(token);
+		isl_die(ctx, isl_error_unknown,
+			"computation should have been cancelled", goto error);
+	}
+	isl_ctx_reset_error(ctx);
+
+	isl_ctx_set_progress_callback(ctx, 10, &stop_progress, NULL);
+	isl_cancel_token_reset(token);
+	res = isl_map_subtract(isl_map_copy(map1), isl_map_copy(map2));
+	isl_map_free(res);
+	isl_ctx_set_progress_callback(ctx, 0, NULL, NULL);
+	isl_ctx_set_cancel_token(ctx, NULL);
+	isl_cancel_token_free(token);
+	isl_options_set_on_error(ctx, on_error);
+	if (res || isl_ctx_last_error(ctx) != isl_error_abort)
+		isl_die(ctx, isl_error_unknown,
+			"computation should have been stopped", goto error);
+	isl_ctx_reset_error(ctx);
+
+	res = isl_map_subtract(isl_map_copy(map1), isl_map_copy(map2));
+	equal = isl_map_is_equal(res, map1);
+	isl_map_free(res);
+	isl_map_free(map1);
+	isl_map_free(map2);
+	if (equal < 0)
+		return -1;
+	if (equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result", return -1);
+
+	return 0;
+error:
+	isl_map_free(map1);
+	isl_map_free(map2);
+	return -1;
+}
+
+/* Check that a rejected isl_ctx_reset does not drop the caches
+ * of the context, while a successful isl_ctx_reset does,
+ * even if the caches are not empty.
+ * In particular, "space" remains interned after the rejected reset,
+ * so that reversing it does not affect the cached domain "dom1".
+ * Parameter alignment is performed to fill up the other cache.
+ */
+static int test_ctx_reset_cached(isl_ctx *ctx)
+{
+	isl_ctx *ctx2;
+	isl_space *space, *dom1, *dom2;
+	isl_map *map1, *map2;
+	const char *name;
+	int reset, ok;
+
+	ctx2 = isl_ctx_alloc();
+	if (!ctx2)
+		return -1;
+	isl_options_set_on_error(ctx2, ISL_ON_ERROR_CONTINUE);
+	isl_options_set_intern_spaces(ctx2, 1);
+	isl_options_set_cache_param_alignments(ctx2, 1);
+	map1 = isl_map_read_from_str(ctx2, "[n] -> { A[i] -> B[i] : i < n }");
+	map2 = isl_map_read_from_str(ctx2, "[m] -> { A[i] -> B[i] : i > m }");
+	map1 = isl_map_intersect(map1, map2);
+	isl_map_free(map1);
+
+	space = isl_space_alloc(ctx2, 0, 1, 1);
+	space = isl_space_set_tuple_name(space, isl_dim_in, "B");
+	space = isl_space_set_tuple_name(space, isl_dim_out, "A");
+	space = isl_space_reverse(space);
+	dom1 = isl_space_domain(isl_space_copy(space));
+	reset = isl_ctx_reset(ctx2);
+	ok = reset < 0 && isl_ctx_last_error(ctx2) == isl_error_invalid;
+	space = isl_space_reverse(space);
+	dom2 = isl_space_domain(space);
+	name = isl_space_get_tuple_name(dom2, isl_dim_set);
+	ok = ok && dom1 && dom2 && dom1 != dom2 && name && !strcmp(name, "B");
+	isl_space_free(dom1);
+	isl_space_free(dom2);
+	isl_ctx_reset_error(ctx2);
+
+	reset = isl_ctx_reset(ctx2);
+	ok = ok && reset == 0 && isl_ctx_last_error(ctx2) == isl_error_none;
+	isl_ctx_free(ctx2);
+
+	if (!ok)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of context reset", return -1);
+
+	return 0;
+}
+
+/* Check that isl_ctx_reset fails while objects still reference
+ * the context and that it otherwise drops the state of the context
+ * such that it can be reused for further computations.
+ */
+static int test_ctx_reset(isl_ctx *ctx)
+{
+	isl_ctx *ctx2;
+	isl_map *map, *res;
+	isl_id *id;
+	const char *str;
+	int equal, reset, ok;
+
+	ctx2 = isl_ctx_alloc();
+	if (!ctx2)
+		return -1;
+	isl_options_set_on_error(ctx2, ISL_ON_ERROR_CONTINUE);
+	str = "[n] -> { [i] -> [j] : 0 <= j <= n and j >= i }";
+	map = isl_map_read_from_str(ctx2, str);
+	id = isl_id_alloc(ctx2, "A", NULL);
+	map = isl_map_set_tuple_id(map, isl_dim_in, id);
+	res = isl_map_lexmin(isl_map_copy(map));
+	isl_ctx_set_max_operations(ctx2, 1000000);
+	reset = isl_ctx_reset(ctx2);
+	ok = reset < 0 && isl_ctx_last_error(ctx2) == isl_error_invalid;
+	isl_map_free(map);
+	isl_map_free(res);
+	reset = isl_ctx_reset(ctx2);
+	ok = ok && reset == 0 && isl_ctx_last_error(ctx2) == isl_error_none;
+	ok = ok && isl_ctx_get_operations(ctx2) == 0;
+	ok = ok && isl_ctx_get_stats(ctx2)->tab_pivots == 0;
+	ok = ok && isl_ctx_get_max_operations(ctx2) == 0;
+	ok = ok && isl_options_get_on_error(ctx2) == ISL_ON_ERROR_CONTINUE;
+
+	map = isl_map_read_from_str(ctx2, str);
+	map = isl_map_lexmin(map);
+	res = isl_map_read_from_str(ctx2,
+				"[n] -> { [i] -> [i] : 0 <= i <= n; "
+				"[i] -> [0] : i < 0 and n >= 0 }");
+	equal = isl_map_is_equal(map, res);
+	isl_map_free(map);
+	isl_map_free(res);
+	isl_ctx_free(ctx2);
+
+	if (equal < 0)
+		return -1;
+	if (!ok || !equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of context reset", return -1);
+
+	return test_ctx_reset_cached(ctx);
+}
+
+/* Coalesce the set described by "str".
+ */
+static int perf_coalesce(isl_ctx *ctx, const char *str)
+{
+	isl_set *set;
+
+	set = isl_set_read_from_str(ctx, str);
+	set = isl_set_coalesce(set);
+	isl_set_free(set);
+
+	return set ? 0 : -1;
+}
+
+/* Compute the lexicographic minimum of the map described by "str".
+ */
+static int perf_lexmin(isl_ctx *ctx, const char *str)
+{
+	isl_map *map;
+
+	map = isl_map_read_from_str(ctx, str);
+	map = isl_map_lexmin(map);
+	isl_map_free(map);
+
+	return map ? 0 : -1;
+}
+
+/* Compute a schedule for the statements involved in the dependences
+ * described by "str", using these dependences both as validity
+ * and as proximity constraints.
+ */
+static int perf_schedule(isl_ctx *ctx, const char *str)
+{
+	isl_union_map *dep;
+	isl_union_set *dom;
+	isl_schedule_constraints *sc;
+	isl_schedule *schedule;
+
+	dep = isl_union_map_read_from_str(ctx, str);
+	dom = isl_union_map_domain(isl_union_map_copy(dep));
+	dom = isl_union_set_union(dom,
+				isl_union_map_range(isl_union_map_copy(dep)));
+	sc = isl_schedule_constraints_on_domain(dom);
+	sc = isl_schedule_constraints_set_validity(sc,
+						isl_union_map_copy(dep));
+	sc = isl_schedule_constraints_set_proximity(sc, dep);
+	schedule = isl_schedule_constraints_compute_schedule(sc);
+	isl_schedule_free(schedule);
+
+	return schedule ? 0 : -1;
+}
+
+/* Maximal increase (in percent) of any of the counters in perf_tests
+ * with respect to the recorded values before a test is considered
+ * to have failed.
+ */
+#define PERF_TOLERANCE	10
+
+/* Deterministic performance regression tests.
+ * Each entry describes a computation "fn" on the input "str",
+ * along with the number of operations, tableau pivots,
+ * tableau allocations and LP solves that were recorded
+ * when the entry was added.
+ * If a change to isl legitimately changes these numbers,
+ * then the entries should be updated with the values reported
+ * by test_perf.
+ */
+struct {
+	const char *name;
+	int (*fn)(isl_ctx *ctx, const char *str);
+	const char *str;
+	unsigned long operations;
+	long tab_pivots;
+	long tab_allocs;
+	long lp_solves;
+} perf_tests[] = {
+	{ "coalesce", &perf_coalesce,
+	  "[n] -> { [i, j] : 0 <= i <= n and 0 <= j <= i; "
+		"[i, j] : 0 <= i <= n and i < j <= n; "
+		"[i, j] : n < i <= 2n and 0 <= j <= n; "
+		"[i, j] : 0 <= i <= 2n and n < j <= 2n and i + j <= 3n; "
+		"[i, j] : 0 <= i <= 2n and j > n and i + j > 3n and "
+			"j <= 2n }",
+	  5338, 110, 22, 0 },
+	{ "lexmin", &perf_lexmin,
+	  "[n, m] -> { [i, j] -> [a, b, c] : 0 <= a <= n and "
+		"0 <= b <= m and a + b >= i + j and 2a - b <= i and "
+		"c >= a - j and c >= b - i and 3c <= a + b + n }",
+	  6517, 670, 28, 6 },
+	{ "schedule", &perf_schedule,
+	  "[n] -> { S[i, j] -> S[i, j + 1] : 0 <= i, j < n; "
+		"S[i, j] -> S[i + 1, j] : 0 <= i, j < n; "
+		"S[i, j] -> S[i + 1, j - 1] : 0 <= i < n and 0 < j < n; "
+		"S[i, j] -> T[j, i] : 0 <= i, j < n; "
+		"T[i, j] -> T[i, j + 1] : 0 <= i, j < n; "
+		"T[i, j] -> U[i + j] : 0 <= i, j < n; "
+		"U[k] -> U[k + 1] : 0 <= k < 2n }",
+	  10255, 343, 54, 0 },
+};
+
+/* Has "measured" increased by more than PERF_TOLERANCE percent
+ * with respect to "recorded"?
+ */
+static int perf_exceeds(unsigned long measured, unsigned long recorded)
+{
+	return 100 * measured > (100 + PERF_TOLERANCE) * recorded;
+}
+
+/* Run the performance regression tests in perf_tests and
+ * check that none of the counters has increased significantly
+ * with respect to the recorded values.
+ * Each test is run in a fresh context with default options
+ * such that the counters are not affected by the state of "ctx"
+ * or by the options passed to isl_test.
+ * The measured values are printed on failure such that
+ * the table can be updated after an intended change.
+ */
+static int test_perf(isl_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(perf_tests); ++i) {
+		isl_ctx *perf_ctx;
+		const struct isl_stats *stats;
+		unsigned long operations;
+		int r, exceeds;
+
+		perf_ctx = isl_ctx_alloc();
+		if (!perf_ctx)
+			return -1;
+		r = perf_tests[i].fn(perf_ctx, perf_tests[i].str);
+		operations = isl_ctx_get_operations(perf_ctx);
+		stats = isl_ctx_get_stats(perf_ctx);
+		exceeds = perf_exceeds(operations, perf_tests[i].operations) ||
+		    perf_exceeds(stats->tab_pivots, perf_tests[i].tab_pivots) ||
+		    perf_exceeds(stats->tab_allocs, perf_tests[i].tab_allocs) ||
+		    perf_exceeds(stats->lp_solves, perf_tests[i].lp_solves);
+		if (r >= 0 && exceeds)
+			fprintf(stderr, "%s: operations: %lu, pivots: %ld, "
+				"tableaus: %ld, LP solves: %ld\n",
+				perf_tests[i].name, operations,
+				stats->tab_pivots, stats->tab_allocs,
+				stats->lp_solves);
+		isl_ctx_free(perf_ctx);
+		if (r < 0)
+			return -1;
+		if (exceeds)
+			isl_die(ctx, isl_error_unknown,
+				"performance regression", return -1);
+	}
+
+	return 0;
+}
+
+/* Check that isl_union_map_intersect_domain produces the same result
+ * on a union map that is not shared (and that is therefore modified
+ * in place) as on a shared union map, in particular when
+ * many of the maps get removed, and that the remaining maps
+ * can still be found in the result.
+ */
+static int test_union_map_inplace(isl_ctx *ctx)
+{
+	int i, n, equal;
+	char buffer[100];
+	isl_space *space;
+	isl_map *map;
+	isl_union_map *umap, *umap2;
+	isl_union_set *dom;
+
+	space = isl_space_params_alloc(ctx, 0);
+	umap = isl_union_map_empty(isl_space_copy(space));
+	dom = isl_union_set_empty(space);
+	for (i = 0; i < 40; ++i) {
+		snprintf(buffer, sizeof(buffer),
+			"{ S%d[i] -> S%d[i + 1] : 0 <= i <= %d }", i, i, i);
+		map = isl_map_read_from_str(ctx, buffer);
+		umap = isl_union_map_add_map(umap, map);
+		if (i % 3 != 0)
+			continue;
+		snprintf(buffer, sizeof(buffer), "{ S%d[i] : i >= 1 }", i);
+		dom = isl_union_set_add_set(dom,
+					isl_set_read_from_str(ctx, buffer));
+	}
+
+	umap2 = isl_union_map_intersect_domain(isl_union_map_copy(umap),
+						isl_union_set_copy(dom));
+	umap = isl_union_map_intersect_domain(umap, dom);
+	equal = isl_union_map_is_equal(umap, umap2);
+	isl_union_map_free(umap2);
+	n = isl_union_map_n_map(umap);
+	for (i = 0; equal == 1 && i < 40; ++i) {
+		int empty;
+
+		snprintf(buffer, sizeof(buffer), "{ S%d[i] -> S%d[j] }", i, i);
+		map = isl_map_read_from_str(ctx, buffer);
+		space = isl_map_get_space(map);
+		isl_map_free(map);
+		map = isl_union_map_extract_map(umap, space);
+		empty = isl_map_is_empty(map);
+		isl_map_free(map);
+		if (empty < 0)
+			equal = -1;
+		else if (empty != (i == 0 || i % 3 != 0))
+			equal = 0;
+	}
+	isl_union_map_free(umap);
+	if (equal < 0 || n < 0)
+		return -1;
+	if (!equal || n != 13)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result of in-place operation", return -1);
+
+	return 0;
+}
+
+/* Check that operations still produce the expected result
+ * when basic sets are compacted as they are added to a set.
+ */
+static int test_compact_on_add(isl_ctx *ctx)
+{
+	int compact;
+	int equal;
+	isl_set *set, *set2;
+
+	compact = isl_options_get_compact(ctx);
+	isl_options_set_compact(ctx, 1);
+	set = isl_set_read_from_str(ctx, "{ [i, j] : 0 <= i <= 10 }");
+	set2 = isl_set_read_from_str(ctx, "{ [i, j] : 0 <= i <= 20 and j >= 0 }");
+	set = isl_set_intersect(set, set2);
+	set2 = isl_set_read_from_str(ctx, "{ [i, j] : i <= 12 and j >= 0 }");
+	set = isl_set_intersect(set, set2);
+	isl_options_set_compact(ctx, compact);
+
+	set2 = isl_set_read_from_str(ctx, "{ [i, j] : 0 <= i <= 10 and j >= 0 }");
+	equal = isl_set_is_equal(set, set2);
+	isl_set_free(set);
+	isl_set_free(set2);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected result with automatic compaction",
+			return -1);
+
+	return 0;
+}
+
+static int test_compact(isl_ctx *ctx)
+{
+	int compact, r;
+
+	compact = isl_options_get_compact(ctx);
+	isl_options_set_compact(ctx, 0);
+	r = test_compact_explicit(ctx);
+	isl_options_set_compact(ctx, compact);
+	if (r < 0)
+		return -1;
+	if (test_compact_on_add(ctx) < 0)
+		return -1;
+	return 0;
+}
+
+/* Check that clearing the space table also forgets the results
+ * cached in spaces that remain alive, such that these spaces
+ * can safely be modified in place and interned again.
+ * In particular, after the table has been cleared, "space" is
+ * only referenced once and is therefore reversed in place.
+ * Its domain should then be recomputed rather than taken
+ * from the result cached before the table was cleared.
+ */
+static int test_intern_clear(isl_ctx *ctx)
+{
+	int ok;
+	int intern;
+	const char *name;
+	isl_space *space, *dom1, *dom2;
+
+	intern = isl_options_get_intern_spaces(ctx);
+	isl_options_set_intern_spaces(ctx, 1);
+
+	space = isl_space_alloc(ctx, 0, 1, 1);
+	space = isl_space_set_tuple_name(space, isl_dim_in, "B");
+	space = isl_space_set_tuple_name(space, isl_dim_out, "A");
+	space = isl_space_reverse(space);
+	dom1 = isl_space_domain(isl_space_copy(space));
+	isl_space_clear_interned(ctx);
+	space = isl_space_reverse(space);
+	dom2 = isl_space_domain(space);
+	name = isl_space_get_tuple_name(dom2, isl_dim_set);
+	ok = dom1 && dom2 && dom1 != dom2 && name && !strcmp(name, "B");
+	isl_space_free(dom1);
+	isl_space_free(dom2);
+
+	isl_options_set_intern_spaces(ctx, intern);
+
+	if (!ok)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected domain after clearing space table",
+			return -1);
+
+	return 0;
+}
+
+/* Check that identical spaces are shared when the intern_spaces option
+ * is set, that shared spaces are not modified in place and
+ * that operations on objects still produce the expected results.
+ */
+static int test_intern_spaces(isl_ctx *ctx)
+{
+	int intern;
+	int equal, same;
+	const char *name;
+	const char *str;
+	isl_space *space, *rev1, *rev2, *rr, *mod;
+	isl_union_map *umap1, *umap2, *umap3;
+
+	intern = isl_options_get_intern_spaces(ctx);
+	isl_options_set_intern_spaces(ctx, 1);
+
+	space = isl_space_alloc(ctx, 1, 2, 3);
+	space = isl_space_set_tuple_name(space, isl_dim_in, "A");
+	space = isl_space_set_tuple_name(space, isl_dim_out, "B");
+	rev1 = isl_space_reverse(isl_space_copy(space));
+	rev2 = isl_space_reverse(isl_space_copy(space));
+	same = rev1 && rev1 == rev2;
+	isl_space_free(rev2);
+	rr = isl_space_reverse(isl_space_copy(rev1));
+	equal = isl_space_is_equal(rr, space);
+	rev2 = isl_space_reverse(isl_space_copy(rev1));
+	same = same && rr == rev2;
+	isl_space_free(rev2);
+	isl_space_free(rr);
+	mod = isl_space_set_tuple_name(isl_space_copy(rev1), isl_dim_in, "C");
+	name = isl_space_get_tuple_name(rev1, isl_dim_in);
+	same = same && mod != rev1 && name && !strcmp(name, "B");
+	isl_space_free(mod);
+	isl_space_free(rev1);
+	isl_space_free(space);
+	if (equal < 0)
+		same = -1;
+
+	str = "{ A[i] -> B[i + 1]; A[i] -> C[i] }";
+	umap1 = isl_union_map_read_from_str(ctx, str);
+	str = "{ B[i] -> D[2i]; C[i] -> D[i] }";
+	umap2 = isl_union_map_read_from_str(ctx, str);
+	umap1 = isl_union_map_apply_range(umap1, umap2);
+	umap1 = isl_union_map_apply_range(umap1,
+					isl_union_map_reverse(isl_union_map_copy(umap1)));
+	str = "{ A[i] -> A[j] : j = i or j = 2i + 2 or i = 2j + 2 }";
+	umap3 = isl_union_map_read_from_str(ctx, str);
+	equal = isl_union_map_is_equal(umap1, umap3);
+	isl_union_map_free(umap1);
+	isl_union_map_free(umap3);
+
+	isl_options_set_intern_spaces(ctx, intern);
+
+	if (same < 0 || equal < 0)
+		return -1;
+	if (!same)
+		isl_die(ctx, isl_error_unknown,
+			"identical spaces not shared", return -1);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected result", return -1);
+
+	return 0;
+}
+
 struct {
 	const char *name;
 	int (*fn)(isl_ctx *ctx);
@@ -5370,6 +7144,13 @@ struct {
 	{ "conversion", &test_conversion },
 	{ "list", &test_list },
 	{ "align parameters", &test_align_parameters },
+	{ "intern spaces", &test_intern_spaces },
+	{ "clear interned spaces", &test_intern_clear },
+	{ "compact", &test_compact },
+	{ "union map in place", &test_union_map_inplace },
+	{ "cancel", &test_cancel },
+	{ "context reset", &test_ctx_reset },
+	{ "performance", &test_perf },
 	{ "preimage", &test_preimage },
 	{ "pullback", &test_pullback },
 	{ "AST", &test_ast },
@@ -5388,6 +7169,7 @@ struct {
 	{ "disjoint", &test_disjoint },
 	{ "product", &test_product },
 	{ "dim_max", &test_dim_max },
+	{ "box hull", &test_box_hull },
 	{ "affine", &test_aff },
 	{ "injective", &test_injective },
 	{ "schedule", &test_schedule },
@@ -5400,7 +7182,9 @@ struct {
 	{ "factorize", &test_factorize },
 	{ "subset", &test_subset },
 	{ "subtract", &test_subtract },
+	{ "make disjoint", &test_make_disjoint },
 	{ "lexmin", &test_lexmin },
+	{ "quast", &test_quast },
 	{ "min", &test_min },
 	{ "gist", &test_gist },
 	{ "piecewise quasi-polynomials", &test_pwqp },
@@ -21,6 +21,7 @@
 #include <isl/map.h>
 #include <isl/set.h>
 #include <isl_space_private.h>
+#include <isl_sort.h>
 #include <isl/union_set.h>
 #include <isl/deprecated/union_map_int.h>
 
@@ -192,6 +193,33 @@ __isl_give isl_union_map *isl_union_map_cow(__isl_take isl_union_map *umap)
 	return isl_union_map_dup(umap);
 }
 
+static int compact_entry(void **entry, void *user)
+{
+	*entry = isl_map_compact(*entry);
+
+	return 0;
+}
+
+/* Compact each of the maps in "umap".
+ * Since this does not change the meaning of "umap",
+ * the maps are modified in place, even if "umap" is shared.
+ */
+__isl_give isl_union_map *isl_union_map_compact(__isl_take isl_union_map *umap)
+{
+	if (!umap)
+		return NULL;
+
+	isl_hash_table_foreach(umap->dim->ctx, &umap->table,
+				&compact_entry, NULL);
+
+	return umap;
+}
+
+__isl_give isl_union_set *isl_union_set_compact(__isl_take isl_union_set *uset)
+{
+	return isl_union_map_compact(uset);
+}
+
 struct isl_union_align {
 	isl_reordering *exp;
 	isl_union_map *res;
@@ -577,9 +605,126 @@ int isl_union_set_foreach_point(__isl_keep isl_union_set *uset,
 	return isl_union_set_foreach_set(uset, &foreach_point, &data);
 }
 
+/* Internal data structure for collecting the results of an operation
+ * on the maps of "umap" that does not change the spaces of the maps.
+ *
+ * If "inplace" is set, then the caller holds the only reference
+ * to "umap" and the results replace the original maps
+ * in the hash table of "umap".
+ * Otherwise, the results are collected in "res".
+ */
+struct isl_union_map_collect {
+	isl_union_map *umap;
+	int inplace;
+	isl_union_map *res;
+};
+
+/* Prepare "collect" for collecting the results of an operation
+ * on the maps of "umap".
+ * The results are stored in place if "umap" is not shared,
+ * unless "same_space" is not set, i.e., unless the operation
+ * may change the spaces of the maps.
+ */
+static int collect_init(struct isl_union_map_collect *collect,
+	__isl_keep isl_union_map *umap, int same_space)
+{
+	collect->umap = umap;
+	collect->inplace = same_space && umap->ref == 1;
+	collect->res = NULL;
+	if (collect->inplace)
+		return 0;
+	collect->res = isl_union_map_alloc(isl_space_copy(umap->dim),
+					   umap->table.n);
+	return collect->res ? 0 : -1;
+}
+
+/* Call "fn" on each map of collect->umap.
+ * If the results are collected in place, then "fn" returns 1
+ * for the maps that should be removed from the hash table.
+ */
+static int collect_foreach(struct isl_union_map_collect *collect,
+	int (*fn)(void **entry, void *user), void *user)
+{
+	isl_union_map *umap = collect->umap;
+
+	if (collect->inplace)
+		return isl_hash_table_foreach_remove(umap->dim->ctx,
+						&umap->table, fn, user);
+	return isl_hash_table_foreach(umap->dim->ctx, &umap->table, fn, user);
+}
+
+/* Return the map in "entry" for use as input to the operation.
+ * If the results are collected in place, then the map is taken
+ * out of the hash table, to avoid copying it in the operation.
+ * It is put back by collect_add.
+ */
+static __isl_give isl_map *collect_take(struct isl_union_map_collect *collect,
+	void **entry)
+{
+	isl_map *map = *entry;
+
+	if (!collect->inplace)
+		return isl_map_copy(map);
+	*entry = NULL;
+	return map;
+}
+
+/* Drop the map in "entry" from the result of the operation.
+ * "map" is the result of the operation on this map, if any.
+ */
+static int collect_drop(struct isl_union_map_collect *collect, void **entry,
+	__isl_take isl_map *map)
+{
+	isl_map_free(map);
+	if (!collect->inplace)
+		return 0;
+	isl_map_free(*entry);
+	*entry = NULL;
+	return 1;
+}
+
+/* Add "map", the result of the operation on the map in "entry",
+ * to the result.
+ * Plainly empty maps are not stored, as in isl_union_map_add_map.
+ */
+static int collect_add(struct isl_union_map_collect *collect, void **entry,
+	__isl_take isl_map *map)
+{
+	if (!collect->inplace) {
+		collect->res = isl_union_map_add_map(collect->res, map);
+		return collect->res ? 0 : -1;
+	}
+	if (!map)
+		return -1;
+	if (isl_map_plain_is_empty(map))
+		return collect_drop(collect, entry, map);
+	*entry = map;
+	return 0;
+}
+
+/* Return the result of the operation, consuming collect->umap.
+ */
+static __isl_give isl_union_map *collect_finish(
+	struct isl_union_map_collect *collect)
+{
+	if (collect->inplace)
+		return collect->umap;
+	isl_union_map_free(collect->umap);
+	return collect->res;
+}
+
+/* Free the partial result of an operation that has failed,
+ * along with collect->umap.
+ */
+static void collect_free(struct isl_union_map_collect *collect)
+{
+	isl_union_map_free(collect->umap);
+	isl_union_map_free(collect->res);
+}
+
 struct isl_union_map_gen_bin_data {
 	isl_union_map *umap2;
-	isl_union_map *res;
+	struct isl_union_map_collect collect;
 };
 
 static int subtract_entry(void **entry, void *user)
@@ -592,7 +737,7 @@ static int subtract_entry(void **entry, void *user)
 	hash = isl_space_get_hash(map->dim);
 	entry2 = isl_hash_table_find(data->umap2->dim->ctx, &data->umap2->table,
 				     hash, &has_dim, map->dim, 0);
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	if (entry2) {
 		int empty;
 		map = isl_map_subtract(map, isl_map_copy(entry2->data));
@@ -602,20 +747,21 @@ static int subtract_entry(void **entry, void *user)
 			isl_map_free(map);
 			return -1;
 		}
-		if (empty) {
-			isl_map_free(map);
-			return 0;
-		}
+		if (empty)
+			return collect_drop(&data->collect, entry, map);
 	}
-	data->res = isl_union_map_add_map(data->res, map);
 
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
+/* Apply "fn" to each map in "umap1" and collect the results.
+ * "fn" does not change the spaces of the maps, so if "umap1"
+ * is not shared, then the results are stored in "umap1" itself.
+ */
 static __isl_give isl_union_map *gen_bin_op(__isl_take isl_union_map *umap1,
 	__isl_take isl_union_map *umap2, int (*fn)(void **, void *))
 {
-	struct isl_union_map_gen_bin_data data = { NULL, NULL };
+	struct isl_union_map_gen_bin_data data;
 
 	umap1 = isl_union_map_align_params(umap1, isl_union_map_get_space(umap2));
 	umap2 = isl_union_map_align_params(umap2, isl_union_map_get_space(umap1));
@@ -624,19 +770,19 @@ static __isl_give isl_union_map *gen_bin_op(__isl_take isl_union_map *umap1,
 		goto error;
 
 	data.umap2 = umap2;
-	data.res = isl_union_map_alloc(isl_space_copy(umap1->dim),
-				       umap1->table.n);
-	if (isl_hash_table_foreach(umap1->dim->ctx, &umap1->table,
-				   fn, &data) < 0)
+	if (collect_init(&data.collect, umap1, 1) < 0)
 		goto error;
+	if (collect_foreach(&data.collect, fn, &data) < 0) {
+		collect_free(&data.collect);
+		isl_union_map_free(umap2);
+		return NULL;
+	}
 
-	isl_union_map_free(umap1);
 	isl_union_map_free(umap2);
-	return data.res;
+	return collect_finish(&data.collect);
 error:
 	isl_union_map_free(umap1);
 	isl_union_map_free(umap2);
-	isl_union_map_free(data.res);
 	return NULL;
 }
 
@@ -654,16 +800,16 @@ __isl_give isl_union_set *isl_union_set_subtract(
 
 struct isl_union_map_gen_bin_set_data {
 	isl_set *set;
-	isl_union_map *res;
+	struct isl_union_map_collect collect;
 };
 
 static int intersect_params_entry(void **entry, void *user)
 {
 	struct isl_union_map_gen_bin_set_data *data = user;
-	isl_map *map = *entry;
+	isl_map *map;
 	int empty;
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = isl_map_intersect_params(map, isl_set_copy(data->set));
 
 	empty = isl_map_is_empty(map);
@@ -672,15 +818,17 @@ static int intersect_params_entry(void **entry, void *user)
 		return -1;
 	}
 
-	data->res = isl_union_map_add_map(data->res, map);
-
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
+/* Apply "fn" to each map in "umap" and collect the results.
+ * "fn" does not change the spaces of the maps, so if "umap"
+ * is not shared, then the results are stored in "umap" itself.
+ */
 static __isl_give isl_union_map *gen_bin_set_op(__isl_take isl_union_map *umap,
 	__isl_take isl_set *set, int (*fn)(void **, void *))
 {
-	struct isl_union_map_gen_bin_set_data data = { NULL, NULL };
+	struct isl_union_map_gen_bin_set_data data;
 
 	umap = isl_union_map_align_params(umap, isl_set_get_space(set));
 	set = isl_set_align_params(set, isl_union_map_get_space(umap));
@@ -689,19 +837,19 @@ static __isl_give isl_union_map *gen_bin_set_op(__isl_take isl_union_map *umap,
 		goto error;
 
 	data.set = set;
-	data.res = isl_union_map_alloc(isl_space_copy(umap->dim),
-				       umap->table.n);
-	if (isl_hash_table_foreach(umap->dim->ctx, &umap->table,
-				   fn, &data) < 0)
+	if (collect_init(&data.collect, umap, 1) < 0)
 		goto error;
+	if (collect_foreach(&data.collect, fn, &data) < 0) {
+		collect_free(&data.collect);
+		isl_set_free(set);
+		return NULL;
+	}
 
-	isl_union_map_free(umap);
 	isl_set_free(set);
-	return data.res;
+	return collect_finish(&data.collect);
 error:
 	isl_union_map_free(umap);
 	isl_set_free(set);
-	isl_union_map_free(data.res);
 	return NULL;
 }
 
@@ -750,7 +898,7 @@ static __isl_give isl_union_map *union_map_gist_params(
 
 struct isl_union_map_match_bin_data {
 	isl_union_map *umap2;
-	isl_union_map *res;
+	struct isl_union_map_collect collect;
 	__isl_give isl_map *(*fn)(__isl_take isl_map*, __isl_take isl_map*);
 };
 
@@ -766,9 +914,9 @@ static int match_bin_entry(void **entry, void *user)
 	entry2 = isl_hash_table_find(data->umap2->dim->ctx, &data->umap2->table,
 				     hash, &has_dim, map->dim, 0);
 	if (!entry2)
-		return 0;
+		return collect_drop(&data->collect, entry, NULL);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = data->fn(map, isl_map_copy(entry2->data));
 
 	empty = isl_map_is_empty(map);
@@ -776,21 +924,24 @@ static int match_bin_entry(void **entry, void *user)
 		isl_map_free(map);
 		return -1;
 	}
-	if (empty) {
-		isl_map_free(map);
-		return 0;
-	}
+	if (empty)
+		return collect_drop(&data->collect, entry, map);
 
-	data->res = isl_union_map_add_map(data->res, map);
-
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
+/* For each pair of maps in "umap1" and "umap2" living in the same space,
+ * call "fn" and collect the results.
+ * If "same_space" is set, then "fn" does not change the space
+ * of the map and the results can be stored in "umap1" itself
+ * if "umap1" is not shared.
+ */
 static __isl_give isl_union_map *match_bin_op(__isl_take isl_union_map *umap1,
 	__isl_take isl_union_map *umap2,
-	__isl_give isl_map *(*fn)(__isl_take isl_map*, __isl_take isl_map*))
+	__isl_give isl_map *(*fn)(__isl_take isl_map*, __isl_take isl_map*),
+	int same_space)
 {
-	struct isl_union_map_match_bin_data data = { NULL, NULL, fn };
+	struct isl_union_map_match_bin_data data;
 
 	umap1 = isl_union_map_align_params(umap1, isl_union_map_get_space(umap2));
 	umap2 = isl_union_map_align_params(umap2, isl_union_map_get_space(umap1));
@@ -799,26 +950,27 @@ static __isl_give isl_union_map *match_bin_op(__isl_take isl_union_map *umap1,
 		goto error;
 
 	data.umap2 = umap2;
-	data.res = isl_union_map_alloc(isl_space_copy(umap1->dim),
-				       umap1->table.n);
-	if (isl_hash_table_foreach(umap1->dim->ctx, &umap1->table,
-				   &match_bin_entry, &data) < 0)
+	data.fn = fn;
+	if (collect_init(&data.collect, umap1, same_space) < 0)
 		goto error;
+	if (collect_foreach(&data.collect, &match_bin_entry, &data) < 0) {
+		collect_free(&data.collect);
+		isl_union_map_free(umap2);
+		return NULL;
+	}
 
-	isl_union_map_free(umap1);
 	isl_union_map_free(umap2);
-	return data.res;
+	return collect_finish(&data.collect);
 error:
 	isl_union_map_free(umap1);
 	isl_union_map_free(umap2);
-	isl_union_map_free(data.res);
 	return NULL;
 }
 
 __isl_give isl_union_map *isl_union_map_intersect(
 	__isl_take isl_union_map *umap1, __isl_take isl_union_map *umap2)
 {
-	return match_bin_op(umap1, umap2, &isl_map_intersect);
+	return match_bin_op(umap1, umap2, &isl_map_intersect, 1);
 }
 
 /* Compute the intersection of the two union_sets.
@@ -849,10 +1001,10 @@ error:
 static int gist_params_entry(void **entry, void *user)
 {
 	struct isl_union_map_gen_bin_set_data *data = user;
-	isl_map *map = *entry;
+	isl_map *map;
 	int empty;
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = isl_map_gist_params(map, isl_set_copy(data->set));
 
 	empty = isl_map_is_empty(map);
@@ -861,9 +1013,7 @@ static int gist_params_entry(void **entry, void *user)
 		return -1;
 	}
 
-	data->res = isl_union_map_add_map(data->res, map);
-
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 __isl_give isl_union_map *isl_union_map_gist_params(
@@ -881,7 +1031,7 @@ __isl_give isl_union_set *isl_union_set_gist_params(
 __isl_give isl_union_map *isl_union_map_gist(__isl_take isl_union_map *umap,
 	__isl_take isl_union_map *context)
 {
-	return match_bin_op(umap, context, &isl_map_gist);
+	return match_bin_op(umap, context, &isl_map_gist, 1);
 }
 
 __isl_give isl_union_set *isl_union_set_gist(__isl_take isl_union_set *uset,
@@ -907,13 +1057,13 @@ static __isl_give isl_map *lex_lt_set(__isl_take isl_map *set1,
 __isl_give isl_union_map *isl_union_set_lex_lt_union_set(
 	__isl_take isl_union_set *uset1, __isl_take isl_union_set *uset2)
 {
-	return match_bin_op(uset1, uset2, &lex_lt_set);
+	return match_bin_op(uset1, uset2, &lex_lt_set, 0);
 }
 
 __isl_give isl_union_map *isl_union_set_lex_le_union_set(
 	__isl_take isl_union_set *uset1, __isl_take isl_union_set *uset2)
 {
-	return match_bin_op(uset1, uset2, &lex_le_set);
+	return match_bin_op(uset1, uset2, &lex_le_set, 0);
 }
 
 __isl_give isl_union_map *isl_union_set_lex_gt_union_set(
@@ -956,9 +1106,9 @@ static int intersect_domain_entry(void **entry, void *user)
 				     hash, &has_dim, dim, 0);
 	isl_space_free(dim);
 	if (!entry2)
-		return 0;
+		return collect_drop(&data->collect, entry, NULL);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = isl_map_intersect_domain(map, isl_set_copy(entry2->data));
 
 	empty = isl_map_is_empty(map);
@@ -966,14 +1116,10 @@ static int intersect_domain_entry(void **entry, void *user)
 		isl_map_free(map);
 		return -1;
 	}
-	if (empty) {
-		isl_map_free(map);
-		return 0;
-	}
-
-	data->res = isl_union_map_add_map(data->res, map);
+	if (empty)
+		return collect_drop(&data->collect, entry, map);
 
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 /* Intersect the domain of "umap" with "uset".
@@ -989,7 +1135,7 @@ __isl_give isl_union_map *isl_union_map_intersect_domain(
 }
 
 /* Remove the elements of data->umap2 from the domain of *entry
- * and add the result to data->res.
+ * and collect the result.
  */
 static int subtract_domain_entry(void **entry, void *user)
 {
@@ -1007,12 +1153,10 @@ static int subtract_domain_entry(void **entry, void *user)
 				     hash, &has_dim, dim, 0);
 	isl_space_free(dim);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 
-	if (!entry2) {
-		data->res = isl_union_map_add_map(data->res, map);
-		return 0;
-	}
+	if (!entry2)
+		return collect_add(&data->collect, entry, map);
 
 	map = isl_map_subtract_domain(map, isl_set_copy(entry2->data));
 
@@ -1021,14 +1165,10 @@ static int subtract_domain_entry(void **entry, void *user)
 		isl_map_free(map);
 		return -1;
 	}
-	if (empty) {
-		isl_map_free(map);
-		return 0;
-	}
-
-	data->res = isl_union_map_add_map(data->res, map);
+	if (empty)
+		return collect_drop(&data->collect, entry, map);
 
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 /* Remove the elements of "uset" from the domain of "umap".
@@ -1040,7 +1180,7 @@ __isl_give isl_union_map *isl_union_map_subtract_domain(
 }
 
 /* Remove the elements of data->umap2 from the range of *entry
- * and add the result to data->res.
+ * and collect the result.
  */
 static int subtract_range_entry(void **entry, void *user)
 {
@@ -1058,12 +1198,10 @@ static int subtract_range_entry(void **entry, void *user)
 				     hash, &has_dim, space, 0);
 	isl_space_free(space);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 
-	if (!entry2) {
-		data->res = isl_union_map_add_map(data->res, map);
-		return 0;
-	}
+	if (!entry2)
+		return collect_add(&data->collect, entry, map);
 
 	map = isl_map_subtract_range(map, isl_set_copy(entry2->data));
 
@@ -1072,14 +1210,10 @@ static int subtract_range_entry(void **entry, void *user)
 		isl_map_free(map);
 		return -1;
 	}
-	if (empty) {
-		isl_map_free(map);
-		return 0;
-	}
+	if (empty)
+		return collect_drop(&data->collect, entry, map);
 
-	data->res = isl_union_map_add_map(data->res, map);
-
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 /* Remove the elements of "uset" from the range of "umap".
@@ -1106,9 +1240,9 @@ static int gist_domain_entry(void **entry, void *user)
 				     hash, &has_dim, dim, 0);
 	isl_space_free(dim);
 	if (!entry2)
-		return 0;
+		return collect_drop(&data->collect, entry, NULL);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = isl_map_gist_domain(map, isl_set_copy(entry2->data));
 
 	empty = isl_map_is_empty(map);
@@ -1117,9 +1251,7 @@ static int gist_domain_entry(void **entry, void *user)
 		return -1;
 	}
 
-	data->res = isl_union_map_add_map(data->res, map);
-
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 /* Compute the gist of "umap" with respect to the domain "uset".
@@ -1150,9 +1282,9 @@ static int gist_range_entry(void **entry, void *user)
 				     hash, &has_dim, space, 0);
 	isl_space_free(space);
 	if (!entry2)
-		return 0;
+		return collect_drop(&data->collect, entry, NULL);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = isl_map_gist_range(map, isl_set_copy(entry2->data));
 
 	empty = isl_map_is_empty(map);
@@ -1161,9 +1293,7 @@ static int gist_range_entry(void **entry, void *user)
 		return -1;
 	}
 
-	data->res = isl_union_map_add_map(data->res, map);
-
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 /* Compute the gist of "umap" with respect to the range "uset".
@@ -1190,9 +1320,9 @@ static int intersect_range_entry(void **entry, void *user)
 				     hash, &has_dim, dim, 0);
 	isl_space_free(dim);
 	if (!entry2)
-		return 0;
+		return collect_drop(&data->collect, entry, NULL);
 
-	map = isl_map_copy(map);
+	map = collect_take(&data->collect, entry);
 	map = isl_map_intersect_range(map, isl_set_copy(entry2->data));
 
 	empty = isl_map_is_empty(map);
@@ -1200,14 +1330,10 @@ static int intersect_range_entry(void **entry, void *user)
 		isl_map_free(map);
 		return -1;
 	}
-	if (empty) {
-		isl_map_free(map);
-		return 0;
-	}
-
-	data->res = isl_union_map_add_map(data->res, map);
+	if (empty)
+		return collect_drop(&data->collect, entry, map);
 
-	return 0;
+	return collect_add(&data->collect, entry, map);
 }
 
 __isl_give isl_union_map *isl_union_map_intersect_range(
@@ -1619,14 +1745,30 @@ __isl_give isl_union_set *isl_union_set_simple_hull(
 	return isl_union_map_simple_hull(uset);
 }
 
+/* Internal data structure for inplace.
+ *
+ * "fn" is the function that is applied to each map.
+ * "take" is set if the caller holds the only reference
+ * to the union map, in which case the maps can be passed to "fn"
+ * without first taking a copy.
+ */
+struct isl_union_map_inplace_data {
+	__isl_give isl_map *(*fn)(__isl_take isl_map *);
+	int take;
+};
+
 static int inplace_entry(void **entry, void *user)
 {
-	__isl_give isl_map *(*fn)(__isl_take isl_map *);
+	struct isl_union_map_inplace_data *data = user;
 	isl_map **map = (isl_map **)entry;
 	isl_map *copy;
 
-	fn = *(__isl_give isl_map *(**)(__isl_take isl_map *)) user;
-	copy = fn(isl_map_copy(*map));
+	if (data->take) {
+		*map = data->fn(*map);
+		return *map ? 0 : -1;
+	}
+
+	copy = data->fn(isl_map_copy(*map));
 	if (!copy)
 		return -1;
 
@@ -1636,14 +1778,24 @@ static int inplace_entry(void **entry, void *user)
 	return 0;
 }
 
+/* Apply "fn" to each map in "umap", replacing the map
+ * in the hash table by the result.
+ * "fn" does not change the meaning or the space of the map,
+ * so this can be done even if "umap" is shared.
+ * However, if "umap" is shared, then the map needs to be copied
+ * first, since "fn" may fail.
+ */
 static __isl_give isl_union_map *inplace(__isl_take isl_union_map *umap,
 	__isl_give isl_map *(*fn)(__isl_take isl_map *))
 {
+	struct isl_union_map_inplace_data data = { fn };
+
 	if (!umap)
 		return NULL;
 
+	data.take = umap->ref == 1;
 	if (isl_hash_table_foreach(umap->dim->ctx, &umap->table,
-				    &inplace_entry, &fn) < 0)
+				    &inplace_entry, &data) < 0)
 		goto error;
 
 	return umap;
@@ -2194,42 +2346,140 @@ __isl_give isl_union_set *isl_union_map_wrap(__isl_take isl_union_map *umap)
 	return cond_un_op(umap, &wrap_entry);
 }
 
-struct isl_union_map_is_subset_data {
-	isl_union_map *umap2;
-	int is_subset;
+/* A map in a union map, along with its total number of constraints,
+ * which is used as an estimate of the cost of a test on the map.
+ */
+struct isl_union_map_cost {
+	isl_map *map;
+	int n_constraint;
 };
 
-static int is_subset_entry(void **entry, void *user)
+static int collect_map_entry(void **entry, void *user)
 {
-	struct isl_union_map_is_subset_data *data = user;
-	uint32_t hash;
-	struct isl_hash_table_entry *entry2;
+	struct isl_union_map_cost **next = user;
 	isl_map *map = *entry;
 
-	hash = isl_space_get_hash(map->dim);
-	entry2 = isl_hash_table_find(data->umap2->dim->ctx, &data->umap2->table,
-				     hash, &has_dim, map->dim, 0);
-	if (!entry2) {
-		int empty = isl_map_is_empty(map);
-		if (empty < 0)
-			return -1;
-		if (empty)
-			return 0;
-		data->is_subset = 0;
+	(*next)->map = map;
+	(*next)->n_constraint = isl_map_n_constraint_total(map);
+	(*next)++;
+
+	return 0;
+}
+
+/* Compare the maps pointed to by "a" and "b" based on their
+ * total number of constraints.
+ */
+static int cmp_map_cost(const void *a, const void *b, void *user)
+{
+	const struct isl_union_map_cost *cost1 = a;
+	const struct isl_union_map_cost *cost2 = b;
+
+	return cost1->n_constraint - cost2->n_constraint;
+}
+
+/* Store the maps in "umap" in "maps", ordered by increasing
+ * total number of constraints.
+ * "maps" is assumed to have room for all the maps in "umap".
+ * The maps are not copied, so "maps" is only valid for as long
+ * as "umap" is not modified.
+ * In the common case of at most two maps, there is no need
+ * to call isl_sort.
+ */
+static int union_map_cheapest_first(__isl_keep isl_union_map *umap,
+	struct isl_union_map_cost *maps)
+{
+	struct isl_union_map_cost *next = maps;
+
+	if (isl_hash_table_foreach(umap->dim->ctx, &umap->table,
+				   &collect_map_entry, &next) < 0)
 		return -1;
+	if (umap->table.n > 2)
+		return isl_sort(maps, umap->table.n, sizeof(*maps),
+				&cmp_map_cost, NULL);
+	if (umap->table.n == 2 &&
+	    maps[1].n_constraint < maps[0].n_constraint) {
+		struct isl_union_map_cost t = maps[0];
+		maps[0] = maps[1];
+		maps[1] = t;
 	}
+	return 0;
+}
 
-	data->is_subset = isl_map_is_subset(map, entry2->data);
-	if (data->is_subset < 0 || !data->is_subset)
+/* Check if fn(map, user) returns true for all maps "map" in umap.
+ *
+ * The maps are considered in order of increasing number of constraints
+ * such that the cheapest tests are performed before
+ * we can conclude that the result is false.
+ * The array of maps is only allocated if there are more than two maps.
+ */
+static int union_map_forall_user(__isl_keep isl_union_map *umap,
+	int (*fn)(__isl_keep isl_map *map, void *user), void *user)
+{
+	int i;
+	int res = 1;
+	struct isl_union_map_cost local[2];
+	struct isl_union_map_cost *maps = local;
+
+	if (!umap)
 		return -1;
+	if (umap->table.n == 0)
+		return 1;
 
-	return 0;
+	if (umap->table.n > 2) {
+		maps = isl_alloc_array(umap->dim->ctx,
+				struct isl_union_map_cost, umap->table.n);
+		if (!maps)
+			return -1;
+	}
+	if (union_map_cheapest_first(umap, maps) < 0)
+		res = -1;
+	for (i = 0; res > 0 && i < umap->table.n; ++i)
+		res = fn(maps[i].map, user);
+	if (maps != local)
+		free(maps);
+
+	return res;
+}
+
+static int forall_entry(__isl_keep isl_map *map, void *user)
+{
+	int (**fn)(__isl_keep isl_map *map) = user;
+
+	return (*fn)(map);
+}
+
+/* Check if fn(map) returns true for all maps "map" in umap.
+ *
+ * As in union_map_forall_user, the cheapest maps are considered first.
+ */
+static int union_map_forall(__isl_keep isl_union_map *umap,
+	int (*fn)(__isl_keep isl_map *map))
+{
+	return union_map_forall_user(umap, &forall_entry, &fn);
+}
+
+/* Is "map" a subset of the map in the same space in "umap2"
+ * (or empty, if "umap2" has no map in that space)?
+ */
+static int is_subset_entry(__isl_keep isl_map *map, void *user)
+{
+	isl_union_map *umap2 = user;
+	uint32_t hash;
+	struct isl_hash_table_entry *entry2;
+
+	hash = isl_space_get_hash(map->dim);
+	entry2 = isl_hash_table_find(umap2->dim->ctx, &umap2->table,
+				     hash, &has_dim, map->dim, 0);
+	if (!entry2)
+		return isl_map_is_empty(map);
+
+	return isl_map_is_subset(map, entry2->data);
 }
 
 int isl_union_map_is_subset(__isl_keep isl_union_map *umap1,
 	__isl_keep isl_union_map *umap2)
 {
-	struct isl_union_map_is_subset_data data = { NULL, 1 };
+	int is_subset;
 
 	umap1 = isl_union_map_copy(umap1);
 	umap2 = isl_union_map_copy(umap2);
@@ -2237,22 +2487,15 @@ int isl_union_map_is_subset(__isl_keep isl_union_map *umap1,
 	umap2 = isl_union_map_align_params(umap2, isl_union_map_get_space(umap1));
 
 	if (!umap1 || !umap2)
-		goto error;
-
-	data.umap2 = umap2;
-	if (isl_hash_table_foreach(umap1->dim->ctx, &umap1->table,
-				   &is_subset_entry, &data) < 0 &&
-	    data.is_subset)
-		goto error;
+		is_subset = -1;
+	else
+		is_subset = union_map_forall_user(umap1, &is_subset_entry,
+						  umap2);
 
 	isl_union_map_free(umap1);
 	isl_union_map_free(umap2);
 
-	return data.is_subset;
-error:
-	isl_union_map_free(umap1);
-	isl_union_map_free(umap2);
-	return -1;
+	return is_subset;
 }
 
 int isl_union_set_is_subset(__isl_keep isl_union_set *uset1,
@@ -2418,79 +2661,6 @@ __isl_give isl_basic_set *isl_union_set_sample(__isl_take isl_union_set *uset)
 	return (isl_basic_set *)isl_union_map_sample(uset);
 }
 
-struct isl_forall_data {
-	int res;
-	int (*fn)(__isl_keep isl_map *map);
-};
-
-static int forall_entry(void **entry, void *user)
-{
-	struct isl_forall_data *data = user;
-	isl_map *map = *entry;
-
-	data->res = data->fn(map);
-	if (data->res < 0)
-		return -1;
-
-	if (!data->res)
-		return -1;
-
-	return 0;
-}
-
-static int union_map_forall(__isl_keep isl_union_map *umap,
-	int (*fn)(__isl_keep isl_map *map))
-{
-	struct isl_forall_data data = { 1, fn };
-
-	if (!umap)
-		return -1;
-
-	if (isl_hash_table_foreach(umap->dim->ctx, &umap->table,
-				   &forall_entry, &data) < 0 && data.res)
-		return -1;
-
-	return data.res;
-}
-
-struct isl_forall_user_data {
-	int res;
-	int (*fn)(__isl_keep isl_map *map, void *user);
-	void *user;
-};
-
-static int forall_user_entry(void **entry, void *user)
-{
-	struct isl_forall_user_data *data = user;
-	isl_map *map = *entry;
-
-	data->res = data->fn(map, data->user);
-	if (data->res < 0)
-		return -1;
-
-	if (!data->res)
-		return -1;
-
-	return 0;
-}
-
-/* Check if fn(map, user) returns true for all maps "map" in umap.
- */
-static int union_map_forall_user(__isl_keep isl_union_map *umap,
-	int (*fn)(__isl_keep isl_map *map, void *user), void *user)
-{
-	struct isl_forall_user_data data = { 1, fn, user };
-
-	if (!umap)
-		return -1;
-
-	if (isl_hash_table_foreach(umap->dim->ctx, &umap->table,
-				   &forall_user_entry, &data) < 0 && data.res)
-		return -1;
-
-	return data.res;
-}
-
 int isl_union_map_is_empty(__isl_keep isl_union_map *umap)
 {
 	return union_map_forall(umap, &isl_map_is_empty);
@@ -377,6 +377,28 @@ __isl_null UNION *FN(UNION,free)(__isl_take UNION *u)
 	return NULL;
 }
 
+static int FN(UNION,compact_entry)(void **entry, void *user)
+{
+	*entry = FN(PART,compact)(*entry);
+
+	return 0;
+}
+
+/* Compact each of the parts of "u".
+ * Since this does not change the meaning of "u",
+ * the parts are modified in place, even if "u" is shared.
+ */
+__isl_give UNION *FN(UNION,compact)(__isl_take UNION *u)
+{
+	if (!u)
+		return NULL;
+
+	isl_hash_table_foreach(u->space->ctx, &u->table,
+				&FN(UNION,compact_entry), NULL);
+
+	return u;
+}
+
 S(UNION,align) {
 	isl_reordering *exp;
 	UNION *res;
@@ -516,15 +538,137 @@ __isl_give UNION *FN(FN(UNION,from),PARTS)(__isl_take PART *part)
 	return u;
 }
 
+/* Internal data structure for collecting the results of an operation
+ * on the parts of "u" that does not change the spaces of the parts.
+ *
+ * If "inplace" is set, then the caller holds the only reference
+ * to "u" and the results replace the original parts
+ * in the hash table of "u".
+ * Otherwise, the results are collected in "res".
+ */
+S(UNION,collect) {
+	UNION *u;
+	int inplace;
+	UNION *res;
+};
+
+/* Prepare "collect" for collecting the results of an operation
+ * on the parts of "u".
+ */
+static int FN(UNION,collect_init)(S(UNION,collect) *collect,
+	__isl_keep UNION *u)
+{
+	collect->u = u;
+	collect->inplace = u->ref == 1;
+	collect->res = NULL;
+	if (collect->inplace)
+		return 0;
+#ifdef HAS_TYPE
+	collect->res = FN(UNION,alloc)(isl_space_copy(u->space), u->type,
+					u->table.n);
+#else
+	collect->res = FN(UNION,alloc)(isl_space_copy(u->space), u->table.n);
+#endif
+	return collect->res ? 0 : -1;
+}
+
+/* Call "fn" on each part of collect->u.
+ * If the results are collected in place, then "fn" returns 1
+ * for the parts that should be removed from the hash table.
+ */
+static int FN(UNION,collect_foreach)(S(UNION,collect) *collect,
+	int (*fn)(void **entry, void *user), void *user)
+{
+	UNION *u = collect->u;
+
+	if (collect->inplace)
+		return isl_hash_table_foreach_remove(u->space->ctx, &u->table,
+							fn, user);
+	return isl_hash_table_foreach(u->space->ctx, &u->table, fn, user);
+}
+
+/* Return the part in "entry" for use as input to the operation.
+ * If the results are collected in place, then the part is taken
+ * out of the hash table, to avoid copying it in the operation.
+ * It is put back by FN(UNION,collect_add).
+ */
+static __isl_give PART *FN(UNION,collect_take)(S(UNION,collect) *collect,
+	void **entry)
+{
+	PART *part = *entry;
+
+	if (!collect->inplace)
+		return FN(PART,copy)(part);
+	*entry = NULL;
+	return part;
+}
+
+/* Drop the part in "entry" from the result of the operation.
+ */
+static int FN(UNION,collect_drop)(S(UNION,collect) *collect, void **entry,
+	__isl_take PART *part)
+{
+	FN(PART,free)(part);
+	if (!collect->inplace)
+		return 0;
+	FN(PART,free)(*entry);
+	*entry = NULL;
+	return 1;
+}
+
+/* Add "part", the result of the operation on the part in "entry",
+ * to the result.
+ * Parts that are identically zero are not stored,
+ * as in FN(FN(UNION,add),PARTS).
+ */
+static int FN(UNION,collect_add)(S(UNION,collect) *collect, void **entry,
+	__isl_take PART *part)
+{
+	int zero;
+
+	if (!collect->inplace) {
+		collect->res = FN(FN(UNION,add),PARTS)(collect->res, part);
+		return collect->res ? 0 : -1;
+	}
+	zero = FN(PART,IS_ZERO)(part);
+	if (zero < 0) {
+		FN(PART,free)(part);
+		return -1;
+	}
+	if (zero)
+		return FN(UNION,collect_drop)(collect, entry, part);
+	*entry = part;
+	return 0;
+}
+
+/* Return the result of the operation, consuming collect->u.
+ */
+static __isl_give UNION *FN(UNION,collect_finish)(S(UNION,collect) *collect)
+{
+	if (collect->inplace)
+		return collect->u;
+	FN(UNION,free)(collect->u);
+	return collect->res;
+}
+
+/* Free the partial result of an operation that has failed,
+ * along with collect->u.
+ */
+static void FN(UNION,collect_free)(S(UNION,collect) *collect)
+{
+	FN(UNION,free)(collect->u);
+	FN(UNION,free)(collect->res);
+}
+
 S(UNION,match_bin_data) {
 	UNION *u2;
-	UNION *res;
+	S(UNION,collect) collect;
 	__isl_give PART *(*fn)(__isl_take PART *, __isl_take PART *);
 };
 
 /* Check if data->u2 has an element living in the same space as *entry.
- * If so, call data->fn on the two elements and add the result to
- * data->res.
+ * If so, call data->fn on the two elements and collect the result.
+ * Otherwise, drop *entry from the result.
  */
 static int FN(UNION,match_bin_entry)(void **entry, void *user)
 {
@@ -542,7 +686,7 @@ static int FN(UNION,match_bin_entry)(void **entry, void *user)
 				     space, 0);
 	isl_space_free(space);
 	if (!entry2)
-		return 0;
+		return FN(UNION,collect_drop)(&data->collect, entry, NULL);
 
 	part2 = entry2->data;
 	if (!isl_space_tuple_is_equal(part->dim, isl_dim_out,
@@ -551,14 +695,10 @@ static int FN(UNION,match_bin_entry)(void **entry, void *user)
 			"entries should have the same range space",
 			return -1);
 
-	part = FN(PART, copy)(part);
+	part = FN(UNION,collect_take)(&data->collect, entry);
 	part = data->fn(part, FN(PART, copy)(entry2->data));
 
-	data->res = FN(FN(UNION,add),PARTS)(data->res, part);
-	if (!data->res)
-		return -1;
-
-	return 0;
+	return FN(UNION,collect_add)(&data->collect, entry, part);
 }
 
 /* This function is currently only used from isl_polynomial.c
@@ -570,12 +710,14 @@ static __isl_give UNION *FN(UNION,match_bin_op)(__isl_take UNION *u1,
 	__attribute__ ((unused));
 /* For each pair of elements in "u1" and "u2" living in the same space,
  * call "fn" and collect the results.
+ * "fn" does not change the space of the elements, so if "u1"
+ * is not shared, then the results are stored in "u1" itself.
  */
 static __isl_give UNION *FN(UNION,match_bin_op)(__isl_take UNION *u1,
 	__isl_take UNION *u2,
 	__isl_give PART *(*fn)(__isl_take PART *, __isl_take PART *))
 {
-	S(UNION,match_bin_data) data = { NULL, NULL, fn };
+	S(UNION,match_bin_data) data;
 
 	u1 = FN(UNION,align_params)(u1, FN(UNION,get_space)(u2));
 	u2 = FN(UNION,align_params)(u2, FN(UNION,get_space)(u1));
@@ -584,23 +726,21 @@ static __isl_give UNION *FN(UNION,match_bin_op)(__isl_take UNION *u1,
 		goto error;
 
 	data.u2 = u2;
-#ifdef HAS_TYPE
-	data.res = FN(UNION,alloc)(isl_space_copy(u1->space), u1->type,
-				    u1->table.n);
-#else
-	data.res = FN(UNION,alloc)(isl_space_copy(u1->space), u1->table.n);
-#endif
-	if (isl_hash_table_foreach(u1->space->ctx, &u1->table,
-				    &FN(UNION,match_bin_entry), &data) < 0)
+	data.fn = fn;
+	if (FN(UNION,collect_init)(&data.collect, u1) < 0)
 		goto error;
+	if (FN(UNION,collect_foreach)(&data.collect,
+				    &FN(UNION,match_bin_entry), &data) < 0) {
+		FN(UNION,collect_free)(&data.collect);
+		FN(UNION,free)(u2);
+		return NULL;
+	}
 
-	FN(UNION,free)(u1);
 	FN(UNION,free)(u2);
-	return data.res;
+	return FN(UNION,collect_finish)(&data.collect);
 error:
 	FN(UNION,free)(u1);
 	FN(UNION,free)(u2);
-	FN(UNION,free)(data.res);
 	return NULL;
 }
 
@@ -630,32 +770,29 @@ __isl_give UNION *FN(UNION,sub)(__isl_take UNION *u1, __isl_take UNION *u2)
 
 S(UNION,any_set_data) {
 	isl_set *set;
-	UNION *res;
+	S(UNION,collect) collect;
 	__isl_give PW *(*fn)(__isl_take PW*, __isl_take isl_set*);
 };
 
 static int FN(UNION,any_set_entry)(void **entry, void *user)
 {
 	S(UNION,any_set_data) *data = user;
-	PW *pw = *entry;
+	PW *pw;
 
-	pw = FN(PW,copy)(pw);
+	pw = FN(UNION,collect_take)(&data->collect, entry);
 	pw = data->fn(pw, isl_set_copy(data->set));
 
-	data->res = FN(FN(UNION,add),PARTS)(data->res, pw);
-	if (!data->res)
-		return -1;
-
-	return 0;
+	return FN(UNION,collect_add)(&data->collect, entry, pw);
 }
 
 /* Update each element of "u" by calling "fn" on the element and "set".
+ * If "u" is not shared, then the elements are updated in place.
  */
 static __isl_give UNION *FN(UNION,any_set_op)(__isl_take UNION *u,
 	__isl_take isl_set *set,
 	__isl_give PW *(*fn)(__isl_take PW*, __isl_take isl_set*))
 {
-	S(UNION,any_set_data) data = { NULL, NULL, fn };
+	S(UNION,any_set_data) data;
 
 	u = FN(UNION,align_params)(u, isl_set_get_space(set));
 	set = isl_set_align_params(set, FN(UNION,get_space)(u));
@@ -664,23 +801,21 @@ static __isl_give UNION *FN(UNION,any_set_op)(__isl_take UNION *u,
 		goto error;
 
 	data.set = set;
-#ifdef HAS_TYPE
-	data.res = FN(UNION,alloc)(isl_space_copy(u->space), u->type,
-					u->table.n);
-#else
-	data.res = FN(UNION,alloc)(isl_space_copy(u->space), u->table.n);
-#endif
-	if (isl_hash_table_foreach(u->space->ctx, &u->table,
-				   &FN(UNION,any_set_entry), &data) < 0)
+	data.fn = fn;
+	if (FN(UNION,collect_init)(&data.collect, u) < 0)
 		goto error;
+	if (FN(UNION,collect_foreach)(&data.collect,
+				    &FN(UNION,any_set_entry), &data) < 0) {
+		FN(UNION,collect_free)(&data.collect);
+		isl_set_free(set);
+		return NULL;
+	}
 
-	FN(UNION,free)(u);
 	isl_set_free(set);
-	return data.res;
+	return FN(UNION,collect_finish)(&data.collect);
 error:
 	FN(UNION,free)(u);
 	isl_set_free(set);
-	FN(UNION,free)(data.res);
 	return NULL;
 }
 
@@ -703,7 +838,7 @@ __isl_give UNION *FN(UNION,gist_params)(__isl_take UNION *u,
 
 S(UNION,match_domain_data) {
 	isl_union_set *uset;
-	UNION *res;
+	S(UNION,collect) collect;
 	__isl_give PW *(*fn)(__isl_take PW*, __isl_take isl_set*);
 };
 
@@ -716,8 +851,8 @@ static int FN(UNION,set_has_dim)(const void *entry, const void *val)
 }
 
 /* Find the set in data->uset that lives in the same space as the domain
- * of *entry, apply data->fn to *entry and this set (if any), and add
- * the result to data->res.
+ * of *entry, apply data->fn to *entry and this set (if any), and collect
+ * the result.  If there is no such set, then *entry is dropped.
  */
 static int FN(UNION,match_domain_entry)(void **entry, void *user)
 {
@@ -733,27 +868,24 @@ static int FN(UNION,match_domain_entry)(void **entry, void *user)
 				     hash, &FN(UNION,set_has_dim), space, 0);
 	isl_space_free(space);
 	if (!entry2)
-		return 0;
+		return FN(UNION,collect_drop)(&data->collect, entry, NULL);
 
-	pw = FN(PW,copy)(pw);
+	pw = FN(UNION,collect_take)(&data->collect, entry);
 	pw = data->fn(pw, isl_set_copy(entry2->data));
 
-	data->res = FN(FN(UNION,add),PARTS)(data->res, pw);
-	if (!data->res)
-		return -1;
-
-	return 0;
+	return FN(UNION,collect_add)(&data->collect, entry, pw);
 }
 
 /* Apply fn to each pair of PW in u and set in uset such that
  * the set lives in the same space as the domain of PW
  * and collect the results.
+ * If "u" is not shared, then the results are stored in "u" itself.
  */
 static __isl_give UNION *FN(UNION,match_domain_op)(__isl_take UNION *u,
 	__isl_take isl_union_set *uset,
 	__isl_give PW *(*fn)(__isl_take PW*, __isl_take isl_set*))
 {
-	S(UNION,match_domain_data) data = { NULL, NULL, fn };
+	S(UNION,match_domain_data) data;
 
 	u = FN(UNION,align_params)(u, isl_union_set_get_space(uset));
 	uset = isl_union_set_align_params(uset, FN(UNION,get_space)(u));
@@ -762,23 +894,21 @@ static __isl_give UNION *FN(UNION,match_domain_op)(__isl_take UNION *u,
 		goto error;
 
 	data.uset = uset;
-#ifdef HAS_TYPE
-	data.res = FN(UNION,alloc)(isl_space_copy(u->space), u->type,
-					u->table.n);
-#else
-	data.res = FN(UNION,alloc)(isl_space_copy(u->space), u->table.n);
-#endif
-	if (isl_hash_table_foreach(u->space->ctx, &u->table,
-				   &FN(UNION,match_domain_entry), &data) < 0)
+	data.fn = fn;
+	if (FN(UNION,collect_init)(&data.collect, u) < 0)
 		goto error;
+	if (FN(UNION,collect_foreach)(&data.collect,
+				&FN(UNION,match_domain_entry), &data) < 0) {
+		FN(UNION,collect_free)(&data.collect);
+		isl_union_set_free(uset);
+		return NULL;
+	}
 
-	FN(UNION,free)(u);
 	isl_union_set_free(uset);
-	return data.res;
+	return FN(UNION,collect_finish)(&data.collect);
 error:
 	FN(UNION,free)(u);
 	isl_union_set_free(uset);
-	FN(UNION,free)(data.res);
 	return NULL;
 }
 
@@ -797,32 +927,34 @@ __isl_give UNION *FN(UNION,intersect_domain)(__isl_take UNION *u,
 
 /* Internal data structure for isl_union_*_subtract_domain.
  * uset is the set that needs to be removed from the domain.
- * res collects the results.
+ * collect collects the results.
  */
 S(UNION,subtract_domain_data) {
 	isl_union_set *uset;
-	UNION *res;
+	S(UNION,collect) collect;
 };
 
 /* Take the set (which may be empty) in data->uset that lives
- * in the same space as the domain of "pw", subtract it from the domain
- * of "pw" and add the result to data->res.
+ * in the same space as the domain of *entry, subtract it from the domain
+ * of *entry and collect the result.
  */
-static int FN(UNION,subtract_domain_entry)(__isl_take PW *pw, void *user)
+static int FN(UNION,subtract_domain_entry)(void **entry, void *user)
 {
 	S(UNION,subtract_domain_data) *data = user;
 	isl_space *space;
 	isl_set *set;
+	PW *pw = *entry;
 
 	space = FN(PW,get_domain_space)(pw);
 	set = isl_union_set_extract_set(data->uset, space);
+	pw = FN(UNION,collect_take)(&data->collect, entry);
 	pw = FN(PW,subtract_domain)(pw, set);
-	data->res = FN(FN(UNION,add),PARTS)(data->res, pw);
 
-	return 0;
+	return FN(UNION,collect_add)(&data->collect, entry, pw);
 }
 
 /* Subtract "uset' from the domain of "u".
+ * If "u" is not shared, then the elements are updated in place.
  */
 __isl_give UNION *FN(UNION,subtract_domain)(__isl_take UNION *u,
 	__isl_take isl_union_set *uset)
@@ -833,19 +965,17 @@ __isl_give UNION *FN(UNION,subtract_domain)(__isl_take UNION *u,
 		goto error;
 
 	data.uset = uset;
-#ifdef HAS_TYPE
-	data.res = FN(UNION,alloc)(isl_space_copy(u->space), u->type,
-					u->table.n);
-#else
-	data.res = FN(UNION,alloc)(isl_space_copy(u->space), u->table.n);
-#endif
-	if (FN(FN(UNION,foreach),PARTS)(u,
-				&FN(UNION,subtract_domain_entry), &data) < 0)
-		data.res = FN(UNION,free)(data.res);
+	if (FN(UNION,collect_init)(&data.collect, u) < 0)
+		goto error;
+	if (FN(UNION,collect_foreach)(&data.collect,
+			    &FN(UNION,subtract_domain_entry), &data) < 0) {
+		FN(UNION,collect_free)(&data.collect);
+		isl_union_set_free(uset);
+		return NULL;
+	}
 
-	FN(UNION,free)(u);
 	isl_union_set_free(uset);
-	return data.res;
+	return FN(UNION,collect_finish)(&data.collect);
 error:
 	FN(UNION,free)(u);
 	isl_union_set_free(uset);
@@ -20,17 +20,80 @@ isl_ctx *isl_vec_get_ctx(__isl_keep isl_vec *vec)
 	return vec ? vec->ctx : NULL;
 }
 
-struct isl_vec *isl_vec_alloc(struct isl_ctx *ctx, unsigned size)
+/* Does "vec" keep its elements in vec->inline_el?
+ */
+static int vec_is_inline(__isl_keep isl_vec *vec)
 {
-	struct isl_vec *vec;
+	return vec->block.data == vec->inline_el;
+}
+
+/* Return a vector with inline elements, either taken from the cache
+ * in "ctx" or newly allocated.
+ */
+static __isl_give isl_vec *vec_alloc_inline(isl_ctx *ctx)
+{
+	int i;
+	isl_vec *vec;
+
+	if (ctx->n_vec_cached > 0)
+		return ctx->vec_cache[--ctx->n_vec_cached];
 
 	vec = isl_alloc_type(ctx, struct isl_vec);
 	if (!vec)
 		return NULL;
+	for (i = 0; i < ISL_VEC_INLINE_SIZE; ++i)
+		isl_int_init(vec->inline_el[i]);
+	vec->block.size = ISL_VEC_INLINE_SIZE;
+	vec->block.data = vec->inline_el;
 
-	vec->block = isl_blk_alloc(ctx, size);
-	if (isl_blk_is_error(vec->block))
-		goto error;
+	return vec;
+}
+
+/* Clear the inline elements of "vec" and free it.
+ */
+static void vec_free_inline(__isl_take isl_vec *vec)
+{
+	int i;
+
+	for (i = 0; i < ISL_VEC_INLINE_SIZE; ++i)
+		isl_int_clear(vec->inline_el[i]);
+	free(vec);
+}
+
+/* Free all vectors in the cache of "ctx".
+ */
+void isl_vec_clear_cache(struct isl_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ctx->n_vec_cached; ++i)
+		vec_free_inline(ctx->vec_cache[i]);
+	ctx->n_vec_cached = 0;
+}
+
+/* Allocate a vector of size "size".
+ *
+ * Short vectors keep their elements inside the isl_vec structure itself
+ * such that only a single allocation is needed,
+ * or none at all if a vector can be reused from the cache.
+ */
+struct isl_vec *isl_vec_alloc(struct isl_ctx *ctx, unsigned size)
+{
+	struct isl_vec *vec;
+
+	if (size <= ISL_VEC_INLINE_SIZE) {
+		vec = vec_alloc_inline(ctx);
+		if (!vec)
+			return NULL;
+	} else {
+		vec = isl_alloc_type(ctx, struct isl_vec);
+		if (!vec)
+			return NULL;
+
+		vec->block = isl_blk_alloc(ctx, size);
+		if (isl_blk_is_error(vec->block))
+			goto error;
+	}
 
 	vec->ctx = ctx;
 	isl_ctx_ref(ctx);
@@ -41,9 +104,33 @@ struct isl_vec *isl_vec_alloc(struct isl_ctx *ctx, unsigned size)
 	return vec;
 error:
 	isl_blk_free(ctx, vec->block);
+	free(vec);
 	return NULL;
 }
 
+/* Move the elements of "vec", which are stored inline,
+ * to a separately allocated block of size "size".
+ * The inline elements are cleared such that "vec" is from then on
+ * treated as a regular vector.
+ */
+static __isl_give isl_vec *vec_move_out_of_line(__isl_take isl_vec *vec,
+	unsigned size)
+{
+	int i;
+	struct isl_blk block;
+
+	block = isl_blk_alloc(vec->ctx, size);
+	if (isl_blk_is_error(block))
+		return isl_vec_free(vec);
+	for (i = 0; i < vec->size; ++i)
+		isl_int_swap(block.data[i], vec->inline_el[i]);
+	for (i = 0; i < ISL_VEC_INLINE_SIZE; ++i)
+		isl_int_clear(vec->inline_el[i]);
+	vec->block = block;
+
+	return vec;
+}
+
 __isl_give isl_vec *isl_vec_extend(__isl_take isl_vec *vec, unsigned size)
 {
 	if (!vec)
@@ -55,9 +142,17 @@ __isl_give isl_vec *isl_vec_extend(__isl_take isl_vec *vec, unsigned size)
 	if (!vec)
 		return NULL;
 
-	vec->block = isl_blk_extend(vec->ctx, vec->block, size);
-	if (!vec->block.data)
-		goto error;
+	if (vec_is_inline(vec)) {
+		if (size > ISL_VEC_INLINE_SIZE) {
+			vec = vec_move_out_of_line(vec, size);
+			if (!vec)
+				return NULL;
+		}
+	} else {
+		vec->block = isl_blk_extend(vec->ctx, vec->block, size);
+		if (!vec->block.data)
+			goto error;
+	}
 
 	vec->size = size;
 	vec->el = vec->block.data;
@@ -169,8 +264,13 @@ __isl_null isl_vec *isl_vec_free(__isl_take isl_vec *vec)
 		return NULL;
 
 	isl_ctx_deref(vec->ctx);
-	isl_blk_free(vec->ctx, vec->block);
-	free(vec);
+	if (!vec_is_inline(vec)) {
+		isl_blk_free(vec->ctx, vec->block);
+		free(vec);
+	} else if (vec->ctx->n_vec_cached < ISL_VEC_CACHE_SIZE)
+		vec->ctx->vec_cache[vec->ctx->n_vec_cached++] = vec;
+	else
+		vec_free_inline(vec);
 
 	return NULL;
 }
@@ -4,6 +4,14 @@
 #include <isl_blk.h>
 #include <isl/vec.h>
 
+/* Vectors of at most ISL_VEC_INLINE_SIZE elements keep their elements
+ * in "inline_el", in which case block.data points to "inline_el".
+ * Freed vectors with inline elements are kept in a cache
+ * in the isl_ctx (with their elements still initialized)
+ * such that they can be reused without any further allocation.
+ */
+#define ISL_VEC_INLINE_SIZE	8
+
 struct isl_vec {
 	int ref;
 
@@ -13,9 +21,11 @@ struct isl_vec {
 	isl_int *el;
 
 	struct isl_blk block;
+	isl_int inline_el[ISL_VEC_INLINE_SIZE];
 };
 
 __isl_give isl_vec *isl_vec_cow(__isl_take isl_vec *vec);
+void isl_vec_clear_cache(struct isl_ctx *ctx);
 
 void isl_vec_lcm(struct isl_vec *vec, isl_int *lcm);
 int isl_vec_get_element(__isl_keep isl_vec *vec, int pos, isl_int *v);
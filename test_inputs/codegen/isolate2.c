@@ -0,0 +1,11 @@
+{
+  if (n <= 31)
+    for (int c1 = 0; c1 < n; c1 += 1)
+      A(c1);
+  for (int c0 = 0; c0 < n / 32; c0 += 1)
+    for (int c1 = 32 * c0; c1 <= 32 * c0 + 31; c1 += 1)
+      A(c1);
+  if (n >= 33 && (n - 1) % 32 <= 30)
+    for (int c1 = -((n - 1) % 32) + n - 1; c1 < n; c1 += 1)
+      A(c1);
+}